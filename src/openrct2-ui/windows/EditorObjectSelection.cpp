@@ -290,7 +290,7 @@ static void visible_list_refresh(rct_window* w)
     visible_list_dispose();
     w->selected_list_item = -1;
 
-    const ObjectRepositoryItem* items = object_repository_get_items();
+    const auto& items = object_repository_get_items();
     for (int32_t i = 0; i < numObjects; i++)
     {
         uint8_t selectionFlags = _objectSelectionFlags[i];
@@ -1295,7 +1295,7 @@ static void window_editor_object_selection_manage_tracks()
 static void editor_load_selected_objects()
 {
     int32_t numItems = static_cast<int32_t>(object_repository_get_items_count());
-    const ObjectRepositoryItem* items = object_repository_get_items();
+    const auto& items = object_repository_get_items();
     for (int32_t i = 0; i < numItems; i++)
     {
         if (_objectSelectionFlags[i] & OBJECT_SELECTION_FLAG_SELECTED)
@@ -1496,7 +1496,7 @@ static void filter_update_counts()
         std::fill(std::begin(_filter_object_counts), std::end(_filter_object_counts), 0);
 
         size_t numObjects = object_repository_get_items_count();
-        const ObjectRepositoryItem* items = object_repository_get_items();
+        const auto& items = object_repository_get_items();
         for (size_t i = 0; i < numObjects; i++)
         {
             const ObjectRepositoryItem* item = &items[i];
@@ -161,6 +161,7 @@ namespace OpenRCT2
             //       If objects use GetContext() in their destructor things won't go well.
 
             GameActions::ClearQueue();
+            game_autosave_wait();
             network_close();
             window_close_all();
 
@@ -950,7 +951,16 @@ namespace OpenRCT2
 
             if (_accumulator < GAME_UPDATE_TIME_MS)
             {
-                platform_sleep(GAME_UPDATE_TIME_MS - _accumulator - 1);
+                uint32_t sleepTime = GAME_UPDATE_TIME_MS - _accumulator - 1;
+                if (gOpenRCT2Headless && network_get_mode() == NETWORK_MODE_SERVER)
+                {
+                    // Wake up for client input instead of sleeping through it
+                    network_wait(sleepTime);
+                }
+                else
+                {
+                    platform_sleep(sleepTime);
+                }
                 return;
             }
 
@@ -221,6 +221,7 @@ namespace Editor
         {
             case FILE_EXTENSION_SC6:
             case FILE_EXTENSION_SV6:
+            case FILE_EXTENSION_PARK:
                 return ReadS6(path);
             case FILE_EXTENSION_SC4:
                 return LoadLandscapeFromSC4(path);
@@ -275,7 +276,7 @@ namespace Editor
         {
             load_from_sc6(path);
         }
-        else if (_stricmp(extension, ".sv6") == 0 || _stricmp(extension, ".sv7") == 0)
+        else if (_stricmp(extension, ".sv6") == 0 || _stricmp(extension, ".sv7") == 0 || _stricmp(extension, ".park") == 0)
         {
             load_from_sv6(path);
             loadedFromSave = true;
@@ -45,7 +45,7 @@ static void window_editor_object_selection_select_default_objects();
 static void setup_track_manager_objects()
 {
     int32_t numObjects = static_cast<int32_t>(object_repository_get_items_count());
-    const ObjectRepositoryItem* items = object_repository_get_items();
+    const auto& items = object_repository_get_items();
     for (int32_t i = 0; i < numObjects; i++)
     {
         uint8_t* selectionFlags = &_objectSelectionFlags[i];
@@ -74,7 +74,7 @@ static void setup_track_manager_objects()
 static void setup_track_designer_objects()
 {
     int32_t numObjects = static_cast<int32_t>(object_repository_get_items_count());
-    const ObjectRepositoryItem* items = object_repository_get_items();
+    const auto& items = object_repository_get_items();
     for (int32_t i = 0; i < numObjects; i++)
     {
         uint8_t* selectionFlags = &_objectSelectionFlags[i];
@@ -197,7 +197,7 @@ void setup_in_use_selection_flags()
     }
 
     int32_t numObjects = static_cast<int32_t>(object_repository_get_items_count());
-    const ObjectRepositoryItem* items = object_repository_get_items();
+    const auto& items = object_repository_get_items();
     for (int32_t i = 0; i < numObjects; i++)
     {
         uint8_t* selectionFlags = &_objectSelectionFlags[i];
@@ -236,7 +236,7 @@ void sub_6AB211()
         _numAvailableObjectsForType[objectType] = 0;
     }
 
-    const ObjectRepositoryItem* items = object_repository_get_items();
+    const auto& items = object_repository_get_items();
     for (int32_t i = 0; i < numObjects; i++)
     {
         uint8_t objectType = items[i].ObjectEntry.GetType();
@@ -318,7 +318,7 @@ static void remove_selected_objects_from_research(const rct_object_entry* instal
 void unload_unselected_objects()
 {
     int32_t numItems = static_cast<int32_t>(object_repository_get_items_count());
-    const ObjectRepositoryItem* items = object_repository_get_items();
+    const auto& items = object_repository_get_items();
     std::vector<rct_object_entry> objectsToUnload;
 
     for (int32_t i = 0; i < numItems; i++)
@@ -361,7 +361,7 @@ void reset_selected_object_count_and_size()
     }
 
     int32_t numObjects = static_cast<int32_t>(object_repository_get_items_count());
-    const ObjectRepositoryItem* items = object_repository_get_items();
+    const auto& items = object_repository_get_items();
     for (int32_t i = 0; i < numObjects; i++)
     {
         uint8_t objectType = items[i].ObjectEntry.GetType();
@@ -420,7 +420,7 @@ int32_t window_editor_object_selection_select_object(uint8_t bh, int32_t flags,
 
     // Get repository item index
     int32_t index = -1;
-    const ObjectRepositoryItem* items = object_repository_get_items();
+    const auto& items = object_repository_get_items();
     for (int32_t i = 0; i < numObjects; i++)
     {
         if (&items[i] == item)
@@ -524,7 +524,7 @@ int32_t window_editor_object_selection_select_object(uint8_t bh, int32_t flags,
 bool editor_check_object_group_at_least_one_selected(int32_t checkObjectType)
 {
     int32_t numObjects = static_cast<int32_t>(object_repository_get_items_count());
-    const ObjectRepositoryItem* items = object_repository_get_items();
+    const auto& items = object_repository_get_items();
 
     for (int32_t i = 0; i < numObjects; i++)
     {
@@ -543,7 +543,7 @@ int32_t editor_remove_unused_objects()
     setup_in_use_selection_flags();
 
     int32_t numObjects = static_cast<int32_t>(object_repository_get_items_count());
-    const ObjectRepositoryItem* items = object_repository_get_items();
+    const auto& items = object_repository_get_items();
 
     int32_t numUnselectedObjects = 0;
     for (int32_t i = 0; i < numObjects; i++)
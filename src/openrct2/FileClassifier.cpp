@@ -9,6 +9,7 @@
 
 #include "FileClassifier.h"
 
+#include "ParkFile.h"
 #include "core/Console.hpp"
 #include "core/FileStream.hpp"
 #include "core/Path.hpp"
@@ -67,8 +68,17 @@ static bool TryClassifyAsS6(OpenRCT2::IStream* stream, ClassifiedFileInfo* resul
     uint64_t originalPosition = stream->GetPosition();
     try
     {
-        auto chunkReader = SawyerChunkReader(stream);
-        auto s6Header = chunkReader.ReadChunkAs<rct_s6_header>();
+        rct_s6_header s6Header;
+        if (OpenRCT2::ParkFileReader::IsParkFile(stream))
+        {
+            auto reader = OpenRCT2::ParkFileReader(stream);
+            reader.ReadChunk(S6_PARK_CHUNK_HEADER, &s6Header, sizeof(s6Header));
+        }
+        else
+        {
+            auto chunkReader = SawyerChunkReader(stream);
+            s6Header = chunkReader.ReadChunkAs<rct_s6_header>();
+        }
         if (s6Header.type == S6_TYPE_SAVEDGAME)
         {
             result->Type = FILE_TYPE::SAVED_GAME;
@@ -183,5 +193,7 @@ uint32_t get_file_extension_type(const utf8* path)
         return FILE_EXTENSION_SV6;
     if (String::Equals(extension, ".td6", true))
         return FILE_EXTENSION_TD6;
+    if (String::Equals(extension, ".park", true))
+        return FILE_EXTENSION_PARK;
     return FILE_EXTENSION_UNKNOWN;
 }
@@ -16,13 +16,16 @@
 #include "GameStateSnapshots.h"
 #include "Input.h"
 #include "OpenRCT2.h"
+#include "ParkFile.h"
 #include "ParkImporter.h"
 #include "PlatformEnvironment.h"
 #include "ReplayManager.h"
 #include "actions/LoadOrQuitAction.hpp"
 #include "audio/audio.h"
 #include "config/Config.h"
+#include "core/File.h"
 #include "core/FileScanner.h"
+#include "core/FileStream.hpp"
 #include "core/Path.hpp"
 #include "interface/Colour.h"
 #include "interface/Screenshot.h"
@@ -40,6 +43,7 @@
 #include "peep/Staff.h"
 #include "platform/Platform2.h"
 #include "rct1/RCT1.h"
+#include "rct2/S6Exporter.h"
 #include "ride/Ride.h"
 #include "ride/RideRatings.h"
 #include "ride/Station.h"
@@ -67,7 +71,9 @@
 #include "world/Water.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstdio>
+#include <future>
 #include <iterator>
 #include <memory>
 
@@ -85,6 +91,14 @@ bool gLoadKeepWindowsOpen = false;
 uint32_t gCurrentTicks;
 uint32_t gCurrentRealTimeTicks;
 
+static std::future<void> _autosaveJob;
+
+// Incremental autosaves, only used by the autosave job of which only one runs at a time
+constexpr int32_t AUTOSAVE_DELTAS_PER_BASE = 12;
+static std::shared_ptr<const OpenRCT2::ParkFileWriter> _autosaveBase;
+static std::string _autosaveBaseName;
+static int32_t _autosaveDeltaCount;
+
 rct_string_id gGameCommandErrorTitle;
 rct_string_id gGameCommandErrorText;
 
@@ -549,6 +563,12 @@ void game_load_init()
     IGameStateSnapshots* snapshots = GetContext()->GetGameStateSnapshots();
     snapshots->Reset();
 
+    // Incremental autosaves of the new park must not be written as changes to a base of the previous one
+    game_autosave_wait();
+    _autosaveBase = nullptr;
+    _autosaveBaseName.clear();
+    _autosaveDeltaCount = 0;
+
     gScreenFlags = SCREEN_FLAGS_PLAYING;
     OpenRCT2::Audio::StopAll();
     if (!gLoadKeepWindowsOpen)
@@ -697,7 +717,7 @@ static void limit_autosave_count(const size_t numberOfFilesToKeep, bool processL
     {
         platform_get_user_directory(filter, "save", sizeof(filter));
         safe_strcat_path(filter, "autosave", sizeof(filter));
-        safe_strcat_path(filter, "autosave_*.sv6", sizeof(filter));
+        safe_strcat_path(filter, "autosave_*.park;autosave_*.sv6", sizeof(filter));
     }
 
     // At first, count how many autosaves there are
@@ -750,18 +770,104 @@ static void limit_autosave_count(const size_t numberOfFilesToKeep, bool processL
     }
 }
 
+/**
+ * Deletes the bases of incremental autosaves that no autosave refers to any more.
+ */
+static void remove_unused_autosave_bases(const std::string& directory)
+{
+    std::vector<std::string> usedBases = { _autosaveBaseName };
+    {
+        auto scanner = std::unique_ptr<IFileScanner>(Path::ScanDirectory(Path::Combine(directory, "autosave*"), false));
+        while (scanner->Next())
+        {
+            try
+            {
+                auto fs = OpenRCT2::FileStream(scanner->GetPath(), OpenRCT2::FILE_MODE_OPEN);
+                if (OpenRCT2::ParkFileReader::IsParkFile(&fs))
+                {
+                    auto reader = OpenRCT2::ParkFileReader(&fs);
+                    if (reader.IsDelta())
+                    {
+                        usedBases.push_back(reader.GetBasePath());
+                    }
+                }
+            }
+            catch (const std::exception& e)
+            {
+                log_warning("Unable to read autosave '%s': %s", scanner->GetPath(), e.what());
+            }
+        }
+    }
+
+    auto scanner = std::unique_ptr<IFileScanner>(Path::ScanDirectory(Path::Combine(directory, "base_*.park"), false));
+    while (scanner->Next())
+    {
+        if (std::find(usedBases.begin(), usedBases.end(), scanner->GetPathRelative()) == usedBases.end())
+        {
+            File::Delete(scanner->GetPath());
+        }
+    }
+}
+
+/**
+ * Saves an autosave as the changes since the last base, a new base is written every so often or once the changes have
+ * grown too large.
+ */
+static void autosave_save_incremental(S6Exporter& exporter, const std::string& path, const std::string& tempPath)
+{
+    auto directory = Path::GetDirectory(path);
+    if (_autosaveBase == nullptr || _autosaveDeltaCount >= AUTOSAVE_DELTAS_PER_BASE
+        || !File::Exists(Path::Combine(directory, _autosaveBaseName)))
+    {
+        auto baseName = "base_" + Path::GetFileNameWithoutExtension(path) + ".park";
+        auto basePath = Path::Combine(directory, baseName);
+        auto baseTempPath = basePath + ".tmp";
+        exporter.DeltaBase = nullptr;
+        exporter.SaveGame(baseTempPath.c_str());
+        File::Delete(basePath);
+        if (!File::Move(baseTempPath, basePath))
+        {
+            File::Delete(baseTempPath);
+            throw IOException("Unable to move the autosave base into place.");
+        }
+        _autosaveBase = exporter.GetParkFile();
+        _autosaveBaseName = baseName;
+        _autosaveDeltaCount = 0;
+    }
+
+    exporter.DeltaBase = _autosaveBase;
+    exporter.DeltaBasePath = _autosaveBaseName;
+    exporter.SaveGame(tempPath.c_str());
+    log_verbose("Autosave delta holds %zu of %zu bytes", exporter.GetDeltaLength(), _autosaveBase->GetLength());
+
+    // Every delta holds all changes since the base, start over once loading one costs a good part of a whole save
+    _autosaveDeltaCount++;
+    if (exporter.GetDeltaLength() > _autosaveBase->GetLength() / 4)
+    {
+        _autosaveDeltaCount = AUTOSAVE_DELTAS_PER_BASE;
+    }
+}
+
+static int64_t ToMicroseconds(std::chrono::steady_clock::duration duration)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
 void game_autosave()
 {
-    const char* subDirectory = "save";
-    const char* fileExtension = ".sv6";
-    uint32_t saveFlags = 0x80000000;
-    if (gScreenFlags & SCREEN_FLAGS_EDITOR)
+    // Only one autosave is written at a time, a save that is still being written means the disk can not keep up
+    if (_autosaveJob.valid() && _autosaveJob.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
     {
-        subDirectory = "landscape";
-        fileExtension = ".sc6";
-        saveFlags |= 2;
+        log_warning("Skipping autosave, the previous autosave is still being written.");
+        return;
     }
 
+    bool isLandscape = (gScreenFlags & SCREEN_FLAGS_EDITOR) != 0;
+    const char* subDirectory = isLandscape ? "landscape" : "save";
+    // Autosaves are only meant to be loaded by OpenRCT2, so park games use the faster park file format. It is not an
+    // SV6 file, so it does not get its extension either.
+    const char* fileExtension = isLandscape ? ".sc6" : ".park";
+
     // Retrieve current time
     auto currentDate = Platform::GetDateLocal();
     auto currentTime = Platform::GetTimeLocal();
@@ -771,27 +877,102 @@ void game_autosave()
         timeName, sizeof(timeName), "autosave_%04u-%02u-%02u_%02u-%02u-%02u%s", currentDate.year, currentDate.month,
         currentDate.day, currentTime.hour, currentTime.minute, currentTime.second, fileExtension);
 
+    utf8 directory[MAX_PATH];
+    platform_get_user_directory(directory, subDirectory, sizeof(directory));
+    safe_strcat_path(directory, "autosave", sizeof(directory));
+    platform_ensure_directory_exists(directory);
+    std::string path = Path::Combine(directory, timeName);
+    std::string backupPath = Path::Combine(directory, std::string("autosave") + fileExtension + ".bak");
+
+    // Export the park on this thread, only the copy in the exporter is used after this
+    auto startTime = std::chrono::steady_clock::now();
+    map_reorganise_elements();
+    viewport_set_saved_view();
+    auto exporter = std::make_shared<S6Exporter>();
+    try
+    {
+        exporter->RemoveTracklessRides = true;
+        exporter->UseParkFile = !isLandscape;
+        exporter->Export();
+    }
+    catch (const std::exception& e)
+    {
+        log_error("Unable to autosave park: '%s'", e.what());
+        return;
+    }
+    auto exportTime = std::chrono::steady_clock::now() - startTime;
+    log_verbose("Autosave export took %lld us", static_cast<long long>(ToMicroseconds(exportTime)));
+
     int32_t autosavesToKeep = gConfigGeneral.autosave_amount;
-    limit_autosave_count(autosavesToKeep - 1, (gScreenFlags & SCREEN_FLAGS_EDITOR));
+    bool incremental = gConfigGeneral.autosave_incremental && !isLandscape;
+    _autosaveJob = std::async(std::launch::async, [exporter, isLandscape, incremental, path, backupPath, autosavesToKeep]() {
+        auto jobStartTime = std::chrono::steady_clock::now();
 
-    utf8 path[MAX_PATH];
-    utf8 backupPath[MAX_PATH];
-    platform_get_user_directory(path, subDirectory, sizeof(path));
-    safe_strcat_path(path, "autosave", sizeof(path));
-    platform_ensure_directory_exists(path);
-    safe_strcpy(backupPath, path, sizeof(backupPath));
-    safe_strcat_path(path, timeName, sizeof(path));
-    safe_strcat_path(backupPath, "autosave", sizeof(backupPath));
-    safe_strcat(backupPath, fileExtension, sizeof(backupPath));
-    safe_strcat(backupPath, ".bak", sizeof(backupPath));
+        limit_autosave_count(autosavesToKeep - 1, isLandscape);
+        if (File::Exists(path))
+        {
+            platform_file_copy(path.c_str(), backupPath.c_str(), true);
+        }
 
-    if (Platform::FileExists(path))
+        // Written next to the target first so a crash or a full disk never leaves a truncated autosave behind
+        auto tempPath = path + ".tmp";
+        try
+        {
+            if (isLandscape)
+            {
+                exporter->SaveScenario(tempPath.c_str());
+            }
+            else if (incremental)
+            {
+                autosave_save_incremental(*exporter, path, tempPath);
+            }
+            else
+            {
+                exporter->SaveGame(tempPath.c_str());
+            }
+            File::Delete(path);
+            if (!File::Move(tempPath, path))
+            {
+                throw IOException("Unable to move the autosave into place.");
+            }
+        }
+        catch (const std::exception& e)
+        {
+            File::Delete(tempPath);
+            std::fprintf(stderr, "Could not autosave the scenario. Is the save folder writeable? (%s)\n", e.what());
+            return;
+        }
+
+        if (!isLandscape)
+        {
+            remove_unused_autosave_bases(Path::GetDirectory(path));
+        }
+
+        auto writeTime = std::chrono::steady_clock::now() - jobStartTime;
+        log_verbose("Autosave write took %lld us", static_cast<long long>(ToMicroseconds(writeTime)));
+    });
+}
+
+/**
+ * Finishes an autosave once its background job has written it. Called every update on the main thread.
+ */
+void game_autosave_update()
+{
+    if (_autosaveJob.valid() && _autosaveJob.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
     {
-        platform_file_copy(path, backupPath, true);
+        _autosaveJob.get();
+
+        // As after any other save
+        gfx_invalidate_screen();
     }
+}
 
-    if (!scenario_save(path, saveFlags))
-        std::fprintf(stderr, "Could not autosave the scenario. Is the save folder writeable?\n");
+void game_autosave_wait()
+{
+    if (_autosaveJob.valid())
+    {
+        _autosaveJob.wait();
+    }
 }
 
 static void game_load_or_quit_no_save_prompt_callback(int32_t result, const utf8* path)
@@ -168,6 +168,8 @@ void save_game_as();
 void save_game_cmd(const utf8* name = nullptr);
 void save_game_with_name(const utf8* name);
 void game_autosave();
+void game_autosave_update();
+void game_autosave_wait();
 void game_convert_strings_to_utf8();
 void game_convert_news_items_to_utf8();
 void game_convert_strings_to_rct2(rct_s6_data* s6);
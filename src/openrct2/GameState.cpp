@@ -211,6 +211,7 @@ void GameState::Update()
     if (!(gScreenFlags & SCREEN_FLAGS_TITLE_DEMO) && !(gScreenFlags & SCREEN_FLAGS_TRACK_DESIGNER)
         && !(gScreenFlags & SCREEN_FLAGS_TRACK_MANAGER))
     {
+        game_autosave_update();
         scenario_autosave_check();
     }
 
@@ -253,6 +254,12 @@ void GameState::UpdateLogic()
             return;
         }
 
+        // Hold on the desynchronised tick until the server sent the diverged entities.
+        if (network_is_resynchronising())
+        {
+            return;
+        }
+
         // Check desync.
         bool desynced = network_check_desynchronisation();
         if (desynced)
@@ -260,11 +267,15 @@ void GameState::UpdateLogic()
             // If desync debugging is enabled and we are still connected request the specific game state from server.
             if (network_gamestate_snapshots_enabled() && network_get_status() == NETWORK_STATUS_CONNECTED)
             {
-                // Create snapshot from this tick so we can compare it later
-                // as we won't pause the game on this event.
+                // Create snapshot from this tick so only the entity ranges that differ are requested
+                // and so we can compare it later.
                 CreateStateSnapshot();
 
                 network_request_gamestate_snapshot();
+                if (network_is_resynchronising())
+                {
+                    return;
+                }
             }
         }
     }
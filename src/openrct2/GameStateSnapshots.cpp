@@ -11,10 +11,49 @@
 
 #include "core/CircularBuffer.h"
 #include "peep/Peep.h"
+#include "scenario/Scenario.h"
 #include "world/Sprite.h"
 
 static constexpr size_t MaximumGameStateSnapshots = 32;
 static constexpr uint32_t InvalidTick = 0xFFFFFFFF;
+static constexpr size_t NumEntityLists = static_cast<size_t>(EntityListId::Count);
+
+// Number of bytes of the entity that are part of the game state, zero for unused sprites.
+static size_t GetEntitySize(const rct_sprite& sprite)
+{
+    switch (sprite.generic.sprite_identifier)
+    {
+        case SPRITE_IDENTIFIER_VEHICLE:
+            return sizeof(Vehicle);
+        case SPRITE_IDENTIFIER_PEEP:
+            return sizeof(Peep);
+        case SPRITE_IDENTIFIER_LITTER:
+            return sizeof(Litter);
+        case SPRITE_IDENTIFIER_MISC:
+            switch (sprite.generic.type)
+            {
+                case SPRITE_MISC_MONEY_EFFECT:
+                    return sizeof(MoneyEffect);
+                case SPRITE_MISC_BALLOON:
+                    return sizeof(Balloon);
+                case SPRITE_MISC_DUCK:
+                    return sizeof(Duck);
+                case SPRITE_MISC_JUMPING_FOUNTAIN_WATER:
+                case SPRITE_MISC_JUMPING_FOUNTAIN_SNOW:
+                    return sizeof(JumpingFountain);
+                case SPRITE_MISC_STEAM_PARTICLE:
+                    return sizeof(SteamParticle);
+                case SPRITE_MISC_CRASHED_VEHICLE_PARTICLE:
+                    return sizeof(VehicleCrashParticle);
+                case SPRITE_MISC_EXPLOSION_CLOUD:
+                case SPRITE_MISC_CRASH_SPLASH:
+                case SPRITE_MISC_EXPLOSION_FLARE:
+                    return sizeof(SpriteGeneric);
+            }
+            break;
+    }
+    return 0;
+}
 
 struct GameStateSnapshot_t
 {
@@ -22,6 +61,10 @@ struct GameStateSnapshot_t
     {
         tick = mv.tick;
         storedSprites = std::move(mv.storedSprites);
+        randState = mv.randState;
+        spriteListHeads = mv.spriteListHeads;
+        spriteListCounts = mv.spriteListCounts;
+        freeSprites = std::move(mv.freeSprites);
         return *this;
     }
 
@@ -31,6 +74,12 @@ struct GameStateSnapshot_t
     OpenRCT2::MemoryStream storedSprites;
     OpenRCT2::MemoryStream parkParameters;
 
+    // Required to patch another game state into this one, see SerialiseDelta.
+    random_engine_t::state_type randState{};
+    std::array<uint16_t, NumEntityLists> spriteListHeads{};
+    std::array<uint16_t, NumEntityLists> spriteListCounts{};
+    std::vector<uint16_t> freeSprites;
+
     // Must pass a function that can access the sprite.
     void SerialiseSprites(std::function<rct_sprite*(const size_t)> getEntity, const size_t numSprites, bool saving)
     {
@@ -109,6 +158,18 @@ struct GameStateSnapshot_t
                         case SPRITE_MISC_STEAM_PARTICLE:
                             ds << reinterpret_cast<uint8_t(&)[sizeof(SteamParticle)]>(sprite.steam_particle);
                             break;
+                        case SPRITE_MISC_JUMPING_FOUNTAIN_SNOW:
+                            ds << reinterpret_cast<uint8_t(&)[sizeof(JumpingFountain)]>(sprite.jumping_fountain);
+                            break;
+                        case SPRITE_MISC_CRASHED_VEHICLE_PARTICLE:
+                            ds << reinterpret_cast<uint8_t(&)[sizeof(VehicleCrashParticle)]>(
+                                sprite.crashed_vehicle_particle);
+                            break;
+                        case SPRITE_MISC_EXPLOSION_CLOUD:
+                        case SPRITE_MISC_CRASH_SPLASH:
+                        case SPRITE_MISC_EXPLOSION_FLARE:
+                            ds << reinterpret_cast<uint8_t(&)[sizeof(SpriteGeneric)]>(sprite.generic);
+                            break;
                     }
                 }
                 break;
@@ -143,6 +204,19 @@ struct GameStateSnapshots final : public IGameStateSnapshots
         snapshot.SerialiseSprites(
             [](const size_t index) { return reinterpret_cast<rct_sprite*>(GetEntity(index)); }, MAX_SPRITES, true);
 
+        snapshot.randState = scenario_rand_state();
+        std::copy_n(gSpriteListHead, NumEntityLists, snapshot.spriteListHeads.begin());
+        std::copy_n(gSpriteListCount, NumEntityLists, snapshot.spriteListCounts.begin());
+
+        // The order of the free list decides which index the next entity gets, so it has to be kept as well
+        snapshot.freeSprites.clear();
+        for (auto* sprite : EntityList(EntityListId::Free))
+        {
+            snapshot.freeSprites.push_back(sprite->sprite_index);
+            if (snapshot.freeSprites.size() >= MAX_SPRITES)
+                break;
+        }
+
         // log_info("Snapshot size: %u bytes", static_cast<uint32_t>(snapshot.storedSprites.GetLength()));
     }
 
@@ -164,6 +238,167 @@ struct GameStateSnapshots final : public IGameStateSnapshots
         ds << snapshot.parkParameters;
     }
 
+    virtual std::vector<uint64_t> GetSpriteRangeHashes(const GameStateSnapshot_t& snapshot) const override final
+    {
+        std::vector<rct_sprite> sprites = BuildSpriteList(const_cast<GameStateSnapshot_t&>(snapshot));
+
+        std::vector<uint64_t> hashes;
+        for (size_t start = 0; start < sprites.size(); start += GameStateSpriteRangeSize)
+        {
+            // FNV-1a over every entity in the range, without the fields that may legitimately differ
+            uint64_t hash = 0xcbf29ce484222325;
+            size_t end = std::min(start + GameStateSpriteRangeSize, sprites.size());
+            for (size_t i = start; i < end; i++)
+            {
+                rct_sprite copy = sprites[i];
+                NormaliseEntity(copy);
+
+                const auto* bytes = reinterpret_cast<const uint8_t*>(&copy);
+                size_t size = std::max<size_t>(GetEntitySize(copy), sizeof(copy.generic.sprite_identifier));
+                for (size_t j = 0; j < size; j++)
+                {
+                    hash = (hash ^ bytes[j]) * 0x100000001b3;
+                }
+            }
+            hashes.push_back(hash);
+        }
+        return hashes;
+    }
+
+    virtual void SerialiseDelta(
+        const GameStateSnapshot_t& snapshot, const std::vector<uint64_t>& rangeHashes, DataSerialiser& ds) const override final
+    {
+        std::vector<rct_sprite> sprites = BuildSpriteList(const_cast<GameStateSnapshot_t&>(snapshot));
+        std::vector<uint64_t> hashes = GetSpriteRangeHashes(snapshot);
+
+        std::vector<uint16_t> ranges;
+        for (size_t i = 0; i < hashes.size(); i++)
+        {
+            if (i >= rangeHashes.size() || hashes[i] != rangeHashes[i])
+            {
+                ranges.push_back(static_cast<uint16_t>(i));
+            }
+        }
+
+        auto randState = snapshot.randState;
+        auto spriteListHeads = snapshot.spriteListHeads;
+        auto spriteListCounts = snapshot.spriteListCounts;
+        auto freeSprites = snapshot.freeSprites;
+        ds << randState.s0 << randState.s1 << spriteListHeads << spriteListCounts << freeSprites << ranges;
+
+        for (auto range : ranges)
+        {
+            size_t start = range * GameStateSpriteRangeSize;
+            size_t end = std::min(start + GameStateSpriteRangeSize, sprites.size());
+            for (size_t i = start; i < end; i++)
+            {
+                auto& sprite = sprites[i];
+                ds << sprite.generic.sprite_identifier << sprite.generic.type;
+                ds.GetStream().Write(&sprite, GetEntitySize(sprite));
+            }
+        }
+    }
+
+    virtual size_t ApplyDelta(DataSerialiser& ds) override final
+    {
+        random_engine_t::state_type randState{};
+        std::array<uint16_t, NumEntityLists> spriteListHeads{};
+        std::array<uint16_t, NumEntityLists> spriteListCounts{};
+        std::vector<uint16_t> freeSprites;
+        std::vector<uint16_t> ranges;
+        ds << randState.s0 << randState.s1 << spriteListHeads << spriteListCounts << freeSprites << ranges;
+
+        std::vector<uint16_t> patched;
+        for (auto range : ranges)
+        {
+            size_t start = range * GameStateSpriteRangeSize;
+            size_t end = std::min<size_t>(start + GameStateSpriteRangeSize, MAX_SPRITES);
+            for (size_t i = start; i < end; i++)
+            {
+                rct_sprite incoming;
+                ds << incoming.generic.sprite_identifier << incoming.generic.type;
+                ds.GetStream().Read(&incoming, GetEntitySize(incoming));
+
+                auto& sprite = *reinterpret_cast<rct_sprite*>(GetEntity(i));
+                PatchEntity(sprite, incoming);
+                patched.push_back(static_cast<uint16_t>(i));
+            }
+        }
+
+        // Unused sprites are not part of the delta, relink all of them in the order of the other game state
+        for (size_t i = 0; i < freeSprites.size(); i++)
+        {
+            auto* sprite = GetEntity(freeSprites[i]);
+            if (sprite == nullptr)
+                continue;
+            sprite->linked_list_index = EntityListId::Free;
+            sprite->previous = i > 0 ? freeSprites[i - 1] : SPRITE_INDEX_NULL;
+            sprite->next = i + 1 < freeSprites.size() ? freeSprites[i + 1] : SPRITE_INDEX_NULL;
+        }
+        std::copy(spriteListHeads.begin(), spriteListHeads.end(), gSpriteListHead);
+        std::copy(spriteListCounts.begin(), spriteListCounts.end(), gSpriteListCount);
+        scenario_rand_seed(randState.s0, randState.s1);
+
+        // The spatial index is kept sorted, rebuilding it gives the same order as on the other side
+        reset_sprite_spatial_index();
+        for (auto index : patched)
+        {
+            auto* sprite = GetEntity(index);
+            if (sprite->sprite_identifier == SPRITE_IDENTIFIER_NULL)
+                continue;
+            if (sprite->x == LOCATION_NULL)
+                sprite->sprite_left = LOCATION_NULL;
+            else
+                sprite_set_coordinates({ sprite->x, sprite->y, sprite->z }, sprite);
+        }
+
+        return ranges.size();
+    }
+
+    static void NormaliseEntity(rct_sprite& sprite)
+    {
+        // Same exclusions as the sprite checksum, these have no meaning to the game state
+        sprite.generic.sprite_left = sprite.generic.sprite_right = sprite.generic.sprite_top = sprite.generic.sprite_bottom = 0;
+        sprite.generic.sprite_width = sprite.generic.sprite_height_negative = sprite.generic.sprite_height_positive = 0;
+        if (sprite.generic.sprite_identifier == SPRITE_IDENTIFIER_PEEP)
+        {
+            sprite.peep.Name = {};
+            sprite.peep.WindowInvalidateFlags = 0;
+        }
+    }
+
+    static void PatchEntity(rct_sprite& sprite, const rct_sprite& incoming)
+    {
+        // Peep names are owned by this process, keep them when the slot stays a peep
+        char* name = nullptr;
+        uint8_t windowInvalidateFlags = 0;
+        if (sprite.generic.sprite_identifier == SPRITE_IDENTIFIER_PEEP)
+        {
+            if (incoming.generic.sprite_identifier == SPRITE_IDENTIFIER_PEEP)
+            {
+                name = sprite.peep.Name;
+                windowInvalidateFlags = sprite.peep.WindowInvalidateFlags;
+            }
+            else
+            {
+                sprite.peep.SetName({});
+            }
+        }
+
+        size_t size = GetEntitySize(incoming);
+        if (size == 0)
+        {
+            sprite.generic.sprite_identifier = SPRITE_IDENTIFIER_NULL;
+            return;
+        }
+        std::memcpy(&sprite, &incoming, size);
+        if (sprite.generic.sprite_identifier == SPRITE_IDENTIFIER_PEEP)
+        {
+            sprite.peep.Name = name;
+            sprite.peep.WindowInvalidateFlags = windowInvalidateFlags;
+        }
+    }
+
     std::vector<rct_sprite> BuildSpriteList(GameStateSnapshot_t& snapshot) const
     {
         std::vector<rct_sprite> spriteList;
@@ -15,9 +15,13 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 struct GameStateSnapshot_t;
 
+// Number of consecutive sprite indices covered by one hash when looking for diverged entities.
+static constexpr size_t GameStateSpriteRangeSize = 64;
+
 struct GameStateSpriteChange_t
 {
     enum
@@ -94,6 +98,23 @@ struct IGameStateSnapshots
      */
     virtual void SerialiseSnapshot(GameStateSnapshot_t& snapshot, DataSerialiser& serialiser) const = 0;
 
+    /*
+     * Hashes the entities of the snapshot in ranges of GameStateSpriteRangeSize indices.
+     */
+    virtual std::vector<uint64_t> GetSpriteRangeHashes(const GameStateSnapshot_t& snapshot) const = 0;
+
+    /*
+     * Writes the entities of every range whose hash differs from rangeHashes, along with the sprite lists and the
+     * random state, so that a diverged game state can be patched with ApplyDelta.
+     */
+    virtual void SerialiseDelta(
+        const GameStateSnapshot_t& snapshot, const std::vector<uint64_t>& rangeHashes, DataSerialiser& ds) const = 0;
+
+    /*
+     * Patches the current game state with a delta written by SerialiseDelta, returns the number of ranges replaced.
+     */
+    virtual size_t ApplyDelta(DataSerialiser& ds) = 0;
+
     /*
      * Compares two states resulting GameStateCompareData_t with all mismatches stored.
      */
@@ -0,0 +1,506 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "ParkFile.h"
+
+#include "core/IStream.hpp"
+#include "core/Parallel.h"
+
+#include <algorithm>
+#include <cstring>
+#include <zlib.h>
+
+using namespace OpenRCT2;
+
+// 'PARK' when read as little endian
+constexpr uint32_t PARK_FILE_MAGIC = 0x4B524150;
+constexpr uint32_t PARK_FILE_VERSION = 1;
+
+// Small enough to keep every core busy on the large chunks of a park
+constexpr size_t PARK_FILE_BLOCK_SIZE = 256 * 1024;
+constexpr uint32_t PARK_FILE_MAX_BLOCKS = 0x10000;
+
+// Deltas compare chunks in pages, chunks smaller than a few pages are stored as a whole
+constexpr size_t PARK_FILE_DELTA_PAGE_SIZE = 256;
+constexpr size_t PARK_FILE_DELTA_MIN_CHUNK_SIZE = 4096;
+// The delta of a chunk is stored under the id of the chunk with this bit set
+constexpr uint32_t PARK_FILE_DELTA_CHUNK = 0x80000000;
+constexpr uint32_t PARK_FILE_CHUNK_BASE_PATH = 0x7FFFFFFF;
+
+#pragma pack(push, 1)
+struct ParkFileHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    uint64_t Length;
+    uint32_t NumBlocks;
+};
+assert_struct_size(ParkFileHeader, 20);
+
+struct ParkFileBlockEntry
+{
+    uint32_t ChunkId;
+    uint8_t Compression;
+    uint64_t Offset;
+    uint32_t Length;
+    uint32_t ChunkOffset;
+    uint32_t UncompressedLength;
+    uint32_t Checksum;
+};
+assert_struct_size(ParkFileBlockEntry, 29);
+#pragma pack(pop)
+
+static int32_t GetCompressionLevel(ParkFileCompression compression)
+{
+    return compression == ParkFileCompression::Small ? Z_BEST_COMPRESSION : Z_BEST_SPEED;
+}
+
+void ParkFileWriter::AddChunk(uint32_t id, const void* data, size_t length)
+{
+    auto data8 = static_cast<const uint8_t*>(data);
+    _chunks.push_back({ id, std::vector<uint8_t>(data8, data8 + length) });
+}
+
+void ParkFileWriter::Save(IStream* stream, ParkFileCompression compression) const
+{
+    struct PendingBlock
+    {
+        ParkFileBlockEntry Entry{};
+        const uint8_t* Source{};
+        std::vector<uint8_t> Compressed;
+        std::promise<void> Ready;
+    };
+
+    std::vector<PendingBlock> blocks;
+    for (const auto& chunk : _chunks)
+    {
+        for (size_t offset = 0; offset < chunk.Data.size(); offset += PARK_FILE_BLOCK_SIZE)
+        {
+            auto& block = blocks.emplace_back();
+            block.Entry.ChunkId = chunk.Id;
+            block.Entry.ChunkOffset = static_cast<uint32_t>(offset);
+            block.Entry.UncompressedLength = static_cast<uint32_t>(std::min(PARK_FILE_BLOCK_SIZE, chunk.Data.size() - offset));
+            block.Source = chunk.Data.data() + offset;
+        }
+    }
+    if (blocks.size() > PARK_FILE_MAX_BLOCKS)
+    {
+        throw std::runtime_error("Park is too large.");
+    }
+
+    // Blocks are written in order by this thread while the ones after them are still being compressed
+    auto compressJob = std::async(std::launch::async, [&blocks, compression]() {
+        Parallel::For(blocks.size(), [&blocks, compression](size_t i) {
+            auto& block = blocks[i];
+            try
+            {
+                auto& entry = block.Entry;
+                entry.Checksum = crc32(0, block.Source, entry.UncompressedLength);
+                entry.Compression = static_cast<uint8_t>(ParkFileCompression::None);
+                if (compression != ParkFileCompression::None)
+                {
+                    uLongf compressedLength = compressBound(entry.UncompressedLength);
+                    block.Compressed.resize(compressedLength);
+                    int32_t result = compress2(
+                        block.Compressed.data(), &compressedLength, block.Source, entry.UncompressedLength,
+                        GetCompressionLevel(compression));
+                    if (result == Z_OK && compressedLength < entry.UncompressedLength)
+                    {
+                        block.Compressed.resize(compressedLength);
+                        entry.Compression = static_cast<uint8_t>(compression);
+                    }
+                    else
+                    {
+                        block.Compressed.clear();
+                    }
+                }
+                block.Ready.set_value();
+            }
+            catch (const std::exception&)
+            {
+                block.Ready.set_exception(std::current_exception());
+            }
+        });
+    });
+
+    uint64_t start = stream->GetPosition();
+    ParkFileHeader header{};
+    header.Magic = PARK_FILE_MAGIC;
+    header.Version = PARK_FILE_VERSION;
+    header.NumBlocks = static_cast<uint32_t>(blocks.size());
+    std::vector<ParkFileBlockEntry> table(blocks.size());
+    stream->WriteValue(header);
+    stream->Write(table.data(), table.size() * sizeof(ParkFileBlockEntry));
+
+    for (size_t i = 0; i < blocks.size(); i++)
+    {
+        auto& block = blocks[i];
+        block.Ready.get_future().get();
+
+        auto& entry = block.Entry;
+        entry.Offset = stream->GetPosition() - start;
+        if (entry.Compression == static_cast<uint8_t>(ParkFileCompression::None))
+        {
+            entry.Length = entry.UncompressedLength;
+            stream->Write(block.Source, entry.Length);
+        }
+        else
+        {
+            entry.Length = static_cast<uint32_t>(block.Compressed.size());
+            stream->Write(block.Compressed.data(), entry.Length);
+        }
+        table[i] = entry;
+        block.Compressed = {};
+    }
+    compressJob.get();
+
+    uint64_t end = stream->GetPosition();
+    header.Length = end - start;
+    stream->SetPosition(start);
+    stream->WriteValue(header);
+    stream->Write(table.data(), table.size() * sizeof(ParkFileBlockEntry));
+    stream->SetPosition(end);
+}
+
+size_t ParkFileWriter::SaveDelta(
+    IStream* stream, const ParkFileWriter& base, const std::string& basePath, ParkFileCompression compression) const
+{
+    ParkFileWriter delta;
+    size_t deltaLength = 0;
+    for (const auto& chunk : _chunks)
+    {
+        auto baseChunk = std::find_if(
+            base._chunks.begin(), base._chunks.end(), [&chunk](const Chunk& c) { return c.Id == chunk.Id; });
+        if (baseChunk == base._chunks.end() || chunk.Data.size() < PARK_FILE_DELTA_MIN_CHUNK_SIZE)
+        {
+            delta.AddChunk(chunk.Id, chunk.Data.data(), chunk.Data.size());
+            deltaLength += chunk.Data.size();
+            continue;
+        }
+
+        // Checksum of the base chunk, length of the chunk, then each run of changed pages as offset, length and data
+        const auto& baseData = baseChunk->Data;
+        std::vector<uint8_t> patches;
+        auto append = [&patches](uint32_t value) {
+            auto bytes = reinterpret_cast<const uint8_t*>(&value);
+            patches.insert(patches.end(), bytes, bytes + sizeof(value));
+        };
+        append(crc32(0, baseData.data(), static_cast<uInt>(baseData.size())));
+        append(static_cast<uint32_t>(chunk.Data.size()));
+
+        size_t commonLength = std::min(chunk.Data.size(), baseData.size());
+        size_t runStart = 0;
+        size_t runLength = 0;
+        auto appendRun = [&]() {
+            append(static_cast<uint32_t>(runStart));
+            append(static_cast<uint32_t>(runLength));
+            patches.insert(patches.end(), chunk.Data.begin() + runStart, chunk.Data.begin() + runStart + runLength);
+            runLength = 0;
+        };
+        for (size_t offset = 0; offset < chunk.Data.size(); offset += PARK_FILE_DELTA_PAGE_SIZE)
+        {
+            size_t pageLength = std::min(PARK_FILE_DELTA_PAGE_SIZE, chunk.Data.size() - offset);
+            if (offset + pageLength > commonLength
+                || std::memcmp(chunk.Data.data() + offset, baseData.data() + offset, pageLength) != 0)
+            {
+                if (runLength == 0)
+                    runStart = offset;
+                runLength += pageLength;
+            }
+            else if (runLength != 0)
+            {
+                appendRun();
+            }
+        }
+        if (runLength != 0)
+        {
+            appendRun();
+        }
+        delta.AddChunk(chunk.Id | PARK_FILE_DELTA_CHUNK, patches.data(), patches.size());
+        deltaLength += patches.size();
+    }
+    delta.AddChunk(PARK_FILE_CHUNK_BASE_PATH, basePath.data(), basePath.size());
+    delta.Save(stream, compression);
+    return deltaLength;
+}
+
+size_t ParkFileWriter::GetLength() const
+{
+    size_t length = 0;
+    for (const auto& chunk : _chunks)
+    {
+        length += chunk.Data.size();
+    }
+    return length;
+}
+
+ParkFileReader::ParkFileReader(IStream* stream)
+    : _stream(stream)
+    , _start(stream->GetPosition())
+{
+    auto header = _stream->ReadValue<ParkFileHeader>();
+    if (header.Magic != PARK_FILE_MAGIC)
+    {
+        throw IOException("Not a park file.");
+    }
+    if (header.Version > PARK_FILE_VERSION)
+    {
+        throw IOException("Park file was saved by a newer version of OpenRCT2.");
+    }
+    if (header.NumBlocks > PARK_FILE_MAX_BLOCKS || _start + header.Length > _stream->GetLength())
+    {
+        throw IOException("Corrupt park file.");
+    }
+
+    for (uint32_t i = 0; i < header.NumBlocks; i++)
+    {
+        auto entry = _stream->ReadValue<ParkFileBlockEntry>();
+        if (entry.Offset + entry.Length > header.Length || entry.UncompressedLength > PARK_FILE_BLOCK_SIZE
+            || entry.Compression > static_cast<uint8_t>(ParkFileCompression::Small))
+        {
+            throw IOException("Corrupt park file.");
+        }
+        _blocks.push_back({ entry.ChunkId, static_cast<ParkFileCompression>(entry.Compression), entry.Offset, entry.Length,
+                            entry.ChunkOffset, entry.UncompressedLength, entry.Checksum });
+    }
+    _end = _start + header.Length;
+    _stream->SetPosition(_end);
+}
+
+bool ParkFileReader::IsParkFile(IStream* stream)
+{
+    uint64_t originalPosition = stream->GetPosition();
+    uint32_t magic = 0;
+    bool result = stream->TryRead(&magic, sizeof(magic)) == sizeof(magic) && magic == PARK_FILE_MAGIC;
+    stream->SetPosition(originalPosition);
+    return result;
+}
+
+bool ParkFileReader::HasChunk(uint32_t id) const
+{
+    return HasBlocks(id) || HasBlocks(id | PARK_FILE_DELTA_CHUNK);
+}
+
+bool ParkFileReader::IsDelta() const
+{
+    return HasBlocks(PARK_FILE_CHUNK_BASE_PATH);
+}
+
+std::string ParkFileReader::GetBasePath()
+{
+    auto data = ReadChunk(PARK_FILE_CHUNK_BASE_PATH);
+    return std::string(data.begin(), data.end());
+}
+
+void ParkFileReader::SetBase(IStream* stream)
+{
+    _base = std::make_unique<ParkFileReader>(stream);
+}
+
+void ParkFileReader::ReadChunk(uint32_t id, void* dst, size_t length)
+{
+    ReadChunksAsync({ { id, dst, length } }).get();
+}
+
+std::vector<uint8_t> ParkFileReader::ReadChunk(uint32_t id)
+{
+    std::vector<PendingChunk> chunks;
+    chunks.push_back(LoadChunk(id, nullptr, 0));
+    DecodeChunks(chunks);
+    return std::move(chunks[0].Data);
+}
+
+std::future<void> ParkFileReader::ReadChunksAsync(const std::vector<std::tuple<uint32_t, void*, size_t>>& chunks)
+{
+    // Reading from the stream stays on this thread, only decompression is left to the background
+    auto pending = std::make_shared<std::vector<PendingChunk>>();
+    for (const auto& [id, dst, length] : chunks)
+    {
+        pending->push_back(LoadChunk(id, dst, length));
+    }
+    return std::async(std::launch::async, [pending]() { DecodeChunks(*pending); });
+}
+
+bool ParkFileReader::HasBlocks(uint32_t id) const
+{
+    return std::any_of(_blocks.begin(), _blocks.end(), [id](const Block& block) { return block.ChunkId == id; });
+}
+
+std::vector<ParkFileReader::LoadedBlock> ParkFileReader::LoadBlocks(uint32_t id)
+{
+    std::vector<LoadedBlock> result;
+    for (const auto& block : _blocks)
+    {
+        if (block.ChunkId != id)
+            continue;
+
+        auto& loaded = result.emplace_back();
+        loaded.Info = block;
+        loaded.Data = std::make_unique<uint8_t[]>(block.Length);
+        _stream->SetPosition(_start + block.Offset);
+        _stream->Read(loaded.Data.get(), block.Length);
+    }
+    _stream->SetPosition(_end);
+
+    if (result.empty())
+    {
+        throw IOException("Park file is missing a chunk.");
+    }
+    return result;
+}
+
+ParkFileReader::PendingChunk ParkFileReader::LoadChunk(uint32_t id, void* dst, size_t length)
+{
+    PendingChunk chunk;
+    chunk.Destination = static_cast<uint8_t*>(dst);
+    chunk.DestinationLength = length;
+    if (!HasBlocks(id) && HasBlocks(id | PARK_FILE_DELTA_CHUNK))
+    {
+        if (_base == nullptr)
+        {
+            throw IOException("Park file is a delta, but its base is not loaded.");
+        }
+        chunk.Blocks = _base->LoadBlocks(id);
+        chunk.DeltaBlocks = LoadBlocks(id | PARK_FILE_DELTA_CHUNK);
+    }
+    else
+    {
+        chunk.Blocks = LoadBlocks(id);
+    }
+    return chunk;
+}
+
+size_t ParkFileReader::GetChunkLength(const std::vector<LoadedBlock>& blocks)
+{
+    size_t length = 0;
+    for (const auto& block : blocks)
+    {
+        length = std::max<size_t>(length, static_cast<size_t>(block.Info.ChunkOffset) + block.Info.UncompressedLength);
+    }
+    return length;
+}
+
+void ParkFileReader::DecodeChunks(std::vector<PendingChunk>& chunks)
+{
+    std::vector<std::tuple<const LoadedBlock*, uint8_t*, size_t>> blocks;
+    for (auto& chunk : chunks)
+    {
+        // Decompress straight into the destination unless the chunk has to be truncated or patched
+        size_t length = GetChunkLength(chunk.Blocks);
+        chunk.DecodeToDestination = chunk.Destination != nullptr && chunk.DeltaBlocks.empty()
+            && length <= chunk.DestinationLength;
+        uint8_t* target = chunk.Destination;
+        if (!chunk.DecodeToDestination)
+        {
+            chunk.Data.resize(length);
+            target = chunk.Data.data();
+        }
+        for (const auto& block : chunk.Blocks)
+        {
+            blocks.emplace_back(&block, target, length);
+        }
+
+        chunk.Delta.resize(GetChunkLength(chunk.DeltaBlocks));
+        for (const auto& block : chunk.DeltaBlocks)
+        {
+            blocks.emplace_back(&block, chunk.Delta.data(), chunk.Delta.size());
+        }
+    }
+
+    Parallel::For(blocks.size(), [&blocks](size_t i) {
+        auto [block, target, length] = blocks[i];
+        DecompressBlock(*block, target, length);
+    });
+
+    for (auto& chunk : chunks)
+    {
+        if (!chunk.DeltaBlocks.empty())
+        {
+            ApplyDelta(chunk.Data, chunk.Delta);
+        }
+        if (chunk.Destination == nullptr)
+            continue;
+
+        size_t length = chunk.DecodeToDestination ? GetChunkLength(chunk.Blocks) : chunk.Data.size();
+        if (!chunk.DecodeToDestination)
+        {
+            std::memcpy(chunk.Destination, chunk.Data.data(), std::min(length, chunk.DestinationLength));
+        }
+        if (length < chunk.DestinationLength)
+        {
+            std::fill_n(chunk.Destination + length, chunk.DestinationLength - length, 0x00);
+        }
+    }
+}
+
+void ParkFileReader::DecompressBlock(const LoadedBlock& block, uint8_t* chunkData, size_t chunkLength)
+{
+    const auto& info = block.Info;
+    if (static_cast<size_t>(info.ChunkOffset) + info.UncompressedLength > chunkLength)
+    {
+        throw IOException("Corrupt park file.");
+    }
+
+    uint8_t* dst = chunkData + info.ChunkOffset;
+    if (info.Compression == ParkFileCompression::None)
+    {
+        if (info.Length != info.UncompressedLength)
+        {
+            throw IOException("Corrupt park file.");
+        }
+        std::memcpy(dst, block.Data.get(), info.Length);
+    }
+    else
+    {
+        uLongf length = info.UncompressedLength;
+        if (uncompress(dst, &length, block.Data.get(), info.Length) != Z_OK || length != info.UncompressedLength)
+        {
+            throw IOException("Corrupt park file.");
+        }
+    }
+
+    if (crc32(0, dst, info.UncompressedLength) != info.Checksum)
+    {
+        throw IOException("Park file checksum mismatch.");
+    }
+}
+
+void ParkFileReader::ApplyDelta(std::vector<uint8_t>& data, const std::vector<uint8_t>& delta)
+{
+    size_t position = 0;
+    auto read = [&delta, &position]() {
+        if (position + sizeof(uint32_t) > delta.size())
+        {
+            throw IOException("Corrupt park file.");
+        }
+        uint32_t value;
+        std::memcpy(&value, delta.data() + position, sizeof(value));
+        position += sizeof(value);
+        return value;
+    };
+
+    uint32_t baseChecksum = read();
+    if (crc32(0, data.data(), static_cast<uInt>(data.size())) != baseChecksum)
+    {
+        throw IOException("Park file does not match its base.");
+    }
+    data.resize(read());
+
+    while (position < delta.size())
+    {
+        size_t offset = read();
+        size_t length = read();
+        if (offset + length > data.size() || position + length > delta.size())
+        {
+            throw IOException("Corrupt park file.");
+        }
+        std::memcpy(data.data() + offset, delta.data() + position, length);
+        position += length;
+    }
+}
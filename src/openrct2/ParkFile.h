@@ -0,0 +1,175 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "common.h"
+
+#include <future>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace OpenRCT2
+{
+    struct IStream;
+
+    /**
+     * How the blocks of a park file are compressed.
+     */
+    enum class ParkFileCompression : uint8_t
+    {
+        None,
+        Fast,  // Deflate at its fastest level, used for autosaves and network maps
+        Small, // Deflate at its best level
+    };
+
+    /**
+     * Builds a park file, OpenRCT2's own container for park data. The file starts with a table of every block, so
+     * chunks can be found without reading the ones in front of them. Chunks are split into blocks that are compressed
+     * and checksummed on their own, so they can be compressed and decompressed in parallel.
+     *
+     * A park file can also be saved as a delta, which only stores the parts of each chunk that differ from another
+     * park file, its base.
+     */
+    class ParkFileWriter final
+    {
+    public:
+        /**
+         * Adds a chunk, the data is copied.
+         */
+        void AddChunk(uint32_t id, const void* data, size_t length);
+
+        /**
+         * Compresses the chunks on background threads and writes each block to the stream as soon as it and the ones
+         * in front of it are ready.
+         */
+        void Save(IStream* stream, ParkFileCompression compression) const;
+
+        /**
+         * Saves the park file as a delta against base, which has to be saved as a whole to basePath. Chunks that are
+         * small or not in base are stored as a whole, so they can be read without the base.
+         * @param basePath The path of the base, relative to the directory of the delta.
+         * @return The number of bytes the delta holds before compression.
+         */
+        size_t SaveDelta(
+            IStream* stream, const ParkFileWriter& base, const std::string& basePath, ParkFileCompression compression) const;
+
+        /**
+         * Gets the combined length of all chunks.
+         */
+        size_t GetLength() const;
+
+    private:
+        struct Chunk
+        {
+            uint32_t Id;
+            std::vector<uint8_t> Data;
+        };
+
+        std::vector<Chunk> _chunks;
+    };
+
+    /**
+     * Reads chunks from a park file, see ParkFileWriter. The base of a delta has to be given to SetBase before any
+     * chunk that is stored as changes to the base can be read.
+     */
+    class ParkFileReader final
+    {
+    public:
+        /**
+         * Reads the block table, the stream is left at the end of the park file.
+         */
+        explicit ParkFileReader(IStream* stream);
+
+        /**
+         * Checks whether the stream continues with a park file, without moving it.
+         */
+        static bool IsParkFile(IStream* stream);
+
+        bool HasChunk(uint32_t id) const;
+
+        /**
+         * Checks whether the park file is a delta, see ParkFileWriter::SaveDelta.
+         */
+        bool IsDelta() const;
+
+        /**
+         * Gets the path of the base of a delta, relative to the directory of the delta.
+         */
+        std::string GetBasePath();
+
+        /**
+         * Reads the block table of the base of this delta, the stream has to stay open until the chunks are read.
+         */
+        void SetBase(IStream* stream);
+
+        /**
+         * Reads a chunk and copies it to the destination. If the chunk is larger than length, only length is copied.
+         * If the chunk is smaller than length, the remaining space is padded with zero.
+         */
+        void ReadChunk(uint32_t id, void* dst, size_t length);
+
+        /**
+         * Reads a chunk as a whole.
+         */
+        std::vector<uint8_t> ReadChunk(uint32_t id);
+
+        /**
+         * Reads the blocks of several chunks and decompresses them on background threads, each chunk is copied to its
+         * destination as ReadChunk(id, dst, length) does.
+         * @return A future that is ready once every chunk is copied, it rethrows the first error.
+         */
+        std::future<void> ReadChunksAsync(const std::vector<std::tuple<uint32_t, void*, size_t>>& chunks);
+
+    private:
+        struct Block
+        {
+            uint32_t ChunkId;
+            ParkFileCompression Compression;
+            uint64_t Offset;
+            uint32_t Length;
+            uint32_t ChunkOffset;
+            uint32_t UncompressedLength;
+            uint32_t Checksum;
+        };
+
+        struct LoadedBlock
+        {
+            Block Info;
+            std::unique_ptr<uint8_t[]> Data;
+        };
+
+        struct PendingChunk
+        {
+            std::vector<LoadedBlock> Blocks; // The base chunk if the chunk is stored as a delta
+            std::vector<LoadedBlock> DeltaBlocks;
+            uint8_t* Destination{};
+            size_t DestinationLength{};
+            bool DecodeToDestination{};
+            std::vector<uint8_t> Data;
+            std::vector<uint8_t> Delta;
+        };
+
+        IStream* const _stream;
+        uint64_t _start;
+        uint64_t _end{};
+        std::vector<Block> _blocks;
+        std::unique_ptr<ParkFileReader> _base;
+
+        bool HasBlocks(uint32_t id) const;
+        std::vector<LoadedBlock> LoadBlocks(uint32_t id);
+        PendingChunk LoadChunk(uint32_t id, void* dst, size_t length);
+        static size_t GetChunkLength(const std::vector<LoadedBlock>& blocks);
+        static void DecodeChunks(std::vector<PendingChunk>& chunks);
+        static void DecompressBlock(const LoadedBlock& block, uint8_t* chunkData, size_t chunkLength);
+        static void ApplyDelta(std::vector<uint8_t>& data, const std::vector<uint8_t>& delta);
+    };
+} // namespace OpenRCT2
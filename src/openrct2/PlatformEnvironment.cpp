@@ -51,6 +51,7 @@ public:
             case DIRBASE::OPENRCT2:
             case DIRBASE::USER:
             case DIRBASE::CONFIG:
+            case DIRBASE::CACHE:
                 directoryName = DirectoryNamesOpenRCT2[static_cast<size_t>(did)];
                 break;
         }
@@ -86,6 +87,7 @@ private:
             case PATHID::CACHE_OBJECTS:
             case PATHID::CACHE_TRACKS:
             case PATHID::CACHE_SCENARIOS:
+            case PATHID::CACHE_OBJECTS_TABLE:
                 return DIRBASE::CACHE;
             case PATHID::MP_DAT:
                 return DIRBASE::RCT1;
@@ -236,6 +238,7 @@ const char * PlatformEnvironment::FileNames[] =
     "objects.idx",          // CACHE_OBJECTS
     "tracks.idx",           // CACHE_TRACKS
     "scenarios.idx",        // CACHE_SCENARIOS
+    "objects.idxmap",       // CACHE_OBJECTS_TABLE
     "Data" PATH_SEPARATOR "mp.dat", // MP_DAT
     "groups.json",          // NETWORK_GROUPS
     "servers.cfg",          // NETWORK_SERVERS
@@ -53,20 +53,21 @@ namespace OpenRCT2
 
     enum class PATHID
     {
-        CONFIG,          // Main configuration (config.ini).
-        CONFIG_KEYBOARD, // Keyboard shortcuts. (hotkeys.cfg)
-        CACHE_OBJECTS,   // Object repository cache (objects.idx).
-        CACHE_TRACKS,    // Track repository cache (tracks.idx).
-        CACHE_SCENARIOS, // Scenario repository cache (scenarios.idx).
-        MP_DAT,          // Mega Park data, Steam RCT1 only (\RCTdeluxe_install\Data\mp.dat)
-        NETWORK_GROUPS,  // Server groups with permissions (groups.json).
-        NETWORK_SERVERS, // Saved servers (servers.cfg).
-        NETWORK_USERS,   // Users and their groups (users.json).
-        SCORES,          // Scenario scores (highscores.dat).
-        SCORES_LEGACY,   // Scenario scores, legacy (scores.dat).
-        SCORES_RCT2,     // Scenario scores, rct2 (\Saved Games\scores.dat).
-        CHANGELOG,       // Notable changes to the game between versions, distributed with the game.
-        PLUGIN_STORE,    // Shared storage for plugins.
+        CONFIG,              // Main configuration (config.ini).
+        CONFIG_KEYBOARD,     // Keyboard shortcuts. (hotkeys.cfg)
+        CACHE_OBJECTS,       // Object repository cache (objects.idx).
+        CACHE_TRACKS,        // Track repository cache (tracks.idx).
+        CACHE_SCENARIOS,     // Scenario repository cache (scenarios.idx).
+        CACHE_OBJECTS_TABLE, // Memory mapped object repository table (objects.idxmap).
+        MP_DAT,              // Mega Park data, Steam RCT1 only (\RCTdeluxe_install\Data\mp.dat)
+        NETWORK_GROUPS,      // Server groups with permissions (groups.json).
+        NETWORK_SERVERS,     // Saved servers (servers.cfg).
+        NETWORK_USERS,       // Users and their groups (users.json).
+        SCORES,              // Scenario scores (highscores.dat).
+        SCORES_LEGACY,       // Scenario scores, legacy (scores.dat).
+        SCORES_RCT2,         // Scenario scores, rct2 (\Saved Games\scores.dat).
+        CHANGELOG,           // Notable changes to the game between versions, distributed with the game.
+        PLUGIN_STORE,        // Shared storage for plugins.
     };
 
     /**
@@ -502,6 +502,23 @@ namespace OpenRCT2
             return true;
         }
 
+        virtual bool ReadGameActions(
+            const std::string& file, const std::function<void(uint32_t tick, GameAction& action)>& callback) override
+        {
+            ReplayRecordData data;
+            if (!ReadReplayData(file, data))
+            {
+                log_error("Unable to read replay '%s'", file.c_str());
+                return false;
+            }
+
+            for (const auto& command : data.commands)
+            {
+                callback(command.tick - data.tickStart, *command.action);
+            }
+            return true;
+        }
+
     private:
         int ChecksumTicksDelta() const
         {
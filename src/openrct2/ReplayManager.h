@@ -11,6 +11,7 @@
 
 #include "common.h"
 
+#include <functional>
 #include <memory>
 #include <set>
 #include <string>
@@ -63,6 +64,13 @@ namespace OpenRCT2
         virtual bool StopPlayback() = 0;
 
         virtual bool NormaliseReplay(const std::string& inputFile, const std::string& outputFile) = 0;
+
+        /**
+         * Reads the game actions recorded in a replay without playing it, ticks are relative to the start of the replay.
+         */
+        virtual bool ReadGameActions(
+            const std::string& file, const std::function<void(uint32_t tick, GameAction& action)>& callback)
+            = 0;
     };
 
     std::unique_ptr<IReplayManager> CreateReplayManager();
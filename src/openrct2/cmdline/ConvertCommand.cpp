@@ -66,6 +66,7 @@ exitcode_t CommandLine::HandleCommandConvert(CommandLineArgEnumerator* enumerato
     {
         case FILE_EXTENSION_SC4:
         case FILE_EXTENSION_SV4:
+        case FILE_EXTENSION_PARK:
             break;
         case FILE_EXTENSION_SC6:
             if (destinationFileType == FILE_EXTENSION_SC6)
@@ -82,7 +83,7 @@ exitcode_t CommandLine::HandleCommandConvert(CommandLineArgEnumerator* enumerato
             }
             break;
         default:
-            Console::Error::WriteLine("Only conversion from .SC4, .SV4, .SC6 or .SV6 is supported.");
+            Console::Error::WriteLine("Only conversion from .SC4, .SV4, .SC6, .SV6 or .PARK is supported.");
             return EXITCODE_FAIL;
     }
 
@@ -157,6 +158,8 @@ static const utf8* GetFileTypeFriendlyName(uint32_t fileType)
             return "RollerCoaster Tycoon 2 scenario";
         case FILE_EXTENSION_SV6:
             return "RollerCoaster Tycoon 2 saved game";
+        case FILE_EXTENSION_PARK:
+            return "OpenRCT2 park file";
     }
 
     assert(false);
@@ -0,0 +1,547 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "../core/Console.hpp"
+#include "CommandLine.hpp"
+
+#ifndef DISABLE_NETWORK
+
+#    include "../Context.h"
+#    include "../Game.h"
+#    include "../GameState.h"
+#    include "../OpenRCT2.h"
+#    include "../ReplayManager.h"
+#    include "../actions/GameAction.h"
+#    include "../actions/ParkSetNameAction.hpp"
+#    include "../core/DataSerialiser.h"
+#    include "../network/NetworkKey.h"
+#    include "../network/NetworkPacket.h"
+#    include "../network/Socket.h"
+#    include "../network/network.h"
+#    include "../platform/platform.h"
+
+#    include <algorithm>
+#    include <atomic>
+#    include <chrono>
+#    include <cstring>
+#    include <memory>
+#    include <numeric>
+#    include <string>
+#    include <thread>
+#    include <vector>
+
+using namespace OpenRCT2;
+
+using BenchClock = std::chrono::steady_clock;
+
+static int32_t _numClients = 8;
+static int32_t _actionsPerSecond = 1;
+static int32_t _duration = 60;
+static int32_t _benchPort = 11760;
+static utf8* _replayPath = nullptr;
+
+// clang-format off
+static constexpr const CommandLineOptionDefinition NetBenchOptions[]
+{
+    { CMDLINE_TYPE_INTEGER, &_numClients,       NAC, "clients",         "number of simulated clients (default 8)"     },
+    { CMDLINE_TYPE_INTEGER, &_actionsPerSecond, NAC, "actions-per-sec", "actions per client per second (default 1)"   },
+    { CMDLINE_TYPE_INTEGER, &_duration,         NAC, "duration",        "seconds to run for (default 60)"             },
+    { CMDLINE_TYPE_INTEGER, &_benchPort,        NAC, "port",            "loopback port of the server (default 11760)" },
+    { CMDLINE_TYPE_STRING,  &_replayPath,       NAC, "replay",          "replay to take the game actions from"        },
+    OptionTableEnd
+};
+// clang-format on
+
+static exitcode_t HandleNetBench(CommandLineArgEnumerator* argEnumerator);
+
+const CommandLineCommand CommandLine::NetBenchCommands[]{
+    // Main commands
+    DefineCommand("", "<park> [options]", NetBenchOptions, HandleNetBench), CommandTableEnd
+};
+
+namespace
+{
+    struct BenchAction
+    {
+        uint32_t Type;
+        std::vector<uint8_t> Data;
+    };
+
+    /**
+     * A client that speaks just enough of the protocol to join and send game actions, it does not run the game. All
+     * clients are updated from one thread, packets are framed here so nothing is shared with the server's connections.
+     */
+    class SimulatedClient
+    {
+    public:
+        enum class State
+        {
+            Connecting,
+            Joining,
+            Joined,
+            Disconnected,
+        };
+
+        State CurrentState = State::Connecting;
+        std::string Name;
+        std::chrono::milliseconds JoinTime{};
+        uint64_t ActionsSent = 0;
+        uint64_t BytesReceived = 0;
+
+        SimulatedClient(std::string name, const std::vector<BenchAction>& actions, size_t firstAction)
+            : Name(std::move(name))
+            , _actions(actions)
+            , _nextAction(firstAction)
+        {
+        }
+
+        bool Start(uint16_t port)
+        {
+            if (!_key.Generate())
+            {
+                Console::Error::WriteLine("Unable to generate a key for %s.", Name.c_str());
+                return false;
+            }
+            _startTime = BenchClock::now();
+            _socket = CreateTcpSocket();
+            _socket->ConnectAsync("127.0.0.1", port);
+            return true;
+        }
+
+        void Update(BenchClock::time_point now, std::chrono::microseconds actionInterval)
+        {
+            if (CurrentState == State::Disconnected)
+                return;
+
+            if (CurrentState == State::Connecting)
+            {
+                auto status = _socket->GetStatus();
+                if (status == SocketStatus::Connected)
+                {
+                    Send(NetworkPacket(NetworkCommand::Token));
+                    CurrentState = State::Joining;
+                }
+                else if (status == SocketStatus::Closed)
+                {
+                    Disconnect("unable to connect");
+                }
+                return;
+            }
+
+            Receive();
+
+            // An interval of zero means the client only joins and keeps up with the server
+            if (CurrentState == State::Joined && !_actions.empty() && actionInterval.count() > 0)
+            {
+                while (now >= _nextActionTime)
+                {
+                    const auto& action = _actions[_nextAction];
+                    _nextAction = (_nextAction + 1) % _actions.size();
+
+                    NetworkPacket packet(NetworkCommand::GameAction);
+                    packet << _serverTick << action.Type;
+                    packet.Write(action.Data.data(), action.Data.size());
+                    Send(packet);
+
+                    ActionsSent++;
+                    _nextActionTime += actionInterval;
+                }
+            }
+
+            Flush();
+        }
+
+        void Close()
+        {
+            if (_socket != nullptr)
+            {
+                _socket->Close();
+            }
+        }
+
+    private:
+        const std::vector<BenchAction>& _actions;
+        size_t _nextAction;
+        std::unique_ptr<ITcpSocket> _socket;
+        NetworkKey _key;
+        BenchClock::time_point _startTime;
+        BenchClock::time_point _nextActionTime;
+        std::vector<uint8_t> _inbound;
+        std::vector<uint8_t> _outbound;
+        uint32_t _serverTick = 0;
+
+        void Disconnect(const char* reason)
+        {
+            Console::Error::WriteLine("%s disconnected: %s", Name.c_str(), reason);
+            CurrentState = State::Disconnected;
+            _socket->Close();
+        }
+
+        void Send(const NetworkPacket& packet)
+        {
+            // Same layout as NetworkPacket::Encode, which is not used as it updates statistics of the server thread.
+            PacketHeader header;
+            header.Size = Convert::HostToNetwork(static_cast<uint16_t>(packet.Data.size() + sizeof(header.Id)));
+            header.Id = ByteSwapBE(packet.GetCommand());
+            auto headerBytes = reinterpret_cast<const uint8_t*>(&header);
+            _outbound.insert(_outbound.end(), headerBytes, headerBytes + sizeof(header));
+            _outbound.insert(_outbound.end(), packet.Data.begin(), packet.Data.end());
+        }
+
+        void Flush()
+        {
+            if (_outbound.empty())
+                return;
+
+            size_t sent = _socket->SendData(_outbound.data(), _outbound.size());
+            _outbound.erase(_outbound.begin(), _outbound.begin() + sent);
+        }
+
+        void Receive()
+        {
+            uint8_t buffer[8192];
+            for (;;)
+            {
+                size_t received = 0;
+                auto status = _socket->ReceiveData(buffer, sizeof(buffer), &received);
+                if (status == NetworkReadPacket::Disconnected)
+                {
+                    Disconnect("connection closed by server");
+                    return;
+                }
+                if (status != NetworkReadPacket::Success || received == 0)
+                    break;
+
+                BytesReceived += received;
+                _inbound.insert(_inbound.end(), buffer, buffer + received);
+            }
+
+            size_t offset = 0;
+            while (_inbound.size() - offset >= sizeof(PacketHeader) && CurrentState != State::Disconnected)
+            {
+                PacketHeader header;
+                std::memcpy(&header, &_inbound[offset], sizeof(header));
+                size_t size = Convert::NetworkToHost(header.Size) - sizeof(header.Id);
+                if (_inbound.size() - offset - sizeof(header) < size)
+                    break;
+
+                NetworkPacket packet(ByteSwapBE(header.Id));
+                auto data = _inbound.begin() + offset + sizeof(header);
+                packet.Data.assign(data, data + size);
+                packet.Header.Size = static_cast<uint16_t>(size);
+                offset += sizeof(header) + size;
+
+                HandlePacket(packet);
+            }
+            _inbound.erase(_inbound.begin(), _inbound.begin() + offset);
+        }
+
+        void HandlePacket(NetworkPacket& packet)
+        {
+            switch (packet.GetCommand())
+            {
+                case NetworkCommand::Token:
+                {
+                    uint32_t challengeSize;
+                    packet >> challengeSize;
+                    const uint8_t* challenge = packet.Read(challengeSize);
+                    std::vector<uint8_t> signature;
+                    if (challenge == nullptr || !_key.Sign(challenge, challengeSize, signature))
+                    {
+                        Disconnect("unable to sign the challenge");
+                        return;
+                    }
+
+                    NetworkPacket auth(NetworkCommand::Auth);
+                    auth.WriteString(network_get_version().c_str());
+                    auth.WriteString(Name.c_str());
+                    auth.WriteString("");
+                    auth.WriteString(_key.PublicKeyString().c_str());
+                    auth << static_cast<uint32_t>(signature.size());
+                    auth.Write(signature.data(), signature.size());
+                    Send(auth);
+                    break;
+                }
+                case NetworkCommand::Auth:
+                {
+                    uint32_t authStatus;
+                    packet >> authStatus;
+                    if (static_cast<NetworkAuth>(authStatus) != NetworkAuth::Ok)
+                    {
+                        Disconnect("authentication failed");
+                    }
+                    break;
+                }
+                case NetworkCommand::ObjectsList:
+                {
+                    // The server has to have every object the park needs, so none are requested
+                    uint32_t index;
+                    uint32_t totalObjects;
+                    packet >> index >> totalObjects;
+                    if (index + 1 >= totalObjects)
+                    {
+                        NetworkPacket mapRequest(NetworkCommand::MapRequest);
+                        mapRequest << uint32_t{ 0 };
+                        Send(mapRequest);
+                    }
+                    break;
+                }
+                case NetworkCommand::Map:
+                {
+                    uint32_t size;
+                    uint32_t offset;
+                    uint32_t frameSize;
+                    packet >> size >> offset >> frameSize;
+                    if (CurrentState == State::Joining && offset + frameSize >= size)
+                    {
+                        auto now = BenchClock::now();
+                        JoinTime = std::chrono::duration_cast<std::chrono::milliseconds>(now - _startTime);
+                        CurrentState = State::Joined;
+                        _nextActionTime = now;
+                    }
+                    break;
+                }
+                case NetworkCommand::Tick:
+                    packet >> _serverTick;
+                    break;
+                case NetworkCommand::Ping:
+                {
+                    NetworkPacket ping(NetworkCommand::Ping);
+                    ping << _serverTick;
+                    Send(ping);
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    };
+} // namespace
+
+static std::vector<BenchAction> LoadBenchActions(IContext& context)
+{
+    std::vector<BenchAction> actions;
+    auto addAction = [&actions]([[maybe_unused]] uint32_t tick, GameAction& action) {
+        DataSerialiser ds(true);
+        action.Serialise(ds);
+        const auto& stream = ds.GetStream();
+        const auto* data = static_cast<const uint8_t*>(stream.GetData());
+        actions.push_back({ action.GetType(), std::vector<uint8_t>(data, data + stream.GetLength()) });
+    };
+
+    if (_replayPath != nullptr)
+    {
+        context.GetReplayManager()->ReadGameActions(_replayPath, addAction);
+    }
+    else
+    {
+        auto action = ParkSetNameAction("Network Benchmark");
+        addAction(0, action);
+    }
+    return actions;
+}
+
+// Joining players start in a group that can not build, move the simulated clients to one that can run every action.
+static void AssignBenchGroup(const std::vector<BenchAction>& actions)
+{
+    int32_t benchGroup = -1;
+    for (int32_t i = 0; i < network_get_num_groups() && benchGroup == -1; i++)
+    {
+        bool canPerformAll = std::all_of(actions.begin(), actions.end(), [i](const BenchAction& action) {
+            return network_can_perform_command(i, action.Type) != 0;
+        });
+        if (canPerformAll)
+        {
+            benchGroup = i;
+        }
+    }
+    if (benchGroup == -1)
+        return;
+
+    for (int32_t i = 0; i < network_get_num_players(); i++)
+    {
+        if (!(network_get_player_flags(i) & NETWORK_PLAYER_FLAG_ISSERVER)
+            && network_get_player_group(i) != network_get_group_id(benchGroup))
+        {
+            network_set_player_group(i, benchGroup);
+        }
+    }
+}
+
+static uint32_t GetPercentile(const std::vector<uint32_t>& sortedValues, size_t percentile)
+{
+    return sortedValues.empty() ? 0 : sortedValues[(sortedValues.size() - 1) * percentile / 100];
+}
+
+static exitcode_t HandleNetBench(CommandLineArgEnumerator* argEnumerator)
+{
+    const char* parkPath;
+    if (!argEnumerator->TryPopString(&parkPath))
+    {
+        Console::Error::WriteLine("Expected a park to host.");
+        return EXITCODE_FAIL;
+    }
+    if (_numClients <= 0 || _actionsPerSecond < 0 || _duration <= 0)
+    {
+        Console::Error::WriteLine("Invalid number of clients, actions per second or duration.");
+        return EXITCODE_FAIL;
+    }
+
+    core_init();
+    gOpenRCT2Headless = true;
+
+    std::unique_ptr<IContext> context(CreateContext());
+    if (!context->Initialise())
+    {
+        Console::Error::WriteLine("Context initialization failed.");
+        return EXITCODE_FAIL;
+    }
+    if (!context->LoadParkFromFile(parkPath))
+    {
+        return EXITCODE_FAIL;
+    }
+
+    auto actions = LoadBenchActions(*context);
+    if (actions.empty())
+    {
+        Console::Error::WriteLine("No game actions to send.");
+        return EXITCODE_FAIL;
+    }
+
+    if (!network_begin_server(_benchPort, "127.0.0.1"))
+    {
+        Console::Error::WriteLine("Unable to start the server on port %d.", _benchPort);
+        return EXITCODE_FAIL;
+    }
+
+    std::vector<std::unique_ptr<SimulatedClient>> clients;
+    for (int32_t i = 0; i < _numClients; i++)
+    {
+        // Spread the clients over the action stream so they do not all send the same action at once
+        clients.push_back(std::make_unique<SimulatedClient>(
+            "NetBench" + std::to_string(i + 1), actions, i * actions.size() / _numClients));
+    }
+
+    Console::WriteLine(
+        "Running %d clients sending %d actions per second each for %d seconds...", _numClients, _actionsPerSecond, _duration);
+
+    std::atomic<bool> stopClients = false;
+    std::thread clientThread([&clients, &stopClients]() {
+        for (auto& client : clients)
+        {
+            if (!client->Start(static_cast<uint16_t>(_benchPort)))
+            {
+                client->CurrentState = SimulatedClient::State::Disconnected;
+            }
+        }
+
+        // No actions are sent at a rate of zero, the clients only join
+        auto actionInterval = std::chrono::microseconds::zero();
+        if (_actionsPerSecond > 0)
+        {
+            actionInterval = std::chrono::microseconds(std::max(1000000 / _actionsPerSecond, 1));
+        }
+        while (!stopClients)
+        {
+            auto now = BenchClock::now();
+            for (auto& client : clients)
+            {
+                client->Update(now, actionInterval);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        for (auto& client : clients)
+        {
+            client->Close();
+        }
+    });
+
+    // Runs the server at its normal tick rate, a tick that takes longer than that delays the following ones.
+    auto* gameState = context->GetGameState();
+    const auto tickInterval = std::chrono::milliseconds(GAME_UPDATE_TIME_MS);
+    auto startTime = BenchClock::now();
+    auto endTime = startTime + std::chrono::seconds(_duration);
+    auto nextTick = startTime;
+    std::vector<uint32_t> tickTimes;
+    uint32_t lateTicks = 0;
+    for (auto now = startTime; now < endTime; now = BenchClock::now())
+    {
+        if (now < nextTick)
+        {
+            auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(nextTick - now);
+            network_wait(static_cast<uint32_t>(std::max<int64_t>(timeout.count(), 1)));
+            continue;
+        }
+
+        gameState->UpdateLogic();
+        auto tickEnd = BenchClock::now();
+        auto tickTime = std::chrono::duration_cast<std::chrono::microseconds>(tickEnd - now);
+        tickTimes.push_back(static_cast<uint32_t>(tickTime.count()));
+
+        nextTick += tickInterval;
+        if (nextTick < tickEnd)
+        {
+            lateTicks++;
+            nextTick = tickEnd;
+        }
+        AssignBenchGroup(actions);
+    }
+    auto elapsed = std::chrono::duration<double>(BenchClock::now() - startTime).count();
+    auto stats = network_get_stats();
+
+    stopClients = true;
+    clientThread.join();
+    network_close();
+
+    std::sort(tickTimes.begin(), tickTimes.end());
+    std::vector<uint32_t> joinTimes;
+    uint64_t actionsSent = 0;
+    uint64_t bytesReceived = 0;
+    uint32_t disconnected = 0;
+    for (const auto& client : clients)
+    {
+        if (client->JoinTime.count() != 0)
+            joinTimes.push_back(static_cast<uint32_t>(client->JoinTime.count()));
+        if (client->CurrentState == SimulatedClient::State::Disconnected)
+            disconnected++;
+        actionsSent += client->ActionsSent;
+        bytesReceived += client->BytesReceived;
+    }
+    std::sort(joinTimes.begin(), joinTimes.end());
+
+    const auto totalSent = stats.bytesSent[EnumValue(NetworkStatisticsGroup::Total)];
+    const auto totalReceived = stats.bytesReceived[EnumValue(NetworkStatisticsGroup::Total)];
+    Console::WriteLine("Ticks:          %zu in %.1f s, %u behind schedule", tickTimes.size(), elapsed, lateTicks);
+    Console::WriteLine(
+        "Tick time:      p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, max %.2f ms", GetPercentile(tickTimes, 50) / 1000.0,
+        GetPercentile(tickTimes, 95) / 1000.0, GetPercentile(tickTimes, 99) / 1000.0, GetPercentile(tickTimes, 100) / 1000.0);
+    Console::WriteLine("Joined:         %zu of %d clients, %u disconnected", joinTimes.size(), _numClients, disconnected);
+    Console::WriteLine("Join time:      p50 %u ms, max %u ms", GetPercentile(joinTimes, 50), GetPercentile(joinTimes, 100));
+    Console::WriteLine("Game actions:   %llu sent by clients", static_cast<unsigned long long>(actionsSent));
+    Console::WriteLine(
+        "Server traffic: %.1f KiB/s sent, %.1f KiB/s received, %.1f KiB/s per client", totalSent / elapsed / 1024.0,
+        totalReceived / elapsed / 1024.0, bytesReceived / elapsed / 1024.0 / _numClients);
+
+    return disconnected == 0 ? EXITCODE_OK : EXITCODE_FAIL;
+}
+
+#else
+
+static exitcode_t HandleNetBench(CommandLineArgEnumerator* argEnumerator)
+{
+    Console::Error::WriteLine("Sorry, networking is not enabled in this build.");
+    return EXITCODE_FAIL;
+}
+
+const CommandLineCommand CommandLine::NetBenchCommands[]{
+    // Main commands
+    DefineCommand("", "*** SORRY NOT ENABLED IN THIS BUILD ***", nullptr, HandleNetBench), CommandTableEnd
+};
+
+#endif // DISABLE_NETWORK
@@ -143,6 +143,7 @@ namespace Config
             model->always_show_gridlines = reader->GetBoolean("always_show_gridlines", false);
             model->autosave_frequency = reader->GetInt32("autosave", AUTOSAVE_EVERY_5MINUTES);
             model->autosave_amount = reader->GetInt32("autosave_amount", DEFAULT_NUM_AUTOSAVES_TO_KEEP);
+            model->autosave_incremental = reader->GetBoolean("autosave_incremental", false);
             model->confirmation_prompt = reader->GetBoolean("confirmation_prompt", false);
             model->currency_format = reader->GetEnum<int32_t>("currency_format", platform_get_locale_currency(), Enum_Currency);
             model->custom_currency_rate = reader->GetInt32("custom_currency_rate", 10);
@@ -199,6 +200,8 @@ namespace Config
                 "scale_quality", ScaleQuality::SmoothNearestNeighbour, Enum_ScaleQuality);
             model->show_fps = reader->GetBoolean("show_fps", false);
             model->multithreading = reader->GetBoolean("multi_threading", false);
+            model->load_object_images_on_demand = reader->GetBoolean("load_object_images_on_demand", true);
+            model->object_image_cache_size = reader->GetInt32("object_image_cache_size", 128);
             model->trap_cursor = reader->GetBoolean("trap_cursor", false);
             model->auto_open_shops = reader->GetBoolean("auto_open_shops", false);
             model->scenario_select_mode = reader->GetInt32("scenario_select_mode", SCENARIO_SELECT_MODE_ORIGIN);
@@ -228,6 +231,7 @@ namespace Config
         writer->WriteBoolean("always_show_gridlines", model->always_show_gridlines);
         writer->WriteInt32("autosave", model->autosave_frequency);
         writer->WriteInt32("autosave_amount", model->autosave_amount);
+        writer->WriteBoolean("autosave_incremental", model->autosave_incremental);
         writer->WriteBoolean("confirmation_prompt", model->confirmation_prompt);
         writer->WriteEnum<int32_t>("currency_format", model->currency_format, Enum_Currency);
         writer->WriteInt32("custom_currency_rate", model->custom_currency_rate);
@@ -274,6 +278,8 @@ namespace Config
         writer->WriteEnum<ScaleQuality>("scale_quality", model->scale_quality, Enum_ScaleQuality);
         writer->WriteBoolean("show_fps", model->show_fps);
         writer->WriteBoolean("multi_threading", model->multithreading);
+        writer->WriteBoolean("load_object_images_on_demand", model->load_object_images_on_demand);
+        writer->WriteInt32("object_image_cache_size", model->object_image_cache_size);
         writer->WriteBoolean("trap_cursor", model->trap_cursor);
         writer->WriteBoolean("auto_open_shops", model->auto_open_shops);
         writer->WriteInt32("scenario_select_mode", model->scenario_select_mode);
@@ -407,6 +413,8 @@ namespace Config
             model->log_server_actions = reader->GetBoolean("log_server_actions", false);
             model->pause_server_if_no_clients = reader->GetBoolean("pause_server_if_no_clients", false);
             model->desync_debugging = reader->GetBoolean("desync_debugging", false);
+            model->metrics_file = reader->GetString("metrics_file", "");
+            model->metrics_interval = reader->GetInt32("metrics_interval", 10);
         }
     }
 
@@ -434,6 +442,8 @@ namespace Config
         writer->WriteBoolean("log_server_actions", model->log_server_actions);
         writer->WriteBoolean("pause_server_if_no_clients", model->pause_server_if_no_clients);
         writer->WriteBoolean("desync_debugging", model->desync_debugging);
+        writer->WriteString("metrics_file", model->metrics_file);
+        writer->WriteInt32("metrics_interval", model->metrics_interval);
     }
 
     static void ReadNotifications(IIniReader* reader)
@@ -882,7 +892,7 @@ bool RCT1DataPresentAtLocation(const utf8* path)
     return Csg1datPresentAtLocation(path) && Csg1idatPresentAtLocation(path) && CsgAtLocationIsUsable(path);
 }
 
-bool CsgIsUsable(rct_gx csg)
+bool CsgIsUsable(const rct_gx& csg)
 {
     return csg.header.num_entries == RCT1_NUM_LL_CSG_ENTRIES;
 }
@@ -41,6 +41,8 @@ struct GeneralConfiguration
     bool use_vsync;
     bool show_fps;
     bool multithreading;
+    bool load_object_images_on_demand;
+    int32_t object_image_cache_size; // In MiB, 0 for no limit
     bool minimize_fullscreen_focus_loss;
 
     // Map rendering
@@ -83,6 +85,7 @@ struct GeneralConfiguration
     bool debugging_tools;
     int32_t autosave_frequency;
     int32_t autosave_amount;
+    bool autosave_incremental;
     bool auto_staff_placement;
     bool handymen_mow_default;
     bool auto_open_shops;
@@ -158,6 +161,8 @@ struct NetworkConfiguration
     bool log_server_actions;
     bool pause_server_if_no_clients;
     bool desync_debugging;
+    std::string metrics_file;
+    int32_t metrics_interval;
 };
 
 struct NotificationConfiguration
@@ -254,5 +259,5 @@ std::string FindCsg1datAtLocation(const utf8* path);
 bool Csg1datPresentAtLocation(const utf8* path);
 std::string FindCsg1idatAtLocation(const utf8* path);
 bool Csg1idatPresentAtLocation(const utf8* path);
-bool CsgIsUsable(rct_gx csg);
+bool CsgIsUsable(const rct_gx& csg);
 bool CsgAtLocationIsUsable(const utf8* path);
@@ -19,7 +19,10 @@
 #include "FileStream.hpp"
 #include "String.hpp"
 
+#include <chrono>
 #include <fstream>
+#include <mutex>
+#include <random>
 
 namespace File
 {
@@ -43,6 +46,37 @@ namespace File
         return platform_file_move(srcPath.c_str(), dstPath.c_str());
     }
 
+    std::string GetTemporaryPath(const std::string& path)
+    {
+        static std::mt19937_64 random = []() {
+            // Mixed with the time, random_device can be deterministic on some platforms
+            std::random_device device;
+            auto time = static_cast<uint32_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+            std::seed_seq seed{ device(), device(), time };
+            return std::mt19937_64(seed);
+        }();
+        static std::mutex randomMutex;
+
+        uint64_t suffix;
+        {
+            std::lock_guard<std::mutex> lock(randomMutex);
+            suffix = random();
+        }
+        return String::StdFormat("%s.%016llx.tmp", path.c_str(), static_cast<unsigned long long>(suffix));
+    }
+
+    bool Replace(const std::string& srcPath, const std::string& dstPath)
+    {
+        if (Move(srcPath, dstPath))
+        {
+            return true;
+        }
+
+        // Moving over an existing file fails on some platforms
+        Delete(dstPath);
+        return Move(srcPath, dstPath);
+    }
+
     std::vector<uint8_t> ReadAllBytes(const std::string_view& path)
     {
         std::vector<uint8_t> result;
@@ -26,4 +26,16 @@ namespace File
     void WriteAllBytes(const std::string& path, const void* buffer, size_t length);
     std::vector<std::string> ReadAllLines(const std::string& path);
     uint64_t GetLastModified(const std::string& path);
+
+    /**
+     * Gets a path next to the given one that no other process picks at the same time, to write a file to before it
+     * is moved over the given path with Replace.
+     */
+    std::string GetTemporaryPath(const std::string& path);
+
+    /**
+     * Moves srcPath to dstPath, replacing any file at dstPath. Processes that still have the old file open or mapped
+     * keep reading the old file.
+     */
+    bool Replace(const std::string& srcPath, const std::string& dstPath);
 } // namespace File
@@ -18,14 +18,15 @@
 #include "Path.hpp"
 
 #include <chrono>
-#include <list>
+#include <optional>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 template<typename TItem> class FileIndex
 {
-private:
+public:
     struct DirectoryStats
     {
         uint32_t TotalFiles = 0;
@@ -34,18 +35,36 @@ private:
         uint32_t PathChecksum = 0;
     };
 
+    struct ScannedFile
+    {
+        std::string Path;
+        uint64_t Size = 0;
+        uint64_t LastModified = 0;
+    };
+
     struct ScanResult
     {
         DirectoryStats const Stats;
-        std::vector<std::string> const Files;
+        std::vector<ScannedFile> const Files;
 
-        ScanResult(DirectoryStats stats, std::vector<std::string> files)
+        ScanResult(DirectoryStats stats, std::vector<ScannedFile> files)
             : Stats(stats)
             , Files(files)
         {
         }
     };
 
+private:
+    // A file as it was when the index was written, files that did not produce an item are kept so they are not
+    // indexed again
+    struct CachedFile
+    {
+        uint64_t Size = 0;
+        uint64_t LastModified = 0;
+        std::optional<TItem> Item;
+    };
+    using FileCache = std::unordered_map<std::string, CachedFile>;
+
     struct FileIndexHeader
     {
         uint32_t HeaderSize = sizeof(FileIndexHeader);
@@ -54,11 +73,11 @@ private:
         uint8_t VersionB = 0;
         uint16_t LanguageId = 0;
         DirectoryStats Stats;
-        uint32_t NumItems = 0;
+        uint32_t NumFiles = 0;
     };
 
     // Index file format version which when incremented forces a rebuild
-    static constexpr uint8_t FILE_INDEX_VERSION = 4;
+    static constexpr uint8_t FILE_INDEX_VERSION = 5;
 
     std::string const _name;
     uint32_t const _magicNumber;
@@ -96,54 +115,91 @@ public:
     /**
      * Queries and directories and loads the index header. If the index is up to date,
      * the items are loaded from the index and returned, otherwise the index is rebuilt.
+     * Only files that were added or changed since the index was written are loaded again.
      */
     std::vector<TItem> LoadOrBuild(int32_t language) const
+    {
+        return LoadOrBuild(language, Scan());
+    }
+
+    /**
+     * As above, for files found by an earlier call to Scan.
+     */
+    std::vector<TItem> LoadOrBuild(int32_t language, const ScanResult& scanResult) const
     {
         std::vector<TItem> items;
-        auto scanResult = Scan();
         auto readIndexResult = ReadIndexFile(language, scanResult.Stats);
         if (std::get<0>(readIndexResult))
         {
             // Index was loaded
-            items = std::get<1>(readIndexResult);
+            items = std::move(std::get<1>(readIndexResult));
         }
         else
         {
-            // Index was not loaded
-            items = Build(language, scanResult);
+            // Index was not loaded or is out of date
+            items = Build(language, scanResult, std::move(std::get<2>(readIndexResult)));
         }
         return items;
     }
 
     std::vector<TItem> Rebuild(int32_t language) const
     {
-        auto scanResult = Scan();
-        auto items = Build(language, scanResult);
+        return Rebuild(language, Scan());
+    }
+
+    std::vector<TItem> Rebuild(int32_t language, const ScanResult& scanResult) const
+    {
+        auto items = Build(language, scanResult, {});
         return items;
     }
 
-protected:
     /**
-     * Loads the given file and creates the item representing the data to store in the index.
-     * TODO Use std::optional when C++17 is available.
+     * Scans the directories and gets a checksum of the files found, the index versions and the language. Caches built
+     * from the items can store it to tell whether they are still up to date.
      */
-    virtual std::tuple<bool, TItem> Create(int32_t language, const std::string& path) const abstract;
+    uint64_t GetScanChecksum(int32_t language) const
+    {
+        return GetScanChecksum(language, Scan());
+    }
 
     /**
-     * Serialises an index item to the given stream.
+     * As above, for files found by an earlier call to Scan.
      */
-    virtual void Serialise(OpenRCT2::IStream* stream, const TItem& item) const abstract;
+    uint64_t GetScanChecksum(int32_t language, const ScanResult& scanResult) const
+    {
+        const auto& stats = scanResult.Stats;
+        const uint64_t values[] = {
+            _magicNumber,
+            FILE_INDEX_VERSION,
+            _version,
+            static_cast<uint64_t>(language),
+            stats.TotalFiles,
+            stats.TotalFileSize,
+            stats.FileDateModifiedChecksum,
+            stats.PathChecksum,
+        };
+
+        // FNV-1a
+        uint64_t checksum = 0xCBF29CE484222325;
+        for (auto value : values)
+        {
+            for (int32_t i = 0; i < 8; i++)
+            {
+                checksum ^= (value >> (i * 8)) & 0xFF;
+                checksum *= 0x100000001B3;
+            }
+        }
+        return checksum;
+    }
 
     /**
-     * Deserialises an index item from the given stream.
+     * Scans the directories for files to index, the result can be passed to the functions above so callers that need
+     * more than one of them only scan once.
      */
-    virtual TItem Deserialise(OpenRCT2::IStream* stream) const abstract;
-
-private:
     ScanResult Scan() const
     {
         DirectoryStats stats{};
-        std::vector<std::string> files;
+        std::vector<ScannedFile> files;
         for (const auto& directory : SearchPaths)
         {
             auto absoluteDirectory = Path::GetAbsolute(directory);
@@ -156,7 +212,7 @@ private:
                 auto fileInfo = scanner->GetFileInfo();
                 auto path = std::string(scanner->GetPath());
 
-                files.push_back(path);
+                files.push_back({ path, fileInfo->Size, fileInfo->LastModified });
 
                 stats.TotalFiles++;
                 stats.TotalFileSize += fileInfo->Size;
@@ -170,14 +226,33 @@ private:
         return ScanResult(stats, files);
     }
 
+protected:
+    /**
+     * Loads the given file and creates the item representing the data to store in the index.
+     * TODO Use std::optional when C++17 is available.
+     */
+    virtual std::tuple<bool, TItem> Create(int32_t language, const std::string& path) const abstract;
+
+    /**
+     * Serialises an index item to the given stream.
+     */
+    virtual void Serialise(OpenRCT2::IStream* stream, const TItem& item) const abstract;
+
+    /**
+     * Deserialises an index item from the given stream.
+     */
+    virtual TItem Deserialise(OpenRCT2::IStream* stream) const abstract;
+
+private:
     void BuildRange(
-        int32_t language, const ScanResult& scanResult, size_t rangeStart, size_t rangeEnd, std::vector<TItem>& items,
-        std::atomic<size_t>& processed, std::mutex& printLock) const
+        int32_t language, const ScanResult& scanResult, const std::vector<size_t>& filesToIndex, size_t rangeStart,
+        size_t rangeEnd, std::vector<std::optional<TItem>>& fileItems, std::atomic<size_t>& processed,
+        std::mutex& printLock) const
     {
-        items.reserve(rangeEnd - rangeStart);
         for (size_t i = rangeStart; i < rangeEnd; i++)
         {
-            const auto& filePath = scanResult.Files.at(i);
+            size_t fileIndex = filesToIndex.at(i);
+            const auto& filePath = scanResult.Files.at(fileIndex).Path;
 
             if (_log_levels[static_cast<uint8_t>(DiagnosticLevel::Verbose)])
             {
@@ -188,28 +263,52 @@ private:
             auto item = Create(language, filePath);
             if (std::get<0>(item))
             {
-                items.push_back(std::get<1>(item));
+                fileItems[fileIndex] = std::get<1>(item);
             }
 
             processed++;
         }
     }
 
-    std::vector<TItem> Build(int32_t language, const ScanResult& scanResult) const
+    std::vector<TItem> Build(int32_t language, const ScanResult& scanResult, FileCache cache) const
     {
-        std::vector<TItem> allItems;
-        Console::WriteLine("Building %s (%zu items)", _name.c_str(), scanResult.Files.size());
+        const size_t fileCount = scanResult.Files.size();
+
+        // Reuse the items of files that have not changed since they were indexed
+        std::vector<std::optional<TItem>> fileItems(fileCount);
+        std::vector<size_t> filesToIndex;
+        for (size_t i = 0; i < fileCount; i++)
+        {
+            const auto& file = scanResult.Files[i];
+            auto cachedFile = cache.find(file.Path);
+            if (cachedFile != cache.end() && cachedFile->second.Size == file.Size
+                && cachedFile->second.LastModified == file.LastModified)
+            {
+                fileItems[i] = std::move(cachedFile->second.Item);
+            }
+            else
+            {
+                filesToIndex.push_back(i);
+            }
+        }
+
+        const size_t totalCount = filesToIndex.size();
+        if (totalCount == fileCount)
+        {
+            Console::WriteLine("Building %s (%zu items)", _name.c_str(), totalCount);
+        }
+        else
+        {
+            Console::WriteLine("Updating %s (%zu of %zu items changed)", _name.c_str(), totalCount, fileCount);
+        }
 
         auto startTime = std::chrono::high_resolution_clock::now();
 
-        const size_t totalCount = scanResult.Files.size();
         if (totalCount > 0)
         {
             JobPool jobPool;
             std::mutex printLock; // For verbose prints.
 
-            std::list<std::vector<TItem>> containers;
-
             size_t stepSize = 100; // Handpicked, seems to work well with 4/8 cores.
 
             std::atomic<size_t> processed = ATOMIC_VAR_INIT(0);
@@ -226,25 +325,27 @@ private:
                     stepSize = totalCount - rangeStart;
                 }
 
-                auto& items = containers.emplace_back();
-
                 jobPool.AddTask(std::bind(
-                    &FileIndex<TItem>::BuildRange, this, language, std::cref(scanResult), rangeStart, rangeStart + stepSize,
-                    std::ref(items), std::ref(processed), std::ref(printLock)));
+                    &FileIndex<TItem>::BuildRange, this, language, std::cref(scanResult), std::cref(filesToIndex),
+                    rangeStart, rangeStart + stepSize, std::ref(fileItems), std::ref(processed), std::ref(printLock)));
 
                 reportProgress();
             }
 
             jobPool.Join(reportProgress);
+        }
+
+        WriteIndexFile(language, scanResult, fileItems);
 
-            for (auto&& itr : containers)
+        std::vector<TItem> allItems;
+        for (auto& item : fileItems)
+        {
+            if (item.has_value())
             {
-                allItems.insert(allItems.end(), itr.begin(), itr.end());
+                allItems.push_back(std::move(*item));
             }
         }
 
-        WriteIndexFile(language, scanResult.Stats, allItems);
-
         auto endTime = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration<float>(endTime - startTime);
         Console::WriteLine("Finished building %s in %.2f seconds.", _name.c_str(), duration.count());
@@ -252,10 +353,11 @@ private:
         return allItems;
     }
 
-    std::tuple<bool, std::vector<TItem>> ReadIndexFile(int32_t language, const DirectoryStats& stats) const
+    std::tuple<bool, std::vector<TItem>, FileCache> ReadIndexFile(int32_t language, const DirectoryStats& stats) const
     {
         bool loadedItems = false;
         std::vector<TItem> items;
+        FileCache cache;
         if (File::Exists(_indexPath))
         {
             try
@@ -266,19 +368,44 @@ private:
                 // Read header, check if we need to re-scan
                 auto header = fs.ReadValue<FileIndexHeader>();
                 if (header.HeaderSize == sizeof(FileIndexHeader) && header.MagicNumber == _magicNumber
-                    && header.VersionA == FILE_INDEX_VERSION && header.VersionB == _version && header.LanguageId == language
-                    && header.Stats.TotalFiles == stats.TotalFiles && header.Stats.TotalFileSize == stats.TotalFileSize
-                    && header.Stats.FileDateModifiedChecksum == stats.FileDateModifiedChecksum
-                    && header.Stats.PathChecksum == stats.PathChecksum)
+                    && header.VersionA == FILE_INDEX_VERSION && header.VersionB == _version && header.LanguageId == language)
                 {
-                    items.reserve(header.NumItems);
-                    // Directory is the same, just read the saved items
-                    for (uint32_t i = 0; i < header.NumItems; i++)
+                    bool isUpToDate = header.Stats.TotalFiles == stats.TotalFiles
+                        && header.Stats.TotalFileSize == stats.TotalFileSize
+                        && header.Stats.FileDateModifiedChecksum == stats.FileDateModifiedChecksum
+                        && header.Stats.PathChecksum == stats.PathChecksum;
+                    if (isUpToDate)
+                    {
+                        items.reserve(header.NumFiles);
+                    }
+                    else
                     {
-                        auto item = Deserialise(&fs);
-                        items.push_back(item);
+                        Console::WriteLine("%s out of date", _name.c_str());
                     }
-                    loadedItems = true;
+
+                    // If the directory is the same, just read the saved items. Otherwise keep them around so only
+                    // files that changed have to be indexed again.
+                    for (uint32_t i = 0; i < header.NumFiles; i++)
+                    {
+                        auto path = fs.ReadStdString();
+                        CachedFile file;
+                        file.Size = fs.ReadValue<uint64_t>();
+                        file.LastModified = fs.ReadValue<uint64_t>();
+                        if (fs.ReadValue<uint8_t>() != 0)
+                        {
+                            file.Item = Deserialise(&fs);
+                        }
+
+                        if (!isUpToDate)
+                        {
+                            cache.emplace(std::move(path), std::move(file));
+                        }
+                        else if (file.Item.has_value())
+                        {
+                            items.push_back(std::move(*file.Item));
+                        }
+                    }
+                    loadedItems = isUpToDate;
                 }
                 else
                 {
@@ -289,12 +416,15 @@ private:
             {
                 Console::Error::WriteLine("Unable to load index: '%s'.", _indexPath.c_str());
                 Console::Error::WriteLine("%s", e.what());
+                items.clear();
+                cache.clear();
             }
         }
-        return std::make_tuple(loadedItems, items);
+        return std::make_tuple(loadedItems, std::move(items), std::move(cache));
     }
 
-    void WriteIndexFile(int32_t language, const DirectoryStats& stats, const std::vector<TItem>& items) const
+    void WriteIndexFile(
+        int32_t language, const ScanResult& scanResult, const std::vector<std::optional<TItem>>& fileItems) const
     {
         try
         {
@@ -308,14 +438,22 @@ private:
             header.VersionA = FILE_INDEX_VERSION;
             header.VersionB = _version;
             header.LanguageId = language;
-            header.Stats = stats;
-            header.NumItems = static_cast<uint32_t>(items.size());
+            header.Stats = scanResult.Stats;
+            header.NumFiles = static_cast<uint32_t>(scanResult.Files.size());
             fs.WriteValue(header);
 
-            // Write items
-            for (const auto& item : items)
+            // Write every file with its item, if it has one
+            for (size_t i = 0; i < scanResult.Files.size(); i++)
             {
-                Serialise(&fs, item);
+                const auto& file = scanResult.Files[i];
+                fs.WriteString(file.Path);
+                fs.WriteValue(file.Size);
+                fs.WriteValue(file.LastModified);
+                fs.WriteValue<uint8_t>(fileItems[i].has_value() ? 1 : 0);
+                if (fileItems[i].has_value())
+                {
+                    Serialise(&fs, *fileItems[i]);
+                }
             }
         }
         catch (const std::exception& e)
@@ -178,6 +178,11 @@ namespace OpenRCT2
 
         void Write(const void* buffer, uint64_t length) override
         {
+            // fwrite reports writing no items as a failure
+            if (length == 0)
+            {
+                return;
+            }
             if (fwrite(buffer, static_cast<size_t>(length), 1, _file) != 1)
             {
                 throw IOException("Unable to write to file.");
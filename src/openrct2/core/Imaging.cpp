@@ -162,6 +162,23 @@ namespace Imaging
         }
     }
 
+    static png_colorp PngCreatePalette(png_structp png_ptr, const GamePalette& palette)
+    {
+        auto png_palette = static_cast<png_colorp>(png_malloc(png_ptr, PNG_MAX_PALETTE_LENGTH * sizeof(png_color)));
+        if (png_palette == nullptr)
+        {
+            throw std::runtime_error("png_malloc failed.");
+        }
+        for (size_t i = 0; i < PNG_MAX_PALETTE_LENGTH; i++)
+        {
+            const auto& entry = palette[static_cast<uint16_t>(i)];
+            png_palette[i].blue = entry.Blue;
+            png_palette[i].green = entry.Green;
+            png_palette[i].red = entry.Red;
+        }
+        return png_palette;
+    }
+
     static void WritePng(std::ostream& ostream, const Image& image)
     {
         png_structp png_ptr = nullptr;
@@ -193,18 +210,7 @@ namespace Imaging
                 }
 
                 // Set the palette
-                png_palette = static_cast<png_colorp>(png_malloc(png_ptr, PNG_MAX_PALETTE_LENGTH * sizeof(png_color)));
-                if (png_palette == nullptr)
-                {
-                    throw std::runtime_error("png_malloc failed.");
-                }
-                for (size_t i = 0; i < PNG_MAX_PALETTE_LENGTH; i++)
-                {
-                    const auto& entry = (*image.Palette)[static_cast<uint16_t>(i)];
-                    png_palette[i].blue = entry.Blue;
-                    png_palette[i].green = entry.Green;
-                    png_palette[i].red = entry.Red;
-                }
+                png_palette = PngCreatePalette(png_ptr, *image.Palette);
                 png_set_PLTE(png_ptr, info_ptr, png_palette, PNG_MAX_PALETTE_LENGTH);
             }
 
@@ -351,4 +357,140 @@ namespace Imaging
                 throw std::runtime_error(EXCEPTION_IMAGE_FORMAT_UNKNOWN);
         }
     }
+
+    /**
+     * Streams an 8-bit paletted PNG to a file, rows are compressed as soon as they are handed over.
+     */
+    class PngRowWriter final : public IImageRowWriter
+    {
+    private:
+        std::ofstream _fs;
+        png_structp _png = nullptr;
+        png_infop _info = nullptr;
+        png_colorp _palette = nullptr;
+        uint32_t _height = 0;
+        uint32_t _rowsWritten = 0;
+
+    public:
+        PngRowWriter(const std::string_view& path, uint32_t width, uint32_t height, const GamePalette& palette)
+            : _height(height)
+        {
+#if defined(_WIN32) && !defined(__MINGW32__)
+            auto pathW = String::ToWideChar(path);
+            _fs.open(pathW, std::ios::binary);
+#else
+            _fs.open(std::string(path), std::ios::binary);
+#endif
+            if (!_fs.is_open())
+            {
+                throw std::runtime_error("Unable to open " + std::string(path) + " for writing.");
+            }
+
+            _png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, PngError, PngWarning);
+            if (_png == nullptr)
+            {
+                throw std::runtime_error("png_create_write_struct failed.");
+            }
+
+            try
+            {
+                _info = png_create_info_struct(_png);
+                if (_info == nullptr)
+                {
+                    throw std::runtime_error("png_create_info_struct failed.");
+                }
+                _palette = PngCreatePalette(_png, palette);
+            }
+            catch (const std::exception&)
+            {
+                Dispose();
+                throw;
+            }
+
+            if (setjmp(png_jmpbuf(_png)))
+            {
+                Dispose();
+                throw std::runtime_error("PNG ERROR");
+            }
+
+            png_text text_ptr[1];
+            text_ptr[0].key = const_cast<char*>("Software");
+            text_ptr[0].text = const_cast<char*>(gVersionInfoFull);
+            text_ptr[0].compression = PNG_TEXT_COMPRESSION_zTXt;
+
+            png_set_write_fn(_png, &_fs, PngWriteData, PngFlush);
+            png_set_PLTE(_png, _info, _palette, PNG_MAX_PALETTE_LENGTH);
+
+            png_byte transparentIndex = 0;
+            png_set_tRNS(_png, _info, &transparentIndex, 1, nullptr);
+            png_set_text(_png, _info, text_ptr, 1);
+            png_set_IHDR(
+                _png, _info, width, height, 8, PNG_COLOR_TYPE_PALETTE, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
+                PNG_FILTER_TYPE_DEFAULT);
+            png_write_info(_png, _info);
+        }
+
+        ~PngRowWriter() override
+        {
+            Dispose();
+        }
+
+        void WriteRows(const uint8_t* pixels, uint32_t rowCount, uint32_t stride) override
+        {
+            Guard::Assert(_png != nullptr, "PNG writer has already been closed");
+            Guard::Assert(_rowsWritten + rowCount <= _height, "Too many rows written to PNG");
+
+            if (setjmp(png_jmpbuf(_png)))
+            {
+                Dispose();
+                throw std::runtime_error("PNG ERROR");
+            }
+
+            for (uint32_t y = 0; y < rowCount; y++)
+            {
+                png_write_row(_png, const_cast<png_byte*>(pixels));
+                pixels += stride;
+            }
+            _rowsWritten += rowCount;
+        }
+
+        void Finish() override
+        {
+            Guard::Assert(_rowsWritten == _height, "PNG is missing rows");
+
+            if (setjmp(png_jmpbuf(_png)))
+            {
+                Dispose();
+                throw std::runtime_error("PNG ERROR");
+            }
+
+            png_write_end(_png, nullptr);
+            Dispose();
+
+            _fs.close();
+            if (_fs.fail())
+            {
+                throw std::runtime_error("Unable to write PNG.");
+            }
+        }
+
+    private:
+        void Dispose()
+        {
+            if (_png != nullptr)
+            {
+                png_free(_png, _palette);
+                png_destroy_write_struct(&_png, _info != nullptr ? &_info : nullptr);
+                _palette = nullptr;
+                _png = nullptr;
+                _info = nullptr;
+            }
+        }
+    };
+
+    std::unique_ptr<IImageRowWriter> CreatePngRowWriter(
+        const std::string_view& path, uint32_t width, uint32_t height, const GamePalette& palette)
+    {
+        return std::make_unique<PngRowWriter>(path, width, height, palette);
+    }
 } // namespace Imaging
@@ -44,12 +44,25 @@ struct Image
 
 using ImageReaderFunc = std::function<Image(std::istream&, IMAGE_FORMAT)>;
 
+/**
+ * Writes an 8-bit image a band of rows at a time so that the whole image never needs to be held in memory.
+ */
+struct IImageRowWriter
+{
+    virtual ~IImageRowWriter() = default;
+
+    virtual void WriteRows(const uint8_t* pixels, uint32_t rowCount, uint32_t stride) abstract;
+    virtual void Finish() abstract;
+};
+
 namespace Imaging
 {
     IMAGE_FORMAT GetImageFormatFromPath(const std::string_view& path);
     Image ReadFromFile(const std::string_view& path, IMAGE_FORMAT format = IMAGE_FORMAT::AUTOMATIC);
     Image ReadFromBuffer(const std::vector<uint8_t>& buffer, IMAGE_FORMAT format = IMAGE_FORMAT::AUTOMATIC);
     void WriteToFile(const std::string_view& path, const Image& image, IMAGE_FORMAT format = IMAGE_FORMAT::AUTOMATIC);
+    std::unique_ptr<IImageRowWriter> CreatePngRowWriter(
+        const std::string_view& path, uint32_t width, uint32_t height, const GamePalette& palette);
 
     void SetReader(IMAGE_FORMAT format, ImageReaderFunc impl);
 } // namespace Imaging
@@ -0,0 +1,115 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#ifdef _WIN32
+#    include <windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+#include "IStream.hpp"
+#include "MemoryMappedFile.h"
+#include "String.hpp"
+
+namespace OpenRCT2
+{
+#ifdef _WIN32
+    MemoryMappedFile::MemoryMappedFile(const std::string& path)
+    {
+        auto pathW = String::ToWideChar(path);
+        auto file = CreateFileW(
+            pathW.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            throw IOException(String::StdFormat("Unable to open '%s'", path.c_str()));
+        }
+
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(file, &fileSize))
+        {
+            CloseHandle(file);
+            throw IOException(String::StdFormat("Unable to get size of '%s'", path.c_str()));
+        }
+        _length = static_cast<size_t>(fileSize.QuadPart);
+
+        if (_length != 0)
+        {
+            _mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+            if (_mapping != nullptr)
+            {
+                _data = static_cast<uint8_t*>(MapViewOfFile(_mapping, FILE_MAP_COPY, 0, 0, 0));
+            }
+        }
+        // The mapping keeps its own reference to the file
+        CloseHandle(file);
+
+        if (_length != 0 && _data == nullptr)
+        {
+            if (_mapping != nullptr)
+            {
+                CloseHandle(_mapping);
+            }
+            throw IOException(String::StdFormat("Unable to map '%s'", path.c_str()));
+        }
+    }
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+        if (_data != nullptr)
+        {
+            UnmapViewOfFile(_data);
+        }
+        if (_mapping != nullptr)
+        {
+            CloseHandle(_mapping);
+        }
+    }
+#else
+    MemoryMappedFile::MemoryMappedFile(const std::string& path)
+    {
+        auto fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+        {
+            throw IOException(String::StdFormat("Unable to open '%s'", path.c_str()));
+        }
+
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+        {
+            close(fd);
+            throw IOException(String::StdFormat("Unable to open '%s'", path.c_str()));
+        }
+        _length = static_cast<size_t>(fileStat.st_size);
+
+        if (_length != 0)
+        {
+            auto data = mmap(nullptr, _length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED)
+            {
+                close(fd);
+                throw IOException(String::StdFormat("Unable to map '%s'", path.c_str()));
+            }
+            _data = static_cast<uint8_t*>(data);
+        }
+        // The mapping keeps its own reference to the file
+        close(fd);
+    }
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+        if (_data != nullptr)
+        {
+            munmap(_data, _length);
+        }
+    }
+#endif
+} // namespace OpenRCT2
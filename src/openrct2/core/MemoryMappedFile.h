@@ -0,0 +1,47 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+
+#include <string>
+
+namespace OpenRCT2
+{
+    /**
+     * Maps a whole file into memory so that its pages are only read from disk once they are accessed. The mapping is
+     * private: writes to it are allowed but only ever change this process's copy of the affected pages.
+     */
+    class MemoryMappedFile final
+    {
+    private:
+        uint8_t* _data = nullptr;
+        size_t _length = 0;
+#ifdef _WIN32
+        void* _mapping = nullptr;
+#endif
+
+    public:
+        explicit MemoryMappedFile(const std::string& path);
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+        ~MemoryMappedFile();
+
+        uint8_t* GetData() const
+        {
+            return _data;
+        }
+
+        size_t GetLength() const
+        {
+            return _length;
+        }
+    };
+} // namespace OpenRCT2
@@ -0,0 +1,178 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Parallel
+{
+    struct Batch
+    {
+        const std::function<void(size_t)>& Func;
+        const size_t Count;
+        std::atomic<size_t> Next{};
+        size_t NumDone{};
+        std::exception_ptr Error;
+        std::mutex Mutex;
+        std::condition_variable Finished;
+
+        Batch(const std::function<void(size_t)>& func, size_t count)
+            : Func(func)
+            , Count(count)
+        {
+        }
+
+        bool HasWork() const
+        {
+            return Next.load(std::memory_order_relaxed) < Count;
+        }
+
+        void Work()
+        {
+            size_t index;
+            while ((index = Next.fetch_add(1)) < Count)
+            {
+                std::exception_ptr error;
+                try
+                {
+                    Func(index);
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+
+                std::lock_guard<std::mutex> lock(Mutex);
+                if (error != nullptr && Error == nullptr)
+                {
+                    Error = error;
+                }
+                NumDone++;
+                if (NumDone == Count)
+                {
+                    Finished.notify_all();
+                }
+            }
+        }
+    };
+
+    class WorkerPool
+    {
+    private:
+        std::vector<std::thread> _threads;
+        std::mutex _mutex;
+        std::condition_variable _workAvailable;
+        // Newest last, workers help with the newest batch first so nested work finishes before more is started
+        std::vector<std::shared_ptr<Batch>> _batches;
+        bool _shouldStop{};
+
+    public:
+        WorkerPool()
+        {
+            // The thread calling For is one of the workers
+            auto numThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1) - 1;
+            for (size_t i = 0; i < numThreads; i++)
+            {
+                _threads.emplace_back(&WorkerPool::ProcessBatches, this);
+            }
+        }
+
+        ~WorkerPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _shouldStop = true;
+            }
+            _workAvailable.notify_all();
+            for (auto& thread : _threads)
+            {
+                thread.join();
+            }
+        }
+
+        void For(size_t count, const std::function<void(size_t)>& func)
+        {
+            if (count <= 1 || _threads.empty())
+            {
+                for (size_t i = 0; i < count; i++)
+                {
+                    func(i);
+                }
+                return;
+            }
+
+            auto batch = std::make_shared<Batch>(func, count);
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _batches.push_back(batch);
+            }
+            _workAvailable.notify_all();
+
+            batch->Work();
+            {
+                std::unique_lock<std::mutex> lock(batch->Mutex);
+                batch->Finished.wait(lock, [&batch]() { return batch->NumDone == batch->Count; });
+            }
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _batches.erase(std::remove(_batches.begin(), _batches.end(), batch), _batches.end());
+            }
+
+            if (batch->Error != nullptr)
+            {
+                std::rethrow_exception(batch->Error);
+            }
+        }
+
+    private:
+        void ProcessBatches()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (true)
+            {
+                // Other threads take indices without the lock, so the batch is picked in the predicate. Otherwise it
+                // could have run out of work between waking up and looking for it.
+                std::shared_ptr<Batch> batch;
+                _workAvailable.wait(lock, [this, &batch]() {
+                    batch = FindBatchWithWork();
+                    return _shouldStop || batch != nullptr;
+                });
+                if (_shouldStop)
+                {
+                    break;
+                }
+
+                lock.unlock();
+                batch->Work();
+                batch = nullptr;
+                lock.lock();
+            }
+        }
+
+        std::shared_ptr<Batch> FindBatchWithWork() const
+        {
+            auto it = std::find_if(_batches.rbegin(), _batches.rend(), [](const auto& b) { return b->HasWork(); });
+            return it != _batches.rend() ? *it : nullptr;
+        }
+    };
+
+    void For(size_t count, const std::function<void(size_t)>& func)
+    {
+        static WorkerPool pool;
+        pool.For(count, func);
+    }
+} // namespace Parallel
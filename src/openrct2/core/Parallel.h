@@ -0,0 +1,25 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+
+#include <functional>
+
+namespace Parallel
+{
+    /**
+     * Calls func for every index below count on a pool of worker threads shared by the whole game. Indices are handed
+     * out one at a time, so slow ones do not hold up the rest. The calling thread works through the indices as well,
+     * so For can be nested: work started by a worker thread can itself be split up without waiting on itself.
+     * Rethrows the first exception thrown by func once every index is done.
+     */
+    void For(size_t count, const std::function<void(size_t)>& func);
+} // namespace Parallel
@@ -42,6 +42,112 @@ void mask_avx2(
     }
 }
 
+// Loads 32 pixels, taking every TStep'th byte from src. Reads exactly 32 * TStep bytes.
+template<int32_t TStep> static __m256i load_strided_avx2(const uint8_t* src)
+{
+    if constexpr (TStep == 1)
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    }
+    else if constexpr (TStep == 2)
+    {
+        const __m256i lowBytes = _mm256_set1_epi16(0x00FF);
+        const __m256i a = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)), lowBytes);
+        const __m256i b = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32)), lowBytes);
+        // Packing works per 128-bit lane, so the quadwords need to be put back in order
+        return _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8);
+    }
+    else
+    {
+        static_assert(TStep == 4);
+        const __m256i lowBytes = _mm256_set1_epi32(0x000000FF);
+        const __m256i a = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)), lowBytes);
+        const __m256i b = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32)), lowBytes);
+        const __m256i c = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 64)), lowBytes);
+        const __m256i d = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 96)), lowBytes);
+        const __m256i packed = _mm256_packus_epi16(_mm256_packus_epi32(a, b), _mm256_packus_epi32(c, d));
+        // Packing works per 128-bit lane, so the doublewords need to be put back in order
+        return _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+    }
+}
+
+template<int32_t TStep>
+static void rle_copy_avx2_impl(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcLength)
+{
+    const __m256i zero = {};
+    int32_t i = 0;
+    for (; (i + 32) * TStep <= srcLength; i += 32)
+    {
+        const __m256i colour = load_strided_avx2<TStep>(src + i * TStep);
+        const __m256i dest = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        const __m256i transparent = _mm256_cmpeq_epi8(colour, zero);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_blendv_epi8(colour, dest, transparent));
+    }
+    rle_copy_scalar(src + i * TStep, dst + i, srcLength - i * TStep, TStep);
+}
+
+template<int32_t TStep>
+static void rle_remap_avx2_impl(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t srcLength)
+{
+    const __m256i zero = {};
+    int32_t i = 0;
+    for (; (i + 32) * TStep <= srcLength; i += 32)
+    {
+        // As with SSE4.1, the table lookups stay scalar and only the masking is vectorised
+        alignas(32) uint8_t colours[32];
+        for (int32_t j = 0; j < 32; j++)
+        {
+            colours[j] = table[src[(i + j) * TStep]];
+        }
+        const __m256i indices = load_strided_avx2<TStep>(src + i * TStep);
+        const __m256i colour = _mm256_load_si256(reinterpret_cast<const __m256i*>(colours));
+        const __m256i dest = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        const __m256i transparent = _mm256_or_si256(_mm256_cmpeq_epi8(indices, zero), _mm256_cmpeq_epi8(colour, zero));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_blendv_epi8(colour, dest, transparent));
+    }
+    rle_remap_scalar(src + i * TStep, dst + i, table, srcLength - i * TStep, TStep);
+}
+
+void rle_copy_avx2(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcLength, int32_t srcStep)
+{
+    switch (srcStep)
+    {
+        case 1:
+            rle_copy_avx2_impl<1>(src, dst, srcLength);
+            break;
+        case 2:
+            rle_copy_avx2_impl<2>(src, dst, srcLength);
+            break;
+        case 4:
+            rle_copy_avx2_impl<4>(src, dst, srcLength);
+            break;
+        default:
+            rle_copy_scalar(src, dst, srcLength, srcStep);
+            break;
+    }
+}
+
+void rle_remap_avx2(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t srcLength, int32_t srcStep)
+{
+    switch (srcStep)
+    {
+        case 1:
+            rle_remap_avx2_impl<1>(src, dst, table, srcLength);
+            break;
+        case 2:
+            rle_remap_avx2_impl<2>(src, dst, table, srcLength);
+            break;
+        case 4:
+            rle_remap_avx2_impl<4>(src, dst, table, srcLength);
+            break;
+        default:
+            rle_remap_scalar(src, dst, table, srcLength, srcStep);
+            break;
+    }
+}
+
 #else
 
 #    ifdef OPENRCT2_X86
@@ -55,4 +161,15 @@ void mask_avx2(
     openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
 }
 
+void rle_copy_avx2(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcLength, int32_t srcStep)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
+void rle_remap_avx2(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t srcLength, int32_t srcStep)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
 #endif // __AVX2__
@@ -0,0 +1,371 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "../config/Config.h"
+#include "../sprites.h"
+#include "Drawing.h"
+#include "NewDrawing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Holds the data of object images that are read once one of them is drawn. The data of each image list is read as a
+ * whole. If the data of all lists grows larger than the configured limit, lists that have not been drawn since the
+ * last trim are unloaded first (second chance eviction).
+ *
+ * Drawing an image without data only requests it and draws nothing. The requested lists are read by a background job
+ * and their data is handed to the lists on the main thread between frames, so reading never stalls a frame and the
+ * data does not change while it is drawn.
+ */
+class LazyImageCache
+{
+private:
+    struct ImageList
+    {
+        uint32_t BaseImageIndex{};
+        uint64_t Id{};
+        std::vector<rct_g1_element> Elements;
+        std::vector<uintptr_t> Offsets;
+        ImageDataLoader LoadData;
+        std::vector<uint8_t> Data;
+        std::list<ImageList*>::iterator ClockPosition;
+        std::atomic<bool> Requested{};
+        std::atomic<bool> Used{};
+        bool Loaded{};
+        bool Failed{};
+    };
+
+    struct LoadRequest
+    {
+        uint32_t BaseImageIndex{};
+        uint64_t Id{};
+        ImageDataLoader LoadData;
+    };
+
+    struct LoadResult
+    {
+        uint32_t BaseImageIndex{};
+        uint64_t Id{};
+        std::vector<uint8_t> Data;
+        std::string Error;
+    };
+
+    // Guards the lists, drawing threads only take it shared
+    std::shared_mutex _mutex;
+    std::unordered_map<uint32_t, std::unique_ptr<ImageList>> _imageLists;
+    // The list of each image, by image index from SPR_IMAGE_LIST_BEGIN
+    std::vector<ImageList*> _imageListsByImage;
+    // Lists with data, in the order they are visited when trimming
+    std::list<ImageList*> _clock;
+    size_t _size{};
+    uint64_t _nextId{};
+
+    std::mutex _requestsMutex;
+    std::vector<uint32_t> _requests;
+    std::future<std::vector<LoadResult>> _loadJob;
+
+public:
+    void Add(uint32_t baseImageIndex, const rct_g1_element* images, uint32_t count, ImageDataLoader loadData)
+    {
+        auto imageList = std::make_unique<ImageList>();
+        imageList->BaseImageIndex = baseImageIndex;
+        imageList->Elements.assign(images, images + count);
+        imageList->Offsets.resize(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            imageList->Offsets[i] = reinterpret_cast<uintptr_t>(images[i].offset);
+            imageList->Elements[i].offset = nullptr;
+            imageList->Elements[i].flags &= ~G1_FLAG_ON_DEMAND;
+        }
+        imageList->LoadData = std::move(loadData);
+
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        imageList->Id = _nextId++;
+        size_t end = baseImageIndex - SPR_IMAGE_LIST_BEGIN + count;
+        if (_imageListsByImage.size() < end)
+        {
+            _imageListsByImage.resize(end);
+        }
+        std::fill_n(_imageListsByImage.begin() + (baseImageIndex - SPR_IMAGE_LIST_BEGIN), count, imageList.get());
+        _imageLists[baseImageIndex] = std::move(imageList);
+    }
+
+    void Remove(uint32_t baseImageIndex)
+    {
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        auto it = _imageLists.find(baseImageIndex);
+        if (it != _imageLists.end())
+        {
+            auto& imageList = *it->second;
+            Unload(imageList);
+            std::fill_n(
+                _imageListsByImage.begin() + (baseImageIndex - SPR_IMAGE_LIST_BEGIN), imageList.Elements.size(), nullptr);
+            _imageLists.erase(it);
+        }
+    }
+
+    /**
+     * Returns the image with its data, or nullptr if the data has not been read yet or could not be read. The data of
+     * an image that has not been read yet is requested.
+     */
+    const rct_g1_element* Get(uint32_t imageIndex)
+    {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        size_t idx = imageIndex - SPR_IMAGE_LIST_BEGIN;
+        if (imageIndex < SPR_IMAGE_LIST_BEGIN || idx >= _imageListsByImage.size() || _imageListsByImage[idx] == nullptr)
+        {
+            return nullptr;
+        }
+
+        auto& imageList = *_imageListsByImage[idx];
+        imageList.Used.store(true, std::memory_order_relaxed);
+        if (!imageList.Loaded)
+        {
+            if (!imageList.Failed && !imageList.Requested.exchange(true, std::memory_order_relaxed))
+            {
+                std::lock_guard<std::mutex> requestsLock(_requestsMutex);
+                _requests.push_back(imageList.BaseImageIndex);
+            }
+            return nullptr;
+        }
+        return &imageList.Elements[imageIndex - imageList.BaseImageIndex];
+    }
+
+    /**
+     * Hands the data read by the background job to its lists, trims the cache and starts reading the lists that were
+     * requested since. Must be called on the main thread while nothing is drawn. Returns true if any data was added.
+     */
+    bool Update(size_t maxSize)
+    {
+        bool loaded = false;
+        if (_loadJob.valid() && _loadJob.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        {
+            loaded = AddResults(_loadJob.get());
+        }
+
+        if (maxSize != 0)
+        {
+            Trim(maxSize);
+        }
+
+        if (!_loadJob.valid())
+        {
+            auto requests = TakeRequests();
+            if (!requests.empty())
+            {
+                _loadJob = std::async(
+                    std::launch::async, [requests = std::move(requests)]() { return ReadRequests(requests); });
+            }
+        }
+        return loaded;
+    }
+
+    /**
+     * Reads the data of every requested list on the calling thread, for images that are drawn only once. Must be
+     * called on the main thread while nothing is drawn. Returns true if any data was added.
+     */
+    bool LoadRequested()
+    {
+        bool loaded = false;
+        if (_loadJob.valid())
+        {
+            loaded = AddResults(_loadJob.get());
+        }
+
+        auto requests = TakeRequests();
+        if (!requests.empty())
+        {
+            loaded |= AddResults(ReadRequests(requests));
+        }
+        return loaded;
+    }
+
+private:
+    std::vector<LoadRequest> TakeRequests()
+    {
+        std::vector<uint32_t> baseImageIndices;
+        {
+            std::lock_guard<std::mutex> requestsLock(_requestsMutex);
+            baseImageIndices.swap(_requests);
+        }
+
+        std::vector<LoadRequest> requests;
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        for (auto baseImageIndex : baseImageIndices)
+        {
+            auto it = _imageLists.find(baseImageIndex);
+            if (it != _imageLists.end())
+            {
+                const auto& imageList = *it->second;
+                requests.push_back({ imageList.BaseImageIndex, imageList.Id, imageList.LoadData });
+            }
+        }
+        return requests;
+    }
+
+    static std::vector<LoadResult> ReadRequests(const std::vector<LoadRequest>& requests)
+    {
+        std::vector<LoadResult> results;
+        for (const auto& request : requests)
+        {
+            LoadResult result;
+            result.BaseImageIndex = request.BaseImageIndex;
+            result.Id = request.Id;
+            try
+            {
+                result.Data = request.LoadData();
+            }
+            catch (const std::exception& e)
+            {
+                result.Error = e.what();
+            }
+            results.push_back(std::move(result));
+        }
+        return results;
+    }
+
+    bool AddResults(std::vector<LoadResult> results)
+    {
+        std::vector<uint32_t> loadedImages;
+        {
+            std::unique_lock<std::shared_mutex> lock(_mutex);
+            for (auto& result : results)
+            {
+                // The list may have been removed, or replaced by another one, while it was read
+                auto it = _imageLists.find(result.BaseImageIndex);
+                if (it == _imageLists.end() || it->second->Id != result.Id)
+                {
+                    continue;
+                }
+
+                auto& imageList = *it->second;
+                if (!result.Error.empty())
+                {
+                    log_error(
+                        "Unable to read images %u to %u: %s", imageList.BaseImageIndex,
+                        imageList.BaseImageIndex + static_cast<uint32_t>(imageList.Elements.size()) - 1,
+                        result.Error.c_str());
+                    imageList.Failed = true;
+                    continue;
+                }
+
+                imageList.Data = std::move(result.Data);
+                for (size_t i = 0; i < imageList.Elements.size(); i++)
+                {
+                    imageList.Elements[i].offset = imageList.Data.data() + imageList.Offsets[i];
+                    loadedImages.push_back(imageList.BaseImageIndex + static_cast<uint32_t>(i));
+                }
+                _size += imageList.Data.size();
+                imageList.ClockPosition = _clock.insert(_clock.end(), &imageList);
+                imageList.Loaded = true;
+            }
+        }
+
+        // Drop anything that was made while the image had no data
+        for (auto imageIndex : loadedImages)
+        {
+            gfx_rle_lod_invalidate(imageIndex);
+            drawing_engine_invalidate_image(imageIndex);
+        }
+        return !loadedImages.empty();
+    }
+
+    void Trim(size_t maxSize)
+    {
+        std::vector<uint32_t> unloadedImages;
+        {
+            std::unique_lock<std::shared_mutex> lock(_mutex);
+            // Every list is given a second chance at most once, so the loop ends even if all of them were drawn
+            size_t remainingChances = _clock.size();
+            while (_size > maxSize && !_clock.empty())
+            {
+                auto imageList = _clock.front();
+                if (remainingChances > 0 && imageList->Used.exchange(false, std::memory_order_relaxed))
+                {
+                    _clock.splice(_clock.end(), _clock, _clock.begin());
+                    remainingChances--;
+                    continue;
+                }
+
+                Unload(*imageList);
+                for (size_t i = 0; i < imageList->Elements.size(); i++)
+                {
+                    unloadedImages.push_back(imageList->BaseImageIndex + static_cast<uint32_t>(i));
+                }
+            }
+        }
+
+        // Drop anything that was made from the data that is now gone
+        for (auto imageIndex : unloadedImages)
+        {
+            gfx_rle_lod_invalidate(imageIndex);
+            drawing_engine_invalidate_image(imageIndex);
+        }
+    }
+
+    void Unload(ImageList& imageList)
+    {
+        if (!imageList.Loaded)
+        {
+            return;
+        }
+
+        imageList.Loaded = false;
+        imageList.Requested.store(false, std::memory_order_relaxed);
+        for (auto& element : imageList.Elements)
+        {
+            element.offset = nullptr;
+        }
+        _size -= imageList.Data.size();
+        imageList.Data.clear();
+        imageList.Data.shrink_to_fit();
+        _clock.erase(imageList.ClockPosition);
+    }
+};
+
+static LazyImageCache _lazyImageCache;
+
+void gfx_lazy_images_add(uint32_t baseImageIndex, const rct_g1_element* images, uint32_t count, ImageDataLoader loadData)
+{
+    _lazyImageCache.Add(baseImageIndex, images, count, std::move(loadData));
+}
+
+void gfx_lazy_images_remove(uint32_t baseImageIndex)
+{
+    _lazyImageCache.Remove(baseImageIndex);
+}
+
+const rct_g1_element* gfx_lazy_images_get(uint32_t imageIndex)
+{
+    return _lazyImageCache.Get(imageIndex);
+}
+
+void gfx_lazy_images_update()
+{
+    auto maxSize = static_cast<size_t>(std::max(gConfigGeneral.object_image_cache_size, 0)) * 1024 * 1024;
+    if (_lazyImageCache.Update(maxSize))
+    {
+        gfx_invalidate_screen();
+    }
+}
+
+bool gfx_lazy_images_load_requested()
+{
+    return _lazyImageCache.LoadRequested();
+}
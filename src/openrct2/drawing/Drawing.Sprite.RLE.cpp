@@ -7,10 +7,274 @@
  * OpenRCT2 is licensed under the GNU General Public License version 3.
  *****************************************************************************/
 
+#include "../sprites.h"
 #include "Drawing.h"
 
 #include <algorithm>
+#include <array>
 #include <cstring>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Caches RLE sprites pre-reduced for a zoom level, so that zoomed out views do not have to walk and discard the full
+ * resolution data every frame. Which source pixels the minify path samples depends on the clipped source offset modulo
+ * the zoom factor, so each zoom level can have one reduced sprite per sampling phase.
+ */
+class RLELodCache
+{
+private:
+    static constexpr size_t MAX_SIZE = 32 * 1024 * 1024;
+    // Rough cost of the bookkeeping for each cached sprite
+    static constexpr size_t ENTRY_OVERHEAD = 96;
+    static constexpr size_t NUM_SHARDS = 16;
+
+    using Buffer = std::shared_ptr<const std::vector<uint8_t>>;
+
+    struct Entry
+    {
+        Buffer Data;
+        std::list<uint64_t>::iterator LruPosition;
+    };
+
+    // Sprites are spread over the shards by image index, so threads drawing different sprites rarely wait on each other
+    struct Shard
+    {
+        std::mutex Mutex;
+        std::unordered_map<uint64_t, Entry> Entries;
+        // Most recently used at the front
+        std::list<uint64_t> Lru;
+        size_t Size{};
+        // Changes whenever sprites are invalidated, so that a sprite reduced from old data is not kept
+        uint32_t Generation{};
+    };
+
+    std::array<Shard, NUM_SHARDS> _shards;
+
+public:
+    static bool IsCacheable(uint32_t imageIndex)
+    {
+        // These images are rewritten in place without going through gfx_set_g1_element
+        return imageIndex != SPR_TEMP && (imageIndex < SPR_SCROLLING_TEXT_START || imageIndex >= SPR_SCROLLING_TEXT_END);
+    }
+
+    /**
+     * Returns the reduced sprite, or an empty buffer if the sprite can not be reduced.
+     */
+    Buffer GetOrCreate(uint32_t imageIndex, const rct_g1_element& g1, int32_t zoom, int32_t phaseX, int32_t phaseY)
+    {
+        auto key = GetKey(imageIndex, zoom, phaseX, phaseY);
+        auto& shard = GetShard(imageIndex);
+        uint32_t generation;
+        {
+            std::lock_guard<std::mutex> lock(shard.Mutex);
+            auto it = shard.Entries.find(key);
+            if (it != shard.Entries.end())
+            {
+                shard.Lru.splice(shard.Lru.begin(), shard.Lru, it->second.LruPosition);
+                return it->second.Data;
+            }
+            generation = shard.Generation;
+        }
+
+        // Reduced without the lock, if two threads reduce the same sprite the first one to finish is kept
+        auto data = std::make_shared<const std::vector<uint8_t>>(Reduce(g1, zoom, phaseX, phaseY));
+
+        std::lock_guard<std::mutex> lock(shard.Mutex);
+        if (shard.Generation != generation)
+        {
+            return data;
+        }
+        auto [it, inserted] = shard.Entries.emplace(key, Entry{ data, {} });
+        if (!inserted)
+        {
+            shard.Lru.splice(shard.Lru.begin(), shard.Lru, it->second.LruPosition);
+            return it->second.Data;
+        }
+        shard.Lru.push_front(key);
+        it->second.LruPosition = shard.Lru.begin();
+        shard.Size += data->size() + ENTRY_OVERHEAD;
+        while (shard.Size > MAX_SIZE / NUM_SHARDS && shard.Lru.size() > 1)
+        {
+            Erase(shard, shard.Lru.back());
+        }
+        return data;
+    }
+
+    void Invalidate(uint32_t imageIndex)
+    {
+        auto& shard = GetShard(imageIndex);
+        std::lock_guard<std::mutex> lock(shard.Mutex);
+        shard.Generation++;
+        if (shard.Entries.empty())
+            return;
+
+        for (int32_t zoomLevel = 1; zoomLevel <= 3; zoomLevel++)
+        {
+            auto zoom = 1 << zoomLevel;
+            for (int32_t phaseY = 0; phaseY < zoom; phaseY++)
+            {
+                for (int32_t phaseX = 0; phaseX < zoom; phaseX++)
+                {
+                    Erase(shard, GetKey(imageIndex, zoom, phaseX, phaseY));
+                }
+            }
+        }
+    }
+
+    void Clear()
+    {
+        for (auto& shard : _shards)
+        {
+            std::lock_guard<std::mutex> lock(shard.Mutex);
+            shard.Generation++;
+            shard.Entries.clear();
+            shard.Lru.clear();
+            shard.Size = 0;
+        }
+    }
+
+private:
+    static uint64_t GetKey(uint32_t imageIndex, int32_t zoom, int32_t phaseX, int32_t phaseY)
+    {
+        return (static_cast<uint64_t>(imageIndex) << 16) | (zoom << 8) | (phaseY << 4) | phaseX;
+    }
+
+    Shard& GetShard(uint32_t imageIndex)
+    {
+        return _shards[imageIndex % NUM_SHARDS];
+    }
+
+    static void Erase(Shard& shard, uint64_t key)
+    {
+        auto it = shard.Entries.find(key);
+        if (it != shard.Entries.end())
+        {
+            shard.Size -= it->second.Data->size() + ENTRY_OVERHEAD;
+            shard.Lru.erase(it->second.LruPosition);
+            shard.Entries.erase(it);
+        }
+    }
+
+    /**
+     * Builds an RLE sprite from every zoom'th row and column of the given sprite, starting at (phaseX, phaseY).
+     * Transparent pixels inside runs are dropped so that the result can be drawn with the straight copy of zoom 0.
+     */
+    static std::vector<uint8_t> Reduce(const rct_g1_element& g1, int32_t zoom, int32_t phaseX, int32_t phaseY)
+    {
+        auto src0 = g1.offset;
+        auto height = std::max(0, (g1.height - phaseY + zoom - 1) / zoom);
+
+        std::vector<uint8_t> result(height * 2);
+        std::vector<uint8_t> pixels;
+        for (int32_t y = 0; y < height; y++)
+        {
+            // Row offsets are 16-bit, give up on the rare sprite that grows past that once its runs are split
+            if (result.size() > std::numeric_limits<uint16_t>::max())
+            {
+                return {};
+            }
+            auto lineOffset = static_cast<uint16_t>(result.size());
+            result[y * 2] = lineOffset & 0xFF;
+            result[y * 2 + 1] = lineOffset >> 8;
+
+            // Sample the source row into a dense list of (x, pixel) pairs
+            auto srcY = phaseY + y * zoom;
+            uint16_t srcLineOffset = src0[srcY * 2] | (src0[srcY * 2 + 1] << 8);
+            auto nextRun = src0 + srcLineOffset;
+            auto isEndOfLine = false;
+            pixels.clear();
+            while (!isEndOfLine)
+            {
+                auto src = nextRun;
+                auto dataSize = *src++;
+                auto firstPixelX = *src++;
+                isEndOfLine = (dataSize & 0x80) != 0;
+                dataSize &= 0x7F;
+                nextRun = src + dataSize;
+
+                for (int32_t i = 0; i < dataSize; i++)
+                {
+                    auto x = firstPixelX + i - phaseX;
+                    if (x >= 0 && (x % zoom) == 0 && src[i] != 0)
+                    {
+                        pixels.push_back(static_cast<uint8_t>(x / zoom));
+                        pixels.push_back(src[i]);
+                    }
+                }
+            }
+
+            // Write the samples back out as runs of consecutive pixels
+            size_t runStart = result.size();
+            if (pixels.empty())
+            {
+                result.push_back(0x80);
+                result.push_back(0);
+                continue;
+            }
+            for (size_t i = 0; i < pixels.size(); i += 2)
+            {
+                auto x = pixels[i];
+                bool continuesRun = i != 0 && result[runStart] < 0x7F && x == result[runStart + 1] + result[runStart];
+                if (!continuesRun)
+                {
+                    runStart = result.size();
+                    result.push_back(0);
+                    result.push_back(x);
+                }
+                result.push_back(pixels[i + 1]);
+                result[runStart]++;
+            }
+            result[runStart] |= 0x80;
+        }
+        return result;
+    }
+};
+
+static RLELodCache _rleLodCache;
+thread_local bool gUseRLELodCache = true;
+
+void gfx_rle_lod_invalidate(uint32_t imageIndex)
+{
+    _rleLodCache.Invalidate(imageIndex);
+}
+
+void gfx_rle_lod_clear()
+{
+    _rleLodCache.Clear();
+}
+
+void rle_copy_scalar(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcLength, int32_t srcStep)
+{
+    for (int32_t i = 0; i < srcLength; i += srcStep)
+    {
+        uint8_t pixel = src[i];
+        if (pixel != 0)
+        {
+            *dst = pixel;
+        }
+        dst++;
+    }
+}
+
+void rle_remap_scalar(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t srcLength, int32_t srcStep)
+{
+    for (int32_t i = 0; i < srcLength; i += srcStep)
+    {
+        uint8_t index = src[i];
+        uint8_t pixel = table[index];
+        if (index != 0 && pixel != 0)
+        {
+            *dst = pixel;
+        }
+        dst++;
+    }
+}
 
 template<DrawBlendOp TBlendOp, size_t TZoom> static void FASTCALL DrawRLESpriteMagnify(DrawSpriteArgs& args)
 {
@@ -94,6 +358,7 @@ template<DrawBlendOp TBlendOp, size_t TZoom> static void FASTCALL DrawRLESpriteM
     auto height = args.Height;
     auto zoom = 1 << TZoom;
     auto dstLineWidth = (static_cast<size_t>(dpi->width) >> TZoom) + dpi->pitch;
+    auto remapTable = args.PalMap.GetTable();
 
     // Move up to the first line of the image if source_y_start is negative. Why does this even occur?
     if (srcY < 0)
@@ -154,17 +419,32 @@ template<DrawBlendOp TBlendOp, size_t TZoom> static void FASTCALL DrawRLESpriteM
             // end position then we need to shorten the line again
             numPixels = std::min(numPixels, width - x);
 
+            if (numPixels <= 0)
+            {
+                continue;
+            }
+
             auto dst = dstLineStart + (x >> TZoom);
             if constexpr ((TBlendOp & BLEND_SRC) == 0 && (TBlendOp & BLEND_DST) == 0 && TZoom == 0)
             {
                 // Since we're sampling each pixel at this zoom level, just do a straight std::memcpy
-                if (numPixels > 0)
-                {
-                    std::memcpy(dst, src, numPixels);
-                }
+                std::memcpy(dst, src, numPixels);
+            }
+            else if constexpr (TBlendOp == BLEND_TRANSPARENT)
+            {
+                rle_copy_fn(src, dst, numPixels, zoom);
             }
             else
             {
+                if constexpr (TBlendOp == (BLEND_TRANSPARENT | BLEND_SRC))
+                {
+                    if (remapTable != nullptr)
+                    {
+                        rle_remap_fn(src, dst, remapTable, numPixels, zoom);
+                        continue;
+                    }
+                }
+
                 auto& paletteMap = args.PalMap;
                 while (numPixels > 0)
                 {
@@ -178,6 +458,64 @@ template<DrawBlendOp TBlendOp, size_t TZoom> static void FASTCALL DrawRLESpriteM
     }
 }
 
+/**
+ * Draws a zoomed out RLE sprite using a cached copy that has already been reduced for the zoom level. Produces the same
+ * pixels as DrawRLESpriteMinify.
+ */
+template<DrawBlendOp TBlendOp, size_t TZoom> static bool FASTCALL DrawRLESpriteReduced(DrawSpriteArgs& args)
+{
+    auto imageIndex = args.Image.GetIndex();
+    if (!gUseRLELodCache || !RLELodCache::IsCacheable(imageIndex))
+    {
+        return false;
+    }
+
+    auto dpi = args.DPI;
+    auto dst0 = args.DestinationBits;
+    auto srcX = args.SrcX;
+    auto srcY = args.SrcY;
+    auto height = args.Height;
+    auto zoom = 1 << TZoom;
+
+    // Same adjustment as DrawRLESpriteMinify
+    if (srcY < 0)
+    {
+        srcY += zoom;
+        height -= zoom;
+        dst0 += (static_cast<size_t>(dpi->width) >> TZoom) + dpi->pitch;
+    }
+
+    auto phaseX = srcX & (zoom - 1);
+    auto phaseY = srcY & (zoom - 1);
+    auto data = _rleLodCache.GetOrCreate(imageIndex, args.SourceImage, zoom, phaseX, phaseY);
+    if (data->empty())
+    {
+        return false;
+    }
+
+    rct_g1_element reducedImage{};
+    reducedImage.offset = const_cast<uint8_t*>(data->data());
+    reducedImage.flags = G1_FLAG_RLE_COMPRESSION;
+
+    rct_drawpixelinfo reducedDpi = *dpi;
+    reducedDpi.width = dpi->width >> TZoom;
+    reducedDpi.zoom_level = 0;
+
+    DrawSpriteArgs reducedArgs(
+        &reducedDpi, args.Image, args.PalMap, reducedImage, (srcX - phaseX) >> TZoom, (srcY - phaseY) >> TZoom,
+        (args.Width + zoom - 1) >> TZoom, (height + zoom - 1) >> TZoom, dst0);
+    DrawRLESpriteMinify<TBlendOp, 0>(reducedArgs);
+    return true;
+}
+
+template<DrawBlendOp TBlendOp, size_t TZoom> static void FASTCALL DrawRLESpriteZoomedOut(DrawSpriteArgs& args)
+{
+    if (!DrawRLESpriteReduced<TBlendOp, TZoom>(args))
+    {
+        DrawRLESpriteMinify<TBlendOp, TZoom>(args);
+    }
+}
+
 template<DrawBlendOp TBlendOp> static void FASTCALL DrawRLESprite(DrawSpriteArgs& args)
 {
     auto zoom_level = static_cast<int8_t>(args.DPI->zoom_level);
@@ -193,13 +531,13 @@ template<DrawBlendOp TBlendOp> static void FASTCALL DrawRLESprite(DrawSpriteArgs
             DrawRLESpriteMinify<TBlendOp, 0>(args);
             break;
         case 1:
-            DrawRLESpriteMinify<TBlendOp, 1>(args);
+            DrawRLESpriteZoomedOut<TBlendOp, 1>(args);
             break;
         case 2:
-            DrawRLESpriteMinify<TBlendOp, 2>(args);
+            DrawRLESpriteZoomedOut<TBlendOp, 2>(args);
             break;
         case 3:
-            DrawRLESpriteMinify<TBlendOp, 3>(args);
+            DrawRLESpriteZoomedOut<TBlendOp, 3>(args);
             break;
         default:
             assert(false);
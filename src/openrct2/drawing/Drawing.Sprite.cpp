@@ -12,6 +12,7 @@
 #include "../PlatformEnvironment.h"
 #include "../config/Config.h"
 #include "../core/FileStream.hpp"
+#include "../core/MemoryStream.h"
 #include "../core/Path.hpp"
 #include "../platform/platform.h"
 #include "../sprites.h"
@@ -186,6 +187,19 @@ static rct_g1_element _g1Temp = {};
 static std::vector<rct_g1_element> _imageListElements;
 bool gTinyFontAntiAliased = false;
 
+/**
+ * Returns the element data of a mapped gx file. The data is referenced in place rather than copied, so its pages are
+ * only read from disk once a sprite using them is drawn.
+ */
+static uint8_t* gfx_get_mapped_element_data(const rct_gx& gx, uint64_t dataOffset)
+{
+    if (dataOffset + gx.header.total_size > gx.file->GetLength())
+    {
+        throw std::runtime_error("Graphics file is truncated");
+    }
+    return gx.file->GetData() + dataOffset;
+}
+
 /**
  *
  *  rct2: 0x00678998
@@ -196,7 +210,8 @@ bool gfx_load_g1(const IPlatformEnvironment& env)
     try
     {
         auto path = Path::Combine(env.GetDirectoryPath(DIRBASE::RCT2, DIRID::DATA), "g1.dat");
-        auto fs = FileStream(path, FILE_MODE_OPEN);
+        _g1.file = std::make_unique<MemoryMappedFile>(path);
+        auto fs = MemoryStream(_g1.file->GetData(), _g1.file->GetLength());
         _g1.header = fs.ReadValue<rct_g1_header>();
 
         log_verbose("g1.dat, number of entries: %u", _g1.header.num_entries);
@@ -212,13 +227,11 @@ bool gfx_load_g1(const IPlatformEnvironment& env)
         read_and_convert_gxdat(&fs, _g1.header.num_entries, is_rctc, _g1.elements.data());
         gTinyFontAntiAliased = is_rctc;
 
-        // Read element data
-        _g1.data = fs.ReadArray<uint8_t>(_g1.header.total_size);
-
         // Fix entry data offsets
+        auto data = gfx_get_mapped_element_data(_g1, fs.GetPosition());
         for (uint32_t i = 0; i < _g1.header.num_entries; i++)
         {
-            _g1.elements[i].offset += reinterpret_cast<uintptr_t>(_g1.data);
+            _g1.elements[i].offset += reinterpret_cast<uintptr_t>(data);
         }
         return true;
     }
@@ -226,6 +239,7 @@ bool gfx_load_g1(const IPlatformEnvironment& env)
     {
         _g1.elements.clear();
         _g1.elements.shrink_to_fit();
+        _g1.file = nullptr;
 
         log_fatal("Unable to load g1 graphics");
         if (!gOpenRCT2Headless)
@@ -239,23 +253,26 @@ bool gfx_load_g1(const IPlatformEnvironment& env)
 
 void gfx_unload_g1()
 {
-    SafeFree(_g1.data);
+    gfx_rle_lod_clear();
     _g1.elements.clear();
     _g1.elements.shrink_to_fit();
+    _g1.file = nullptr;
 }
 
 void gfx_unload_g2()
 {
-    SafeFree(_g2.data);
+    gfx_rle_lod_clear();
     _g2.elements.clear();
     _g2.elements.shrink_to_fit();
+    _g2.file = nullptr;
 }
 
 void gfx_unload_csg()
 {
-    SafeFree(_csg.data);
+    gfx_rle_lod_clear();
     _csg.elements.clear();
     _csg.elements.shrink_to_fit();
+    _csg.file = nullptr;
 }
 
 bool gfx_load_g2()
@@ -268,20 +285,19 @@ bool gfx_load_g2()
     safe_strcat_path(path, "g2.dat", MAX_PATH);
     try
     {
-        auto fs = FileStream(path, FILE_MODE_OPEN);
+        _g2.file = std::make_unique<MemoryMappedFile>(path);
+        auto fs = MemoryStream(_g2.file->GetData(), _g2.file->GetLength());
         _g2.header = fs.ReadValue<rct_g1_header>();
 
         // Read element headers
         _g2.elements.resize(_g2.header.num_entries);
         read_and_convert_gxdat(&fs, _g2.header.num_entries, false, _g2.elements.data());
 
-        // Read element data
-        _g2.data = fs.ReadArray<uint8_t>(_g2.header.total_size);
-
         // Fix entry data offsets
+        auto data = gfx_get_mapped_element_data(_g2, fs.GetPosition());
         for (uint32_t i = 0; i < _g2.header.num_entries; i++)
         {
-            _g2.elements[i].offset += reinterpret_cast<uintptr_t>(_g2.data);
+            _g2.elements[i].offset += reinterpret_cast<uintptr_t>(data);
         }
         return true;
     }
@@ -289,6 +305,7 @@ bool gfx_load_g2()
     {
         _g2.elements.clear();
         _g2.elements.shrink_to_fit();
+        _g2.file = nullptr;
 
         log_fatal("Unable to load g2 graphics");
         if (!gOpenRCT2Headless)
@@ -315,9 +332,9 @@ bool gfx_load_csg()
     try
     {
         auto fileHeader = FileStream(pathHeaderPath, FILE_MODE_OPEN);
-        auto fileData = FileStream(pathDataPath, FILE_MODE_OPEN);
+        _csg.file = std::make_unique<MemoryMappedFile>(pathDataPath);
         size_t fileHeaderSize = fileHeader.GetLength();
-        size_t fileDataSize = fileData.GetLength();
+        size_t fileDataSize = _csg.file->GetLength();
 
         _csg.header.num_entries = static_cast<uint32_t>(fileHeaderSize / sizeof(rct_g1_element_32bit));
         _csg.header.total_size = static_cast<uint32_t>(fileDataSize);
@@ -332,13 +349,11 @@ bool gfx_load_csg()
         _csg.elements.resize(_csg.header.num_entries);
         read_and_convert_gxdat(&fileHeader, _csg.header.num_entries, false, _csg.elements.data());
 
-        // Read element data
-        _csg.data = fileData.ReadArray<uint8_t>(_csg.header.total_size);
-
         // Fix entry data offsets
+        auto data = gfx_get_mapped_element_data(_csg, 0);
         for (uint32_t i = 0; i < _csg.header.num_entries; i++)
         {
-            _csg.elements[i].offset += reinterpret_cast<uintptr_t>(_csg.data);
+            _csg.elements[i].offset += reinterpret_cast<uintptr_t>(data);
             // RCT1 used zoomed offsets that counted from the beginning of the file, rather than from the current sprite.
             if (_csg.elements[i].flags & G1_FLAG_HAS_ZOOM_SPRITE)
             {
@@ -352,6 +367,7 @@ bool gfx_load_csg()
     {
         _csg.elements.clear();
         _csg.elements.shrink_to_fit();
+        _csg.file = nullptr;
 
         log_error("Unable to load csg graphics");
         return false;
@@ -706,7 +722,12 @@ const rct_g1_element* gfx_get_g1_element(int32_t image_id)
         size_t idx = offset - SPR_IMAGE_LIST_BEGIN;
         if (idx < _imageListElements.size())
         {
-            return &_imageListElements[idx];
+            const auto& element = _imageListElements[idx];
+            if (element.flags & G1_FLAG_ON_DEMAND)
+            {
+                return gfx_lazy_images_get(static_cast<uint32_t>(offset));
+            }
+            return &element;
         }
     }
     return nullptr;
@@ -726,6 +747,7 @@ void gfx_set_g1_element(int32_t imageId, const rct_g1_element* g1)
 
     if (g1 != nullptr)
     {
+        gfx_rle_lod_invalidate(imageId);
         if (isTemp)
         {
             _g1Temp = *g1;
@@ -24,16 +24,15 @@
 
 const PaletteMap& PaletteMap::GetDefault()
 {
-    static bool initialised = false;
+    // Sprites are drawn from several threads at once, so the data is only written once by the static initialiser
     static uint8_t data[256];
-    static PaletteMap defaultMap(data);
-    if (!initialised)
-    {
+    static const PaletteMap defaultMap = []() {
         for (size_t i = 0; i < sizeof(data); i++)
         {
             data[i] = static_cast<uint8_t>(i);
         }
-    }
+        return PaletteMap(data);
+    }();
     return defaultMap;
 }
 
@@ -73,6 +72,11 @@ uint8_t PaletteMap::Blend(uint8_t src, uint8_t dst) const
     return (*this)[idx];
 }
 
+const uint8_t* PaletteMap::GetTable() const
+{
+    return _dataLength >= 256 ? _data : nullptr;
+}
+
 void PaletteMap::Copy(size_t dstIndex, const PaletteMap& src, size_t srcIndex, size_t length)
 {
     auto maxLength = std::min(_mapLength - srcIndex, _mapLength - dstIndex);
@@ -578,6 +582,33 @@ void mask_init()
     }
 }
 
+void (*rle_copy_fn)(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcLength, int32_t srcStep) = nullptr;
+void (*rle_remap_fn)(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t srcLength, int32_t srcStep)
+    = nullptr;
+
+void rle_init()
+{
+    if (avx2_available())
+    {
+        log_verbose("registering AVX2 RLE functions");
+        rle_copy_fn = rle_copy_avx2;
+        rle_remap_fn = rle_remap_avx2;
+    }
+    else if (sse41_available())
+    {
+        log_verbose("registering SSE4.1 RLE functions");
+        rle_copy_fn = rle_copy_sse4_1;
+        rle_remap_fn = rle_remap_sse4_1;
+    }
+    else
+    {
+        log_verbose("registering scalar RLE functions");
+        rle_copy_fn = rle_copy_scalar;
+        rle_remap_fn = rle_remap_scalar;
+    }
+}
+
 void gfx_draw_pixel(rct_drawpixelinfo* dpi, const ScreenCoordsXY& coords, int32_t colour)
 {
     gfx_fill_rect(dpi, { coords, coords }, colour);
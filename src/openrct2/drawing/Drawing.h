@@ -11,11 +11,14 @@
 #define _DRAWING_H_
 
 #include "../common.h"
+#include "../core/MemoryMappedFile.h"
 #include "../interface/Colour.h"
 #include "../interface/ZoomLevel.hpp"
 #include "../world/Location.hpp"
 #include "Text.h"
 
+#include <functional>
+#include <memory>
 #include <optional>
 #include <vector>
 
@@ -97,7 +100,7 @@ struct rct_gx
 {
     rct_g1_header header;
     std::vector<rct_g1_element> elements;
-    void* data;
+    std::unique_ptr<OpenRCT2::MemoryMappedFile> file;
 };
 
 struct rct_drawpixelinfo
@@ -145,6 +148,7 @@ enum
     G1_FLAG_PALETTE = (1 << 3),         // Image data is a sequence of palette entries R8G8B8
     G1_FLAG_HAS_ZOOM_SPRITE = (1 << 4), // Use a different sprite for higher zoom levels
     G1_FLAG_NO_ZOOM_DRAW = (1 << 5),    // Does not get drawn at higher zoom levels (only zoom 0)
+    G1_FLAG_ON_DEMAND = (1 << 6),       // Image data is read when the image is first drawn, see gfx_lazy_images_add
 };
 
 enum : uint32_t
@@ -526,6 +530,12 @@ public:
     uint8_t& operator[](size_t index);
     uint8_t operator[](size_t index) const;
     uint8_t Blend(uint8_t src, uint8_t dst) const;
+
+    /**
+     * Returns the first 256 entries as a flat lookup table, or nullptr if the map is too short to be indexed by any
+     * 8-bit value without bounds checking.
+     */
+    const uint8_t* GetTable() const;
     void Copy(size_t dstIndex, const PaletteMap& src, size_t srcIndex, size_t length);
 };
 
@@ -710,7 +720,13 @@ const rct_g1_element* gfx_get_g1_element(ImageId imageId);
 const rct_g1_element* gfx_get_g1_element(int32_t image_id);
 void gfx_set_g1_element(int32_t imageId, const rct_g1_element* g1);
 bool is_csg_loaded();
+/**
+ * Reads the data of images that are loaded on demand, the offsets of the images are relative to the start of the data.
+ */
+using ImageDataLoader = std::function<std::vector<uint8_t>()>;
+
 uint32_t gfx_object_allocate_images(const rct_g1_element* images, uint32_t count);
+uint32_t gfx_object_allocate_images(const rct_g1_element* images, uint32_t count, ImageDataLoader loadData);
 void gfx_object_free_images(uint32_t baseImageId, uint32_t count);
 void gfx_object_check_all_images_freed();
 size_t ImageListGetUsedCount();
@@ -718,6 +734,15 @@ size_t ImageListGetMaximum();
 void FASTCALL gfx_sprite_to_buffer(DrawSpriteArgs& args);
 void FASTCALL gfx_bmp_sprite_to_buffer(DrawSpriteArgs& args);
 void FASTCALL gfx_rle_sprite_to_buffer(DrawSpriteArgs& args);
+// Set to false to draw zoomed out RLE sprites on this thread from their full resolution data only
+extern thread_local bool gUseRLELodCache;
+void gfx_rle_lod_invalidate(uint32_t imageIndex);
+void gfx_rle_lod_clear();
+void gfx_lazy_images_add(uint32_t baseImageIndex, const rct_g1_element* images, uint32_t count, ImageDataLoader loadData);
+void gfx_lazy_images_remove(uint32_t baseImageIndex);
+const rct_g1_element* gfx_lazy_images_get(uint32_t imageIndex);
+void gfx_lazy_images_update();
+bool gfx_lazy_images_load_requested();
 void FASTCALL gfx_draw_sprite(rct_drawpixelinfo* dpi, int32_t image_id, const ScreenCoordsXY& coords, uint32_t tertiary_colour);
 void FASTCALL
     gfx_draw_glyph(rct_drawpixelinfo* dpi, int32_t image_id, const ScreenCoordsXY& coords, const PaletteMap& paletteMap);
@@ -792,6 +817,22 @@ extern void (*mask_fn)(
     int32_t width, int32_t height, const uint8_t* RESTRICT maskSrc, const uint8_t* RESTRICT colourSrc, uint8_t* RESTRICT dst,
     int32_t maskWrap, int32_t colourWrap, int32_t dstWrap);
 
+// RLE run kernels: blit every srcStep'th pixel of a run of srcLength source pixels, skipping transparent (0) pixels.
+void rle_copy_scalar(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcLength, int32_t srcStep);
+void rle_copy_sse4_1(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcLength, int32_t srcStep);
+void rle_copy_avx2(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcLength, int32_t srcStep);
+void rle_remap_scalar(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t srcLength, int32_t srcStep);
+void rle_remap_sse4_1(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t srcLength, int32_t srcStep);
+void rle_remap_avx2(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t srcLength, int32_t srcStep);
+void rle_init();
+
+extern void (*rle_copy_fn)(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcLength, int32_t srcStep);
+extern void (*rle_remap_fn)(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t srcLength, int32_t srcStep);
+
 std::optional<uint32_t> GetPaletteG1Index(colour_t paletteId);
 std::optional<PaletteMap> GetPaletteMapForColour(colour_t paletteId);
 
@@ -204,7 +204,42 @@ uint32_t gfx_object_allocate_images(const rct_g1_element* images, uint32_t count
     uint32_t imageId = baseImageId;
     for (uint32_t i = 0; i < count; i++)
     {
-        gfx_set_g1_element(imageId, &images[i]);
+        rct_g1_element g1 = images[i];
+        g1.flags &= ~G1_FLAG_ON_DEMAND;
+        gfx_set_g1_element(imageId, &g1);
+        drawing_engine_invalidate_image(imageId);
+        imageId++;
+    }
+
+    return baseImageId;
+}
+
+/**
+ * Allocates images whose data is only read by loadData once one of them is drawn, the offsets of the images are
+ * relative to the start of that data.
+ */
+uint32_t gfx_object_allocate_images(const rct_g1_element* images, uint32_t count, ImageDataLoader loadData)
+{
+    if (count == 0 || gOpenRCT2NoGraphics)
+    {
+        return INVALID_IMAGE_ID;
+    }
+
+    uint32_t baseImageId = AllocateImageList(count);
+    if (baseImageId == INVALID_IMAGE_ID)
+    {
+        log_error("Reached maximum image limit.");
+        return INVALID_IMAGE_ID;
+    }
+
+    gfx_lazy_images_add(baseImageId, images, count, std::move(loadData));
+    uint32_t imageId = baseImageId;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        rct_g1_element g1 = images[i];
+        g1.offset = nullptr;
+        g1.flags |= G1_FLAG_ON_DEMAND;
+        gfx_set_g1_element(imageId, &g1);
         drawing_engine_invalidate_image(imageId);
         imageId++;
     }
@@ -216,6 +251,8 @@ void gfx_object_free_images(uint32_t baseImageId, uint32_t count)
 {
     if (baseImageId != 0 && baseImageId != INVALID_IMAGE_ID)
     {
+        gfx_lazy_images_remove(baseImageId);
+
         // Zero the G1 elements so we don't have invalid pointers
         // and data lying about
         for (uint32_t i = 0; i < count; i++)
@@ -10,6 +10,7 @@
 #include "ImageImporter.h"
 
 #include "../core/Imaging.h"
+#include "../util/Util.h"
 
 #include <cstring>
 #include <stdexcept>
@@ -20,6 +21,27 @@ using ImportResult = ImageImporter::ImportResult;
 
 constexpr int32_t PALETTE_TRANSPARENT = -1;
 
+struct ImageImporterFunctions
+{
+    int32_t (*GetPaletteIndex)(const int16_t* colour);
+    int32_t (*GetClosestPaletteIndex)(const int16_t* colour);
+};
+
+static const ImageImporterFunctions& image_importer_get_functions()
+{
+    // Images are imported from worker threads as well, so this is selected on first use
+    static const ImageImporterFunctions functions = []() -> ImageImporterFunctions {
+        if (sse41_available())
+        {
+            log_verbose("registering SSE4.1 image importer functions");
+            return { image_importer_get_palette_index_sse4_1, image_importer_get_closest_palette_index_sse4_1 };
+        }
+        log_verbose("registering scalar image importer functions");
+        return { image_importer_get_palette_index_scalar, image_importer_get_closest_palette_index_scalar };
+    }();
+    return functions;
+}
+
 ImportResult ImageImporter::Import(
     const Image& image, int32_t offsetX, int32_t offsetY, IMPORT_FLAGS flags, IMPORT_MODE mode) const
 {
@@ -216,17 +238,17 @@ int32_t ImageImporter::CalculatePaletteIndex(
     IMPORT_MODE mode, int16_t* rgbaSrc, int32_t x, int32_t y, int32_t width, int32_t height)
 {
     auto& palette = StandardPalette;
-    auto paletteIndex = GetPaletteIndex(palette, rgbaSrc);
+    auto paletteIndex = GetPaletteIndex(rgbaSrc);
     if (mode == IMPORT_MODE::CLOSEST || mode == IMPORT_MODE::DITHERING)
     {
         if (paletteIndex == PALETTE_TRANSPARENT && !IsTransparentPixel(rgbaSrc))
         {
-            paletteIndex = GetClosestPaletteIndex(palette, rgbaSrc);
+            paletteIndex = GetClosestPaletteIndex(rgbaSrc);
         }
     }
     if (mode == IMPORT_MODE::DITHERING)
     {
-        if (!IsTransparentPixel(rgbaSrc) && IsChangablePixel(GetPaletteIndex(palette, rgbaSrc)))
+        if (!IsTransparentPixel(rgbaSrc) && IsChangablePixel(GetPaletteIndex(rgbaSrc)))
         {
             auto dr = rgbaSrc[0] - static_cast<int16_t>(palette[paletteIndex].Red);
             auto dg = rgbaSrc[1] - static_cast<int16_t>(palette[paletteIndex].Green);
@@ -234,7 +256,7 @@ int32_t ImageImporter::CalculatePaletteIndex(
 
             if (x + 1 < width)
             {
-                if (!IsTransparentPixel(rgbaSrc + 4) && IsChangablePixel(GetPaletteIndex(palette, rgbaSrc + 4)))
+                if (!IsTransparentPixel(rgbaSrc + 4) && IsChangablePixel(GetPaletteIndex(rgbaSrc + 4)))
                 {
                     // Right
                     rgbaSrc[4] += dr * 7 / 16;
@@ -248,7 +270,7 @@ int32_t ImageImporter::CalculatePaletteIndex(
                 if (x > 0)
                 {
                     if (!IsTransparentPixel(rgbaSrc + 4 * (width - 1))
-                        && IsChangablePixel(GetPaletteIndex(palette, rgbaSrc + 4 * (width - 1))))
+                        && IsChangablePixel(GetPaletteIndex(rgbaSrc + 4 * (width - 1))))
                     {
                         // Bottom left
                         rgbaSrc[4 * (width - 1)] += dr * 3 / 16;
@@ -258,7 +280,7 @@ int32_t ImageImporter::CalculatePaletteIndex(
                 }
 
                 // Bottom
-                if (!IsTransparentPixel(rgbaSrc + 4 * width) && IsChangablePixel(GetPaletteIndex(palette, rgbaSrc + 4 * width)))
+                if (!IsTransparentPixel(rgbaSrc + 4 * width) && IsChangablePixel(GetPaletteIndex(rgbaSrc + 4 * width)))
                 {
                     rgbaSrc[4 * width] += dr * 5 / 16;
                     rgbaSrc[4 * width + 1] += dg * 5 / 16;
@@ -268,7 +290,7 @@ int32_t ImageImporter::CalculatePaletteIndex(
                 if (x + 1 < width)
                 {
                     if (!IsTransparentPixel(rgbaSrc + 4 * (width + 1))
-                        && IsChangablePixel(GetPaletteIndex(palette, rgbaSrc + 4 * (width + 1))))
+                        && IsChangablePixel(GetPaletteIndex(rgbaSrc + 4 * (width + 1))))
                     {
                         // Bottom right
                         rgbaSrc[4 * (width + 1)] += dr * 1 / 16;
@@ -282,18 +304,11 @@ int32_t ImageImporter::CalculatePaletteIndex(
     return paletteIndex;
 }
 
-int32_t ImageImporter::GetPaletteIndex(const GamePalette& palette, int16_t* colour)
+int32_t ImageImporter::GetPaletteIndex(const int16_t* colour)
 {
     if (!IsTransparentPixel(colour))
     {
-        for (int32_t i = 0; i < PALETTE_SIZE; i++)
-        {
-            if (static_cast<int16_t>(palette[i].Red) == colour[0] && static_cast<int16_t>(palette[i].Green) == colour[1]
-                && static_cast<int16_t>(palette[i].Blue) == colour[2])
-            {
-                return i;
-            }
-        }
+        return image_importer_get_functions().GetPaletteIndex(colour);
     }
     return PALETTE_TRANSPARENT;
 }
@@ -323,13 +338,33 @@ bool ImageImporter::IsChangablePixel(int32_t paletteIndex)
     return true;
 }
 
-int32_t ImageImporter::GetClosestPaletteIndex(const GamePalette& palette, const int16_t* colour)
+int32_t ImageImporter::GetClosestPaletteIndex(const int16_t* colour)
+{
+    return image_importer_get_functions().GetClosestPaletteIndex(colour);
+}
+
+int32_t image_importer_get_palette_index_scalar(const int16_t* colour)
+{
+    const auto& palette = StandardPalette;
+    for (int32_t i = 0; i < PALETTE_SIZE; i++)
+    {
+        if (static_cast<int16_t>(palette[i].Red) == colour[0] && static_cast<int16_t>(palette[i].Green) == colour[1]
+            && static_cast<int16_t>(palette[i].Blue) == colour[2])
+        {
+            return i;
+        }
+    }
+    return PALETTE_TRANSPARENT;
+}
+
+int32_t image_importer_get_closest_palette_index_scalar(const int16_t* colour)
 {
+    const auto& palette = StandardPalette;
     auto smallestError = static_cast<uint32_t>(-1);
     auto bestMatch = PALETTE_TRANSPARENT;
     for (int32_t x = 0; x < PALETTE_SIZE; x++)
     {
-        if (IsChangablePixel(x))
+        if (ImageImporter::IsChangablePixel(x))
         {
             uint32_t error = (static_cast<int16_t>(palette[x].Red) - colour[0])
                     * (static_cast<int16_t>(palette[x].Red) - colour[0])
@@ -49,6 +49,8 @@ namespace OpenRCT2::Drawing
             const Image& image, int32_t offsetX = 0, int32_t offsetY = 0, IMPORT_FLAGS flags = IMPORT_FLAGS::NONE,
             IMPORT_MODE mode = IMPORT_MODE::DEFAULT) const;
 
+        static bool IsChangablePixel(int32_t paletteIndex);
+
     private:
         static std::vector<int32_t> GetPixels(
             const uint8_t* pixels, uint32_t width, uint32_t height, IMPORT_FLAGS flags, IMPORT_MODE mode);
@@ -57,13 +59,19 @@ namespace OpenRCT2::Drawing
 
         static int32_t CalculatePaletteIndex(
             IMPORT_MODE mode, int16_t* rgbaSrc, int32_t x, int32_t y, int32_t width, int32_t height);
-        static int32_t GetPaletteIndex(const GamePalette& palette, int16_t* colour);
+        static int32_t GetPaletteIndex(const int16_t* colour);
         static bool IsTransparentPixel(const int16_t* colour);
-        static bool IsChangablePixel(int32_t paletteIndex);
-        static int32_t GetClosestPaletteIndex(const GamePalette& palette, const int16_t* colour);
+        static int32_t GetClosestPaletteIndex(const int16_t* colour);
     };
 } // namespace OpenRCT2::Drawing
 
+// Searches of StandardPalette used by the importer, selected at runtime by the available instruction sets. The scalar
+// versions define the results, the vectorised ones have to match them exactly.
+int32_t image_importer_get_palette_index_scalar(const int16_t* colour);
+int32_t image_importer_get_palette_index_sse4_1(const int16_t* colour);
+int32_t image_importer_get_closest_palette_index_scalar(const int16_t* colour);
+int32_t image_importer_get_closest_palette_index_sse4_1(const int16_t* colour);
+
 constexpr const GamePalette StandardPalette = { {
     // 0 (unused)
     { 0, 0, 0, 255 },
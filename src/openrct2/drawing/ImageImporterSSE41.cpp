@@ -0,0 +1,134 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "../common.h"
+#include "../core/Guard.hpp"
+#include "../util/Util.h"
+#include "ImageImporter.h"
+
+#ifdef __SSE4_1__
+
+#    include <immintrin.h>
+
+using namespace OpenRCT2::Drawing;
+
+// StandardPalette split into one array per channel, so that a register holds the same channel of several entries
+struct PaletteChannels
+{
+    alignas(16) int16_t Red16[PALETTE_SIZE];
+    alignas(16) int16_t Green16[PALETTE_SIZE];
+    alignas(16) int16_t Blue16[PALETTE_SIZE];
+    alignas(16) int32_t Red32[PALETTE_SIZE];
+    alignas(16) int32_t Green32[PALETTE_SIZE];
+    alignas(16) int32_t Blue32[PALETTE_SIZE];
+    // All bits set for entries that are used for remapping, which the closest match must not be
+    alignas(16) int32_t Excluded[PALETTE_SIZE];
+};
+
+static const PaletteChannels& get_palette_channels()
+{
+    static const PaletteChannels channels = []() {
+        PaletteChannels result{};
+        for (int32_t i = 0; i < PALETTE_SIZE; i++)
+        {
+            result.Red16[i] = StandardPalette[i].Red;
+            result.Green16[i] = StandardPalette[i].Green;
+            result.Blue16[i] = StandardPalette[i].Blue;
+            result.Red32[i] = StandardPalette[i].Red;
+            result.Green32[i] = StandardPalette[i].Green;
+            result.Blue32[i] = StandardPalette[i].Blue;
+            result.Excluded[i] = ImageImporter::IsChangablePixel(i) ? 0 : -1;
+        }
+        return result;
+    }();
+    return channels;
+}
+
+int32_t image_importer_get_palette_index_sse4_1(const int16_t* colour)
+{
+    const auto& channels = get_palette_channels();
+    const __m128i red = _mm_set1_epi16(colour[0]);
+    const __m128i green = _mm_set1_epi16(colour[1]);
+    const __m128i blue = _mm_set1_epi16(colour[2]);
+    for (int32_t i = 0; i < PALETTE_SIZE; i += 8)
+    {
+        const __m128i paletteRed = _mm_load_si128(reinterpret_cast<const __m128i*>(channels.Red16 + i));
+        const __m128i paletteGreen = _mm_load_si128(reinterpret_cast<const __m128i*>(channels.Green16 + i));
+        const __m128i paletteBlue = _mm_load_si128(reinterpret_cast<const __m128i*>(channels.Blue16 + i));
+        const __m128i equal = _mm_and_si128(
+            _mm_and_si128(_mm_cmpeq_epi16(paletteRed, red), _mm_cmpeq_epi16(paletteGreen, green)),
+            _mm_cmpeq_epi16(paletteBlue, blue));
+        int32_t equalMask = _mm_movemask_epi8(equal);
+        if (equalMask != 0)
+        {
+            // Two mask bits per entry
+            return i + bitscanforward(equalMask) / 2;
+        }
+    }
+    return -1;
+}
+
+int32_t image_importer_get_closest_palette_index_sse4_1(const int16_t* colour)
+{
+    const auto& channels = get_palette_channels();
+    const __m128i red = _mm_set1_epi32(colour[0]);
+    const __m128i green = _mm_set1_epi32(colour[1]);
+    const __m128i blue = _mm_set1_epi32(colour[2]);
+
+    // First find the smallest error, excluded entries get the largest possible error
+    alignas(16) uint32_t errors[PALETTE_SIZE];
+    __m128i smallestError = _mm_set1_epi32(-1);
+    for (int32_t i = 0; i < PALETTE_SIZE; i += 4)
+    {
+        const __m128i dr = _mm_sub_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(channels.Red32 + i)), red);
+        const __m128i dg = _mm_sub_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(channels.Green32 + i)), green);
+        const __m128i db = _mm_sub_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(channels.Blue32 + i)), blue);
+        __m128i error = _mm_add_epi32(
+            _mm_add_epi32(_mm_mullo_epi32(dr, dr), _mm_mullo_epi32(dg, dg)), _mm_mullo_epi32(db, db));
+        error = _mm_or_si128(error, _mm_load_si128(reinterpret_cast<const __m128i*>(channels.Excluded + i)));
+        _mm_store_si128(reinterpret_cast<__m128i*>(errors + i), error);
+        smallestError = _mm_min_epu32(smallestError, error);
+    }
+    smallestError = _mm_min_epu32(smallestError, _mm_shuffle_epi32(smallestError, _MM_SHUFFLE(1, 0, 3, 2)));
+    smallestError = _mm_min_epu32(smallestError, _mm_shuffle_epi32(smallestError, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    // Then return the first entry with that error, like the scalar version does
+    for (int32_t i = 0; i < PALETTE_SIZE; i += 4)
+    {
+        const __m128i error = _mm_load_si128(reinterpret_cast<const __m128i*>(errors + i));
+        const __m128i excluded = _mm_load_si128(reinterpret_cast<const __m128i*>(channels.Excluded + i));
+        const __m128i match = _mm_andnot_si128(excluded, _mm_cmpeq_epi32(error, smallestError));
+        int32_t matchMask = _mm_movemask_ps(_mm_castsi128_ps(match));
+        if (matchMask != 0)
+        {
+            return i + bitscanforward(matchMask);
+        }
+    }
+    return -1;
+}
+
+#else
+
+#    ifdef OPENRCT2_X86
+#        error You have to compile this file with SSE4.1 enabled, when targetting x86!
+#    endif
+
+int32_t image_importer_get_palette_index_sse4_1(const int16_t* colour)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+    return -1;
+}
+
+int32_t image_importer_get_closest_palette_index_sse4_1(const int16_t* colour)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+    return -1;
+}
+
+#endif // __SSE4_1__
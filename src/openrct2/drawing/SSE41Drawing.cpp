@@ -56,6 +56,110 @@ void mask_sse4_1(
     }
 }
 
+// Loads 16 pixels, taking every TStep'th byte from src. Reads exactly 16 * TStep bytes.
+template<int32_t TStep> static __m128i load_strided_sse4_1(const uint8_t* src)
+{
+    if constexpr (TStep == 1)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    }
+    else if constexpr (TStep == 2)
+    {
+        const __m128i lowBytes = _mm_set1_epi16(0x00FF);
+        const __m128i a = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)), lowBytes);
+        const __m128i b = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16)), lowBytes);
+        return _mm_packus_epi16(a, b);
+    }
+    else
+    {
+        static_assert(TStep == 4);
+        const __m128i lowBytes = _mm_set1_epi32(0x000000FF);
+        const __m128i a = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)), lowBytes);
+        const __m128i b = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16)), lowBytes);
+        const __m128i c = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32)), lowBytes);
+        const __m128i d = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48)), lowBytes);
+        // _mm_packus_epi32 is SSE4.1
+        return _mm_packus_epi16(_mm_packus_epi32(a, b), _mm_packus_epi32(c, d));
+    }
+}
+
+template<int32_t TStep>
+static void rle_copy_sse4_1_impl(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcLength)
+{
+    const __m128i zero128 = {};
+    int32_t i = 0;
+    for (; (i + 16) * TStep <= srcLength; i += 16)
+    {
+        const __m128i colour = load_strided_sse4_1<TStep>(src + i * TStep);
+        const __m128i dest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        const __m128i transparent = _mm_cmpeq_epi8(colour, zero128);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_blendv_epi8(colour, dest, transparent));
+    }
+    rle_copy_scalar(src + i * TStep, dst + i, srcLength - i * TStep, TStep);
+}
+
+template<int32_t TStep>
+static void rle_remap_sse4_1_impl(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t srcLength)
+{
+    const __m128i zero128 = {};
+    int32_t i = 0;
+    for (; (i + 16) * TStep <= srcLength; i += 16)
+    {
+        // Shuffle based lookups of a 256 entry table cost more than plain loads, so only the masking is vectorised
+        alignas(16) uint8_t colours[16];
+        for (int32_t j = 0; j < 16; j++)
+        {
+            colours[j] = table[src[(i + j) * TStep]];
+        }
+        const __m128i indices = load_strided_sse4_1<TStep>(src + i * TStep);
+        const __m128i colour = _mm_load_si128(reinterpret_cast<const __m128i*>(colours));
+        const __m128i dest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        const __m128i transparent = _mm_or_si128(_mm_cmpeq_epi8(indices, zero128), _mm_cmpeq_epi8(colour, zero128));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_blendv_epi8(colour, dest, transparent));
+    }
+    rle_remap_scalar(src + i * TStep, dst + i, table, srcLength - i * TStep, TStep);
+}
+
+void rle_copy_sse4_1(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcLength, int32_t srcStep)
+{
+    switch (srcStep)
+    {
+        case 1:
+            rle_copy_sse4_1_impl<1>(src, dst, srcLength);
+            break;
+        case 2:
+            rle_copy_sse4_1_impl<2>(src, dst, srcLength);
+            break;
+        case 4:
+            rle_copy_sse4_1_impl<4>(src, dst, srcLength);
+            break;
+        default:
+            rle_copy_scalar(src, dst, srcLength, srcStep);
+            break;
+    }
+}
+
+void rle_remap_sse4_1(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t srcLength, int32_t srcStep)
+{
+    switch (srcStep)
+    {
+        case 1:
+            rle_remap_sse4_1_impl<1>(src, dst, table, srcLength);
+            break;
+        case 2:
+            rle_remap_sse4_1_impl<2>(src, dst, table, srcLength);
+            break;
+        case 4:
+            rle_remap_sse4_1_impl<4>(src, dst, table, srcLength);
+            break;
+        default:
+            rle_remap_scalar(src, dst, table, srcLength, srcStep);
+            break;
+    }
+}
+
 #else
 
 #    ifdef OPENRCT2_X86
@@ -69,4 +173,15 @@ void mask_sse4_1(
     openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
 }
 
+void rle_copy_sse4_1(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, int32_t srcLength, int32_t srcStep)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+}
+
+void rle_remap_sse4_1(
+    const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, const uint8_t* RESTRICT table, int32_t srcLength, int32_t srcStep)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+}
+
 #endif // __SSE4_1__
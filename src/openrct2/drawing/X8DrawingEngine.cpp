@@ -13,9 +13,11 @@
 #include "../Game.h"
 #include "../Intro.h"
 #include "../config/Config.h"
+#include "../core/JobPool.hpp"
 #include "../interface/Screenshot.h"
 #include "../interface/Viewport.h"
 #include "../interface/Window.h"
+#include "../interface/Window_internal.h"
 #include "../ui/UiContext.h"
 #include "../world/Climate.h"
 #include "Drawing.h"
@@ -25,12 +27,16 @@
 #include "Weather.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 
 using namespace OpenRCT2;
 using namespace OpenRCT2::Drawing;
 using namespace OpenRCT2::Ui;
 
+// Width in dirty blocks of the strips handed to each draw job
+static constexpr uint32_t ParallelStripColumns = 2;
+
 X8WeatherDrawer::X8WeatherDrawer()
 {
     _weatherPixels = new WeatherPixel[_weatherPixelsCapacity];
@@ -122,7 +128,6 @@ void X8WeatherDrawer::Restore()
 
 X8DrawingEngine::X8DrawingEngine([[maybe_unused]] const std::shared_ptr<Ui::IUiContext>& uiContext)
 {
-    _drawingContext = new X8DrawingContext(this);
     _bitsDPI.DrawingEngine = this;
 #ifdef __ENABLE_LIGHTFX__
     lightfx_set_available(true);
@@ -132,7 +137,6 @@ X8DrawingEngine::X8DrawingEngine([[maybe_unused]] const std::shared_ptr<Ui::IUiC
 
 X8DrawingEngine::~X8DrawingEngine()
 {
-    delete _drawingContext;
     delete[] _dirtyGrid.Blocks;
     delete[] _bits;
 }
@@ -210,6 +214,9 @@ void X8DrawingEngine::EndDraw()
 
 void X8DrawingEngine::PaintWindows()
 {
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    _dirtyStats = {};
+
     window_reset_visibilities();
 
     // Redraw dirty regions before updating the viewports, otherwise
@@ -217,6 +224,10 @@ void X8DrawingEngine::PaintWindows()
     DrawAllDirtyBlocks();
     window_update_all_viewports();
     DrawAllDirtyBlocks();
+
+    const auto endTime = std::chrono::high_resolution_clock::now();
+    _dirtyStats.FrameTime = std::chrono::duration<double>(endTime - startTime).count();
+    _lastDirtyStats = _dirtyStats;
 }
 
 void X8DrawingEngine::UpdateWindows()
@@ -276,8 +287,11 @@ std::string X8DrawingEngine::Screenshot()
 
 IDrawingContext* X8DrawingEngine::GetDrawingContext(rct_drawpixelinfo* dpi)
 {
-    _drawingContext->SetDPI(dpi);
-    return _drawingContext;
+    // Parts of the screen may be drawn from several threads at once, so each thread needs its own context
+    static thread_local X8DrawingContext drawingContext(nullptr);
+    drawingContext = X8DrawingContext(this);
+    drawingContext.SetDPI(dpi);
+    return &drawingContext;
 }
 
 rct_drawpixelinfo* X8DrawingEngine::GetDrawingPixelInfo()
@@ -300,6 +314,11 @@ rct_drawpixelinfo* X8DrawingEngine::GetDPI()
     return &_bitsDPI;
 }
 
+const DirtyDrawStats& X8DrawingEngine::GetDirtyDrawStats() const
+{
+    return _lastDirtyStats;
+}
+
 void X8DrawingEngine::ConfigureBits(uint32_t width, uint32_t height, uint32_t pitch)
 {
     size_t newBitsSize = pitch * height;
@@ -379,11 +398,78 @@ void X8DrawingEngine::ConfigureDirtyGrid()
 
 void X8DrawingEngine::DrawAllDirtyBlocks()
 {
-    for (uint32_t x = 0; x < _dirtyGrid.BlockColumns; x++)
+    CollectDirtyRects();
+    if (_dirtyRects.empty())
+    {
+        return;
+    }
+
+    bool useMultithreading = gConfigGeneral.multithreading;
+    if (useMultithreading && _drawJobs == nullptr)
+    {
+        _drawJobs = std::make_unique<JobPool>();
+    }
+    else if (useMultithreading == false && _drawJobs != nullptr)
+    {
+        _drawJobs.reset();
+    }
+
+    // Only the main viewport is safe to render off the main thread, other windows update their own state while painting
+    rct_window* mainWindow = useMultithreading ? window_get_main() : nullptr;
+    if (mainWindow != nullptr && mainWindow->viewport == nullptr)
     {
-        for (uint32_t y = 0; y < _dirtyGrid.BlockRows; y++)
+        mainWindow = nullptr;
+    }
+
+    // Other rectangles are drawn once the strip jobs are done, drawing windows shares text and image state with them
+    std::vector<const DirtyRect*> mainThreadRects;
+    bool hasParallelWork = false;
+    for (const auto& rect : _dirtyRects)
+    {
+        auto bounds = GetDirtyRectBounds(rect);
+        if (bounds.GetWidth() <= 0 || bounds.GetHeight() <= 0)
+        {
+            continue;
+        }
+
+        OnDrawDirtyBlock(rect.X, rect.Y, rect.Columns, rect.Rows);
+        if (mainWindow != nullptr && IsViewportOnlyRect(mainWindow, bounds))
+        {
+            // Split wide rectangles into strips so a single large region still spreads across the pool
+            for (uint32_t x = rect.X; x < rect.X + rect.Columns; x += ParallelStripColumns)
+            {
+                DirtyRect strip = { x, rect.Y, std::min(ParallelStripColumns, rect.X + rect.Columns - x), rect.Rows };
+                auto stripBounds = GetDirtyRectBounds(strip);
+                _drawJobs->AddTask([this, mainWindow, stripBounds]() -> void { DrawViewportBlocks(mainWindow, stripBounds); });
+                _dirtyStats.ParallelJobs++;
+            }
+            hasParallelWork = true;
+        }
+        else
+        {
+            mainThreadRects.push_back(&rect);
+        }
+    }
+
+    if (hasParallelWork)
+    {
+        _drawJobs->Join();
+        viewport_paint_deferred_text();
+    }
+    for (const auto* rect : mainThreadRects)
+    {
+        DrawDirtyBlocks(*rect);
+    }
+}
+
+void X8DrawingEngine::CollectDirtyRects()
+{
+    _dirtyRects.clear();
+    for (uint32_t y = 0; y < _dirtyGrid.BlockRows; y++)
+    {
+        uint32_t yOffset = y * _dirtyGrid.BlockColumns;
+        for (uint32_t x = 0; x < _dirtyGrid.BlockColumns; x++)
         {
-            uint32_t yOffset = y * _dirtyGrid.BlockColumns;
             if (_dirtyGrid.Blocks[yOffset + x] == 0)
             {
                 continue;
@@ -402,7 +488,13 @@ void X8DrawingEngine::DrawAllDirtyBlocks()
             // Check rows
             uint32_t columns = xx - x;
             auto rows = GetNumDirtyRows(x, y, columns);
-            DrawDirtyBlocks(x, y, columns, rows);
+            DirtyRect rect = { x, y, columns, rows };
+            ClearDirtyBlocks(rect);
+            _dirtyRects.push_back(rect);
+
+            _dirtyStats.DirtyBlocks += columns * rows;
+            _dirtyStats.DirtyRects++;
+            x = xx - 1;
         }
     }
 }
@@ -425,34 +517,61 @@ uint32_t X8DrawingEngine::GetNumDirtyRows(const uint32_t x, const uint32_t y, co
     return yy - y;
 }
 
-void X8DrawingEngine::DrawDirtyBlocks(uint32_t x, uint32_t y, uint32_t columns, uint32_t rows)
+void X8DrawingEngine::ClearDirtyBlocks(const DirtyRect& rect)
 {
     uint32_t dirtyBlockColumns = _dirtyGrid.BlockColumns;
     uint8_t* screenDirtyBlocks = _dirtyGrid.Blocks;
-
-    // Unset dirty blocks
-    for (uint32_t top = y; top < y + rows; top++)
+    for (uint32_t top = rect.Y; top < rect.Y + rect.Rows; top++)
     {
         uint32_t topOffset = top * dirtyBlockColumns;
-        for (uint32_t left = x; left < x + columns; left++)
-        {
-            screenDirtyBlocks[topOffset + left] = 0;
-        }
+        std::fill_n(screenDirtyBlocks + topOffset + rect.X, rect.Columns, 0);
+    }
+}
+
+ScreenRect X8DrawingEngine::GetDirtyRectBounds(const DirtyRect& rect) const
+{
+    int32_t left = rect.X * _dirtyGrid.BlockWidth;
+    int32_t top = rect.Y * _dirtyGrid.BlockHeight;
+    int32_t right = std::min<int32_t>(_width, left + (rect.Columns * _dirtyGrid.BlockWidth));
+    int32_t bottom = std::min<int32_t>(_height, top + (rect.Rows * _dirtyGrid.BlockHeight));
+    return { left, top, right, bottom };
+}
+
+bool X8DrawingEngine::IsViewportOnlyRect(const rct_window* mainWindow, const ScreenRect& bounds) const
+{
+    if (bounds.GetLeft() < mainWindow->windowPos.x || bounds.GetTop() < mainWindow->windowPos.y
+        || bounds.GetRight() > mainWindow->windowPos.x + mainWindow->width
+        || bounds.GetBottom() > mainWindow->windowPos.y + mainWindow->height)
+    {
+        return false;
     }
 
-    // Determine region in pixels
-    uint32_t left = std::max<uint32_t>(0, x * _dirtyGrid.BlockWidth);
-    uint32_t top = std::max<uint32_t>(0, y * _dirtyGrid.BlockHeight);
-    uint32_t right = std::min(_width, left + (columns * _dirtyGrid.BlockWidth));
-    uint32_t bottom = std::min(_height, top + (rows * _dirtyGrid.BlockHeight));
-    if (right <= left || bottom <= top)
+    for (const auto& w : g_window_list)
     {
-        return;
+        if (w.get() == mainWindow)
+            continue;
+        if (bounds.GetRight() <= w->windowPos.x || bounds.GetBottom() <= w->windowPos.y)
+            continue;
+        if (bounds.GetLeft() >= w->windowPos.x + w->width || bounds.GetTop() >= w->windowPos.y + w->height)
+            continue;
+        return false;
     }
+    return true;
+}
+
+void X8DrawingEngine::DrawDirtyBlocks(const DirtyRect& rect)
+{
+    auto bounds = GetDirtyRectBounds(rect);
+    window_draw_all(&_bitsDPI, bounds.GetLeft(), bounds.GetTop(), bounds.GetRight(), bounds.GetBottom());
+}
+
+void X8DrawingEngine::DrawViewportBlocks(rct_window* mainWindow, const ScreenRect& bounds)
+{
+    // Columns of this region are painted on the calling worker, nesting the column job pool would deadlock it
+    viewport_set_inline_paint(true);
 
-    // Draw region
-    OnDrawDirtyBlock(x, y, columns, rows);
-    window_draw_all(&_bitsDPI, left, top, right, bottom);
+    auto dpi = _bitsDPI.Crop(bounds.Point1, { bounds.GetWidth(), bounds.GetHeight() });
+    window_draw_viewport(&dpi, mainWindow);
 }
 
 #ifdef __WARN_SUGGEST_FINAL_METHODS__
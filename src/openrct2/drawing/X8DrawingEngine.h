@@ -10,9 +10,16 @@
 #pragma once
 
 #include "../common.h"
+#include "../world/Location.hpp"
 #include "IDrawingContext.h"
 #include "IDrawingEngine.h"
 
+#include <memory>
+#include <vector>
+
+class JobPool;
+struct rct_window;
+
 namespace OpenRCT2
 {
     namespace Ui
@@ -35,6 +42,28 @@ namespace OpenRCT2
             uint8_t* Blocks;
         };
 
+        /**
+         * A run of dirty blocks coalesced into a rectangle, in block units.
+         */
+        struct DirtyRect
+        {
+            uint32_t X;
+            uint32_t Y;
+            uint32_t Columns;
+            uint32_t Rows;
+        };
+
+        /**
+         * Counters for the dirty region pass of a single frame.
+         */
+        struct DirtyDrawStats
+        {
+            uint32_t DirtyBlocks = 0;
+            uint32_t DirtyRects = 0;
+            uint32_t ParallelJobs = 0;
+            double FrameTime = 0;
+        };
+
         class X8WeatherDrawer final : public IWeatherDrawer
         {
         private:
@@ -75,6 +104,10 @@ namespace OpenRCT2
             uint8_t* _bits = nullptr;
 
             DirtyGrid _dirtyGrid = {};
+            std::vector<DirtyRect> _dirtyRects;
+            std::unique_ptr<JobPool> _drawJobs;
+            DirtyDrawStats _dirtyStats;
+            DirtyDrawStats _lastDirtyStats;
 
             rct_drawpixelinfo _bitsDPI = {};
 
@@ -83,7 +116,6 @@ namespace OpenRCT2
 #endif
 
             X8WeatherDrawer _weatherDrawer;
-            X8DrawingContext* _drawingContext;
 
         public:
             explicit X8DrawingEngine(const std::shared_ptr<Ui::IUiContext>& uiContext);
@@ -116,6 +148,7 @@ namespace OpenRCT2
             void InvalidateImage(uint32_t image) override;
 
             rct_drawpixelinfo* GetDPI();
+            const DirtyDrawStats& GetDirtyDrawStats() const;
 
         protected:
             void ConfigureBits(uint32_t width, uint32_t height, uint32_t pitch);
@@ -125,8 +158,13 @@ namespace OpenRCT2
             void ConfigureDirtyGrid();
             static void ResetWindowVisbilities();
             void DrawAllDirtyBlocks();
+            void CollectDirtyRects();
             uint32_t GetNumDirtyRows(const uint32_t x, const uint32_t y, const uint32_t columns);
-            void DrawDirtyBlocks(uint32_t x, uint32_t y, uint32_t columns, uint32_t rows);
+            void ClearDirtyBlocks(const DirtyRect& rect);
+            ScreenRect GetDirtyRectBounds(const DirtyRect& rect) const;
+            bool IsViewportOnlyRect(const rct_window* mainWindow, const ScreenRect& bounds) const;
+            void DrawDirtyBlocks(const DirtyRect& rect);
+            void DrawViewportBlocks(rct_window* mainWindow, const ScreenRect& bounds);
         };
 #ifdef __WARN_SUGGEST_FINAL_TYPES__
 #    pragma GCC diagnostic pop
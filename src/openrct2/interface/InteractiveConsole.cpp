@@ -27,6 +27,7 @@
 #include "../core/String.hpp"
 #include "../drawing/Drawing.h"
 #include "../drawing/Font.h"
+#include "../drawing/X8DrawingEngine.h"
 #include "../interface/Chat.h"
 #include "../interface/Colour.h"
 #include "../interface/Window_internal.h"
@@ -1261,6 +1262,22 @@ static int32_t cc_show_limits(InteractiveConsole& console, [[maybe_unused]] cons
     return 0;
 }
 
+static int32_t cc_dirty_stats(InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
+{
+    auto drawingEngine = dynamic_cast<OpenRCT2::Drawing::X8DrawingEngine*>(OpenRCT2::GetContext()->GetDrawingEngine());
+    if (drawingEngine == nullptr)
+    {
+        console.WriteLineError("The current drawing engine does not track dirty regions.");
+        return 1;
+    }
+
+    const auto& stats = drawingEngine->GetDirtyDrawStats();
+    console.WriteFormatLine("Dirty blocks: %u", stats.DirtyBlocks);
+    console.WriteFormatLine("Dirty rectangles: %u (%u parallel draw jobs)", stats.DirtyRects, stats.ParallelJobs);
+    console.WriteFormatLine("Frame time: %.3f ms", stats.FrameTime * 1000.0);
+    return 0;
+}
+
 static int32_t cc_for_date([[maybe_unused]] InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
 {
     int32_t year = 0;
@@ -1773,6 +1790,7 @@ static constexpr const console_command console_command_table[] = {
     { "close", cc_close, "Closes the console.", "close" },
     { "date", cc_for_date, "Sets the date to a given date.", "Format <year>[ <month>[ <day>]]." },
     { "dereference", cc_dereference, "Dereferences a nullptr, for testing purposes only", "dereference" },
+    { "dirty_stats", cc_dirty_stats, "Shows dirty region statistics of the last drawn frame.", "dirty_stats" },
     { "echo", cc_echo, "Echoes the text to the console.", "echo <text>" },
     { "exit", cc_close, "Closes the console.", "exit" },
     { "get", cc_get, "Gets the value of the specified variable.", "get <variable>" },
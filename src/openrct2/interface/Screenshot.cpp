@@ -16,11 +16,14 @@
 #include "../actions/SetCheatAction.hpp"
 #include "../audio/audio.h"
 #include "../core/Console.hpp"
+#include "../core/File.h"
 #include "../core/Imaging.h"
+#include "../core/JobPool.hpp"
 #include "../drawing/Drawing.h"
 #include "../drawing/X8DrawingEngine.h"
 #include "../localisation/Localisation.h"
 #include "../platform/Platform2.h"
+#include "../sprites.h"
 #include "../util/Util.h"
 #include "../world/Climate.h"
 #include "../world/Map.h"
@@ -34,6 +37,8 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace std::literals::string_literals;
 using namespace OpenRCT2;
@@ -41,6 +46,9 @@ using namespace OpenRCT2::Drawing;
 
 uint8_t gScreenshotCountdown = 0;
 
+// Number of rows rendered at once when streaming a screenshot to file
+static constexpr int32_t ScreenshotBandHeight = 256;
+
 static bool WriteDpiToFile(const std::string_view& path, const rct_drawpixelinfo* dpi, const GamePalette& palette)
 {
     auto const pixels8 = dpi->bits;
@@ -375,11 +383,129 @@ static void RenderViewport(IDrawingEngine* drawingEngine, const rct_viewport& vi
     }
     dpi.DrawingEngine = drawingEngine;
     viewport_render(&dpi, &viewport, 0, 0, viewport.width, viewport.height);
+
+    // Object images that had not been read yet were left out
+    if (gfx_lazy_images_load_requested())
+    {
+        viewport_render(&dpi, &viewport, 0, 0, viewport.width, viewport.height);
+    }
+}
+
+static void RenderViewportBand(const rct_viewport& viewport, rct_drawpixelinfo& dpi)
+{
+    std::fill_n(dpi.bits, static_cast<size_t>(dpi.width) * dpi.height, PALETTE_INDEX_0);
+    viewport_render(&dpi, &viewport, 0, dpi.y, viewport.width, dpi.y + dpi.height);
+}
+
+/**
+ * Renders the viewport in horizontal bands and streams them into a PNG file. Only one batch of bands is held in memory
+ * at a time, and the bands of a batch are rendered in parallel when multithreading is enabled.
+ */
+static void RenderViewportToPng(const rct_viewport& viewport, const std::string& path, const GamePalette& palette)
+{
+    // Ensure sprites appear regardless of rotation
+    reset_all_sprite_quadrant_placements();
+
+    auto drawingEngine = std::make_unique<X8DrawingEngine>(GetContext()->GetUiContext());
+    auto writer = Imaging::CreatePngRowWriter(path, viewport.width, viewport.height, palette);
+
+    std::unique_ptr<JobPool> jobs;
+    int32_t bandsPerBatch = 1;
+    if (gConfigGeneral.multithreading)
+    {
+        jobs = std::make_unique<JobPool>();
+        bandsPerBatch = std::max<int32_t>(1, std::thread::hardware_concurrency());
+    }
+
+    const size_t bandSize = static_cast<size_t>(viewport.width) * ScreenshotBandHeight;
+    std::vector<uint8_t> bits(bandSize * bandsPerBatch);
+    std::vector<rct_drawpixelinfo> bands;
+    for (int32_t batchTop = 0; batchTop < viewport.height; batchTop += ScreenshotBandHeight * bandsPerBatch)
+    {
+        bands.clear();
+        for (int32_t i = 0; i < bandsPerBatch; i++)
+        {
+            int32_t top = batchTop + (i * ScreenshotBandHeight);
+            if (top >= viewport.height)
+                break;
+
+            rct_drawpixelinfo dpi{};
+            dpi.bits = bits.data() + (i * bandSize);
+            dpi.y = top;
+            dpi.width = viewport.width;
+            dpi.height = std::min(ScreenshotBandHeight, viewport.height - top);
+            dpi.DrawingEngine = drawingEngine.get();
+            bands.push_back(dpi);
+        }
+
+        auto renderBands = [&]() {
+            if (jobs != nullptr)
+            {
+                for (auto& dpi : bands)
+                {
+                    jobs->AddTask([&viewport, &dpi]() -> void {
+                        viewport_set_inline_paint(true);
+                        RenderViewportBand(viewport, dpi);
+                    });
+                }
+                jobs->Join();
+                viewport_paint_deferred_text();
+            }
+            else
+            {
+                for (auto& dpi : bands)
+                {
+                    RenderViewportBand(viewport, dpi);
+                }
+            }
+        };
+
+        // Object images that had not been read yet were left out, read them and render the bands again
+        renderBands();
+        if (gfx_lazy_images_load_requested())
+        {
+            renderBands();
+        }
+
+        for (const auto& dpi : bands)
+        {
+            writer->WriteRows(dpi.bits, dpi.height, dpi.width);
+        }
+
+        // Keep the object images within the cache size while the rest is rendered
+        gfx_lazy_images_update();
+    }
+    writer->Finish();
+}
+
+static void RenderViewportToFile(const rct_viewport& viewport, const std::string_view& path, const GamePalette& palette)
+{
+    if (viewport.width <= 0 || viewport.height <= 0)
+    {
+        throw std::runtime_error("Screenshot failed, the image has no size.");
+    }
+
+    // The image is moved into place once it is complete, so a failed screenshot does not leave a truncated file
+    auto dstPath = std::string(path);
+    auto tempPath = File::GetTemporaryPath(dstPath);
+    try
+    {
+        RenderViewportToPng(viewport, tempPath, palette);
+    }
+    catch (const std::exception&)
+    {
+        File::Delete(tempPath);
+        throw;
+    }
+    if (!File::Replace(tempPath, dstPath))
+    {
+        File::Delete(tempPath);
+        throw std::runtime_error("Screenshot failed, unable to write the image.");
+    }
 }
 
 void screenshot_giant()
 {
-    rct_drawpixelinfo dpi{};
     try
     {
         auto path = screenshot_get_next_path();
@@ -408,10 +534,7 @@ void screenshot_giant()
             viewport.flags |= VIEWPORT_FLAG_TRANSPARENT_BACKGROUND;
         }
 
-        dpi = CreateDPI(viewport);
-
-        RenderViewport(nullptr, viewport, dpi);
-        WriteDpiToFile(path->c_str(), &dpi, gPalette);
+        RenderViewportToFile(viewport, *path, gPalette);
 
         // Show user that screenshot saved successfully
         Formatter ft;
@@ -424,8 +547,6 @@ void screenshot_giant()
         log_error("%s", e.what());
         context_show_error(STR_SCREENSHOT_FAILED, STR_NONE, {});
     }
-
-    ReleaseDPI(dpi);
 }
 
 // TODO: Move this at some point into a more appropriate place.
@@ -516,6 +637,88 @@ static void benchgfx_render_screenshots(const char* inputPath, std::unique_ptr<I
         ReleaseDPI(dpi);
 }
 
+static void benchgfx_blit_sprites(uint32_t iterationCount)
+{
+    struct RLEKernel
+    {
+        const char* Name;
+        bool Available;
+        decltype(rle_copy_fn) Copy;
+        decltype(rle_remap_fn) Remap;
+    };
+    const RLEKernel kernels[] = {
+        { "scalar", true, rle_copy_scalar, rle_remap_scalar },
+        { "SSE4.1", sse41_available(), rle_copy_sse4_1, rle_remap_sse4_1 },
+        { "AVX2", avx2_available(), rle_copy_avx2, rle_remap_avx2 },
+    };
+
+    std::vector<ImageId> images;
+    for (uint32_t i = 0; i < SPR_G1_END; i++)
+    {
+        const auto* g1 = gfx_get_g1_element(i);
+        if (g1 != nullptr && (g1->flags & G1_FLAG_RLE_COMPRESSION))
+        {
+            // Draw every sprite once as-is and once remapped to exercise both kernels
+            images.push_back(ImageId(i));
+            images.push_back(ImageId(i, COLOUR_BRIGHT_RED));
+        }
+    }
+
+    constexpr int32_t MAX_ZOOM_LEVEL = 3;
+    constexpr int16_t CANVAS_SIZE = 256;
+    std::vector<uint8_t> canvas(CANVAS_SIZE * CANVAS_SIZE);
+
+    std::printf("Sprite blits: %zu RLE sprites\n", images.size());
+    for (const auto& kernel : kernels)
+    {
+        if (!kernel.Available)
+            continue;
+
+        rle_copy_fn = kernel.Copy;
+        rle_remap_fn = kernel.Remap;
+        for (int32_t zoom = 0; zoom <= MAX_ZOOM_LEVEL; zoom++)
+        {
+            rct_drawpixelinfo dpi;
+            dpi.bits = canvas.data();
+            dpi.width = CANVAS_SIZE << zoom;
+            dpi.height = CANVAS_SIZE << zoom;
+            dpi.zoom_level = zoom;
+            const ScreenCoordsXY centre{ dpi.width / 2, dpi.height / 2 };
+
+            auto drawAll = [&]() {
+                for (const auto& image : images)
+                {
+                    gfx_draw_sprite_software(&dpi, image, centre);
+                }
+            };
+            auto measure = [&]() {
+                double elapsed = MeasureFunctionTime([&]() {
+                    for (uint32_t i = 0; i < iterationCount; i++)
+                    {
+                        drawAll();
+                    }
+                });
+                return static_cast<double>(images.size()) * iterationCount / elapsed;
+            };
+
+            // Zoomed out sprites are drawn from the reduced sprite cache by default, which bypasses the zoom kernels
+            gUseRLELodCache = false;
+            std::printf("%s zoom[%d]: %.f sprites/s\n", kernel.Name, zoom, measure());
+            gUseRLELodCache = true;
+            if (zoom > 0)
+            {
+                // Fill the cache first, so only drawing the reduced sprites is measured
+                gfx_rle_lod_clear();
+                drawAll();
+                std::printf("%s zoom[%d] cached: %.f sprites/s\n", kernel.Name, zoom, measure());
+            }
+        }
+    }
+
+    // Restore the kernels picked for this CPU
+    rle_init();
+}
+
 int32_t cmdline_for_gfxbench(const char** argv, int32_t argc)
 {
     if (argc != 1 && argc != 2)
@@ -541,6 +744,7 @@ int32_t cmdline_for_gfxbench(const char** argv, int32_t argc)
         drawing_engine_init();
 
         benchgfx_render_screenshots(inputPath, context, iterationCount);
+        benchgfx_blit_sprites(iterationCount);
 
         drawing_engine_dispose();
     }
@@ -624,7 +828,6 @@ int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOption
     }
 
     int32_t exitCode = 1;
-    rct_drawpixelinfo dpi;
     try
     {
         core_init();
@@ -726,17 +929,13 @@ int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOption
 
         ApplyOptions(options, viewport);
 
-        dpi = CreateDPI(viewport);
-
-        RenderViewport(nullptr, viewport, dpi);
-        WriteDpiToFile(outputPath, &dpi, gPalette);
+        RenderViewportToFile(viewport, outputPath, gPalette);
     }
     catch (const std::exception& e)
     {
         std::printf("%s\n", e.what());
         exitCode = -1;
     }
-    ReleaseDPI(dpi);
 
     drawing_engine_dispose();
 
@@ -820,10 +1019,15 @@ void CaptureImage(const CaptureOptions& options)
     gCurrentRotation = options.Rotation;
 
     auto outputPath = ResolveFilenameForCapture(options.Filename);
-    auto dpi = CreateDPI(viewport);
-    RenderViewport(nullptr, viewport, dpi);
-    WriteDpiToFile(outputPath, &dpi, gPalette);
-    ReleaseDPI(dpi);
+    try
+    {
+        RenderViewportToFile(viewport, outputPath, gPalette);
+    }
+    catch (const std::exception&)
+    {
+        gCurrentRotation = backupRotation;
+        throw;
+    }
 
     gCurrentRotation = backupRotation;
 }
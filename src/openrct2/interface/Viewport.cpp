@@ -33,6 +33,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <mutex>
 
 using namespace OpenRCT2;
 
@@ -45,6 +46,11 @@ rct_viewport g_viewport_list[MAX_VIEWPORT_COUNT];
 rct_viewport* g_music_tracking_viewport;
 
 static std::unique_ptr<JobPool> _paintJobs;
+static thread_local bool _paintInline = false;
+
+// Columns painted inline whose money and text are left for viewport_paint_deferred_text
+static std::mutex _deferredTextMutex;
+static std::vector<paint_session*> _deferredTextSessions;
 
 ScreenCoordsXY gSavedView;
 ZoomLevel gSavedViewZoom;
@@ -890,6 +896,13 @@ static void viewport_paint_column(paint_session* session)
 
     if (session->PSStringHead != nullptr)
     {
+        if (_paintInline)
+        {
+            // Text drawing shares its palette and font caches between threads
+            std::lock_guard<std::mutex> lock(_deferredTextMutex);
+            _deferredTextSessions.push_back(session);
+            return;
+        }
         paint_draw_money_structs(&session->DPI, session->PSStringHead);
     }
 
@@ -949,7 +962,12 @@ void viewport_paint(
     std::vector<paint_session*> columns;
 
     bool useMultithreading = gConfigGeneral.multithreading;
-    if (useMultithreading && _paintJobs == nullptr)
+    if (_paintInline)
+    {
+        // The calling thread is already one of several drawing in parallel
+        useMultithreading = false;
+    }
+    else if (useMultithreading && _paintJobs == nullptr)
     {
         _paintJobs = std::make_unique<JobPool>();
     }
@@ -1014,6 +1032,34 @@ void viewport_paint(
     }
 }
 
+/**
+ * Makes viewport_paint on the calling thread generate its columns inline rather than on the paint job pool. Used by
+ * threads that render separate regions of the screen concurrently. The money and text of those columns are not drawn
+ * until viewport_paint_deferred_text is called once the threads are done.
+ */
+void viewport_set_inline_paint(bool value)
+{
+    _paintInline = value;
+}
+
+/**
+ * Draws the money and text of the columns painted inline since the last call, must be called from a single thread
+ * while no viewport is painted inline.
+ */
+void viewport_paint_deferred_text()
+{
+    std::vector<paint_session*> sessions;
+    {
+        std::lock_guard<std::mutex> lock(_deferredTextMutex);
+        sessions.swap(_deferredTextSessions);
+    }
+    for (auto session : sessions)
+    {
+        paint_draw_money_structs(&session->DPI, session->PSStringHead);
+        paint_session_free(session);
+    }
+}
+
 static void viewport_paint_weather_gloom(rct_drawpixelinfo* dpi)
 {
     auto paletteId = climate_get_weather_gloom_palette_id(gClimateCurrent);
@@ -133,6 +133,8 @@ void viewport_render(
 void viewport_paint(
     const rct_viewport* viewport, rct_drawpixelinfo* dpi, int16_t left, int16_t top, int16_t right, int16_t bottom,
     std::vector<paint_session>* sessions = nullptr);
+void viewport_set_inline_paint(bool value);
+void viewport_paint_deferred_text();
 
 CoordsXYZ viewport_adjust_for_map_height(const ScreenCoordsXY& startCoords);
 
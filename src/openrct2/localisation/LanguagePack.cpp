@@ -12,6 +12,7 @@
 #include "../common.h"
 #include "../core/FileStream.hpp"
 #include "../core/Memory.hpp"
+#include "../core/MemoryMappedFile.h"
 #include "../core/RTL.h"
 #include "../core/String.hpp"
 #include "../core/StringBuilder.hpp"
@@ -20,7 +21,9 @@
 #include "Localisation.h"
 
 #include <algorithm>
+#include <cstring>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // Don't try to load more than language files that exceed 64 MiB
@@ -46,6 +49,40 @@ struct ScenarioOverride
     std::string strings[ScenarioOverrideMaxStringCount];
 };
 
+#pragma pack(push, 1)
+struct CompiledLanguagePackHeader
+{
+    uint32_t Magic;
+    uint16_t Version;
+    uint16_t LanguageId;
+    uint64_t SourceModified;
+    uint32_t NumStrings;
+    uint32_t NumObjectOverrides;
+    uint32_t NumScenarioOverrides;
+    uint32_t StringDataLength;
+};
+assert_struct_size(CompiledLanguagePackHeader, 32);
+
+// The strings of the records below are offsets into the string data, offset 0 is the empty string
+struct CompiledObjectOverride
+{
+    char Name[8];
+    uint32_t Strings[ObjectOverrideMaxStringCount];
+};
+assert_struct_size(CompiledObjectOverride, 20);
+
+struct CompiledScenarioOverride
+{
+    uint32_t Filename;
+    uint32_t Strings[ScenarioOverrideMaxStringCount];
+};
+assert_struct_size(CompiledScenarioOverride, 16);
+#pragma pack(pop)
+
+constexpr uint32_t COMPILED_MAGIC_NUMBER = 0x474E4C4F; // OLNG
+// Strings are stored with their format codes converted, so this has to change whenever the format codes do
+constexpr uint16_t COMPILED_VERSION = 1;
+
 class LanguagePack final : public ILanguagePack
 {
 private:
@@ -234,7 +271,73 @@ public:
         return STR_NONE;
     }
 
+    std::vector<uint8_t> Compile(uint64_t sourceModified) const
+    {
+        std::vector<char> stringData(1, '\0');
+        auto addString = [&stringData](const std::string& value) -> uint32_t {
+            if (value.empty())
+            {
+                return 0;
+            }
+            auto offset = static_cast<uint32_t>(stringData.size());
+            stringData.insert(stringData.end(), value.begin(), value.end());
+            stringData.push_back('\0');
+            return offset;
+        };
+
+        std::vector<uint32_t> strings;
+        strings.reserve(_strings.size());
+        for (const auto& str : _strings)
+        {
+            strings.push_back(addString(str));
+        }
+
+        std::vector<CompiledObjectOverride> objectOverrides(_objectOverrides.size());
+        for (size_t i = 0; i < _objectOverrides.size(); i++)
+        {
+            std::copy_n(_objectOverrides[i].name, sizeof(objectOverrides[i].Name), objectOverrides[i].Name);
+            for (int32_t j = 0; j < ObjectOverrideMaxStringCount; j++)
+            {
+                objectOverrides[i].Strings[j] = addString(_objectOverrides[i].strings[j]);
+            }
+        }
+
+        std::vector<CompiledScenarioOverride> scenarioOverrides(_scenarioOverrides.size());
+        for (size_t i = 0; i < _scenarioOverrides.size(); i++)
+        {
+            scenarioOverrides[i].Filename = addString(_scenarioOverrides[i].filename);
+            for (int32_t j = 0; j < ScenarioOverrideMaxStringCount; j++)
+            {
+                scenarioOverrides[i].Strings[j] = addString(_scenarioOverrides[i].strings[j]);
+            }
+        }
+
+        CompiledLanguagePackHeader header{};
+        header.Magic = COMPILED_MAGIC_NUMBER;
+        header.Version = COMPILED_VERSION;
+        header.LanguageId = _id;
+        header.SourceModified = sourceModified;
+        header.NumStrings = static_cast<uint32_t>(strings.size());
+        header.NumObjectOverrides = static_cast<uint32_t>(objectOverrides.size());
+        header.NumScenarioOverrides = static_cast<uint32_t>(scenarioOverrides.size());
+        header.StringDataLength = static_cast<uint32_t>(stringData.size());
+
+        std::vector<uint8_t> buffer;
+        Append(buffer, &header, 1);
+        Append(buffer, strings.data(), strings.size());
+        Append(buffer, objectOverrides.data(), objectOverrides.size());
+        Append(buffer, scenarioOverrides.data(), scenarioOverrides.size());
+        Append(buffer, stringData.data(), stringData.size());
+        return buffer;
+    }
+
 private:
+    template<typename T> static void Append(std::vector<uint8_t>& buffer, const T* data, size_t count)
+    {
+        auto bytes = reinterpret_cast<const uint8_t*>(data);
+        buffer.insert(buffer.end(), bytes, bytes + count * sizeof(T));
+    }
+
     ObjectOverride* GetObjectOverride(const std::string& objectIdentifier)
     {
         for (auto& oo : _objectOverrides)
@@ -642,6 +745,209 @@ private:
     }
 };
 
+/**
+ * A language pack read from the output of LanguagePack::Compile, usually mapped from a file so that the strings are
+ * shared between processes and nothing is parsed or allocated to load it. Only the strings of objects that are set after
+ * loading are kept separately.
+ */
+class CompiledLanguagePack final : public ILanguagePack
+{
+private:
+    uint16_t const _id;
+    std::unique_ptr<OpenRCT2::MemoryMappedFile> _file;
+    std::vector<uint8_t> _buffer;
+    const uint32_t* _strings{};
+    uint32_t _numStrings{};
+    const CompiledObjectOverride* _objectOverrides{};
+    uint32_t _numObjectOverrides{};
+    const CompiledScenarioOverride* _scenarioOverrides{};
+    uint32_t _numScenarioOverrides{};
+    const char* _stringData{};
+    std::unordered_map<rct_string_id, std::string> _changedStrings;
+
+public:
+    CompiledLanguagePack(uint16_t id, std::unique_ptr<OpenRCT2::MemoryMappedFile> file, std::vector<uint8_t> buffer)
+        : _id(id)
+        , _file(std::move(file))
+        , _buffer(std::move(buffer))
+    {
+    }
+
+    bool Validate(uint64_t sourceModified)
+    {
+        const uint8_t* data = _file != nullptr ? _file->GetData() : _buffer.data();
+        size_t length = _file != nullptr ? _file->GetLength() : _buffer.size();
+        if (length < sizeof(CompiledLanguagePackHeader))
+        {
+            return false;
+        }
+
+        CompiledLanguagePackHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        if (header.Magic != COMPILED_MAGIC_NUMBER || header.Version != COMPILED_VERSION || header.LanguageId != _id
+            || header.SourceModified != sourceModified)
+        {
+            return false;
+        }
+        uint64_t expectedLength = sizeof(CompiledLanguagePackHeader) + header.NumStrings * uint64_t{ sizeof(uint32_t) }
+            + header.NumObjectOverrides * uint64_t{ sizeof(CompiledObjectOverride) }
+            + header.NumScenarioOverrides * uint64_t{ sizeof(CompiledScenarioOverride) } + header.StringDataLength;
+        if (expectedLength != length || header.StringDataLength == 0 || data[length - 1] != '\0')
+        {
+            return false;
+        }
+
+        _strings = reinterpret_cast<const uint32_t*>(data + sizeof(CompiledLanguagePackHeader));
+        _numStrings = header.NumStrings;
+        _objectOverrides = reinterpret_cast<const CompiledObjectOverride*>(_strings + header.NumStrings);
+        _numObjectOverrides = header.NumObjectOverrides;
+        _scenarioOverrides = reinterpret_cast<const CompiledScenarioOverride*>(_objectOverrides + header.NumObjectOverrides);
+        _numScenarioOverrides = header.NumScenarioOverrides;
+        _stringData = reinterpret_cast<const char*>(_scenarioOverrides + header.NumScenarioOverrides);
+
+        // Check every offset once here, so that reading strings later can not go past the end of the data
+        auto isValid = [&header](uint32_t offset) { return offset < header.StringDataLength; };
+        if (!std::all_of(_strings, _strings + _numStrings, isValid))
+        {
+            return false;
+        }
+        for (uint32_t i = 0; i < _numObjectOverrides; i++)
+        {
+            const auto& strings = _objectOverrides[i].Strings;
+            if (!std::all_of(std::begin(strings), std::end(strings), isValid))
+            {
+                return false;
+            }
+        }
+        for (uint32_t i = 0; i < _numScenarioOverrides; i++)
+        {
+            const auto& strings = _scenarioOverrides[i].Strings;
+            if (!isValid(_scenarioOverrides[i].Filename) || !std::all_of(std::begin(strings), std::end(strings), isValid))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    uint16_t GetId() const override
+    {
+        return _id;
+    }
+
+    uint32_t GetCount() const override
+    {
+        return _numStrings;
+    }
+
+    void RemoveString(rct_string_id stringId) override
+    {
+        if (stringId < _numStrings)
+        {
+            _changedStrings[stringId] = std::string();
+        }
+    }
+
+    void SetString(rct_string_id stringId, const std::string& str) override
+    {
+        if (stringId < _numStrings)
+        {
+            _changedStrings[stringId] = str;
+        }
+    }
+
+    const utf8* GetString(rct_string_id stringId) const override
+    {
+        if (stringId >= ScenarioOverrideBase)
+        {
+            int32_t offset = stringId - ScenarioOverrideBase;
+            int32_t ooIndex = offset / ScenarioOverrideMaxStringCount;
+            int32_t ooStringIndex = offset % ScenarioOverrideMaxStringCount;
+
+            if (_numScenarioOverrides > static_cast<uint32_t>(ooIndex))
+            {
+                return GetStringAt(_scenarioOverrides[ooIndex].Strings[ooStringIndex]);
+            }
+            return nullptr;
+        }
+        else if (stringId >= ObjectOverrideBase)
+        {
+            int32_t offset = stringId - ObjectOverrideBase;
+            int32_t ooIndex = offset / ObjectOverrideMaxStringCount;
+            int32_t ooStringIndex = offset % ObjectOverrideMaxStringCount;
+
+            if (_numObjectOverrides > static_cast<uint32_t>(ooIndex))
+            {
+                return GetStringAt(_objectOverrides[ooIndex].Strings[ooStringIndex]);
+            }
+            return nullptr;
+        }
+        else
+        {
+            if (!_changedStrings.empty())
+            {
+                auto it = _changedStrings.find(stringId);
+                if (it != _changedStrings.end())
+                {
+                    return it->second.empty() ? nullptr : it->second.c_str();
+                }
+            }
+            if (_numStrings > static_cast<uint32_t>(stringId))
+            {
+                return GetStringAt(_strings[stringId]);
+            }
+            return nullptr;
+        }
+    }
+
+    rct_string_id GetObjectOverrideStringId(const std::string_view& legacyIdentifier, uint8_t index) override
+    {
+        Guard::Assert(index < ObjectOverrideMaxStringCount);
+
+        for (uint32_t i = 0; i < _numObjectOverrides; i++)
+        {
+            const auto& objectOverride = _objectOverrides[i];
+            if (std::string_view(objectOverride.Name, sizeof(objectOverride.Name)) == legacyIdentifier)
+            {
+                if (objectOverride.Strings[index] == 0)
+                {
+                    return STR_NONE;
+                }
+                return ObjectOverrideBase + (i * ObjectOverrideMaxStringCount) + index;
+            }
+        }
+
+        return STR_NONE;
+    }
+
+    rct_string_id GetScenarioOverrideStringId(const utf8* scenarioFilename, uint8_t index) override
+    {
+        Guard::ArgumentNotNull(scenarioFilename);
+        Guard::Assert(index < ScenarioOverrideMaxStringCount);
+
+        for (uint32_t i = 0; i < _numScenarioOverrides; i++)
+        {
+            const auto& scenarioOverride = _scenarioOverrides[i];
+            if (String::Equals(_stringData + scenarioOverride.Filename, scenarioFilename, true))
+            {
+                if (scenarioOverride.Strings[index] == 0)
+                {
+                    return STR_NONE;
+                }
+                return ScenarioOverrideBase + (i * ScenarioOverrideMaxStringCount) + index;
+            }
+        }
+
+        return STR_NONE;
+    }
+
+private:
+    const utf8* GetStringAt(uint32_t offset) const
+    {
+        return offset == 0 ? nullptr : _stringData + offset;
+    }
+};
+
 namespace LanguagePackFactory
 {
     ILanguagePack* FromFile(uint16_t id, const utf8* path)
@@ -655,4 +961,40 @@ namespace LanguagePackFactory
         auto languagePack = LanguagePack::FromText(id, text);
         return languagePack;
     }
+
+    std::vector<uint8_t> CompileFromFile(uint16_t id, const utf8* path, uint64_t sourceModified)
+    {
+        std::unique_ptr<LanguagePack> languagePack(LanguagePack::FromFile(id, path));
+        if (languagePack == nullptr)
+        {
+            return {};
+        }
+        return languagePack->Compile(sourceModified);
+    }
+
+    std::vector<uint8_t> CompileFromText(uint16_t id, const utf8* text, uint64_t sourceModified)
+    {
+        std::unique_ptr<LanguagePack> languagePack(LanguagePack::FromText(id, text));
+        return languagePack->Compile(sourceModified);
+    }
+
+    ILanguagePack* FromCompiled(uint16_t id, std::unique_ptr<OpenRCT2::MemoryMappedFile> file, uint64_t sourceModified)
+    {
+        auto languagePack = std::make_unique<CompiledLanguagePack>(id, std::move(file), std::vector<uint8_t>());
+        if (!languagePack->Validate(sourceModified))
+        {
+            return nullptr;
+        }
+        return languagePack.release();
+    }
+
+    ILanguagePack* FromCompiled(uint16_t id, std::vector<uint8_t> data, uint64_t sourceModified)
+    {
+        auto languagePack = std::make_unique<CompiledLanguagePack>(id, nullptr, std::move(data));
+        if (!languagePack->Validate(sourceModified))
+        {
+            return nullptr;
+        }
+        return languagePack.release();
+    }
 } // namespace LanguagePackFactory
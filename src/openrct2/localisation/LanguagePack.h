@@ -11,8 +11,15 @@
 
 #include "../common.h"
 
+#include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
+
+namespace OpenRCT2
+{
+    class MemoryMappedFile;
+}
 
 struct ILanguagePack
 {
@@ -32,4 +39,19 @@ namespace LanguagePackFactory
 {
     ILanguagePack* FromFile(uint16_t id, const utf8* path);
     ILanguagePack* FromText(uint16_t id, const utf8* text);
+
+    /**
+     * Parses a text language file into a compiled language pack: string offsets and one block of UTF-8 strings, with
+     * their format codes already converted. Returns nothing if the file can not be read.
+     * @param sourceModified The last modified time of the text file, a compiled pack is only loaded for that time.
+     */
+    std::vector<uint8_t> CompileFromFile(uint16_t id, const utf8* path, uint64_t sourceModified);
+    std::vector<uint8_t> CompileFromText(uint16_t id, const utf8* text, uint64_t sourceModified);
+
+    /**
+     * Loads a compiled language pack, strings are read from the data as they are asked for. Returns nullptr if the pack
+     * is not for this language, or was compiled from an older text file.
+     */
+    ILanguagePack* FromCompiled(uint16_t id, std::unique_ptr<OpenRCT2::MemoryMappedFile> file, uint64_t sourceModified);
+    ILanguagePack* FromCompiled(uint16_t id, std::vector<uint8_t> data, uint64_t sourceModified);
 } // namespace LanguagePackFactory
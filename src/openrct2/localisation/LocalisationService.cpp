@@ -11,9 +11,12 @@
 
 #include "../Context.h"
 #include "../PlatformEnvironment.h"
+#include "../core/File.h"
+#include "../core/MemoryMappedFile.h"
 #include "../core/Path.hpp"
 #include "../interface/Fonts.h"
 #include "../object/ObjectManager.h"
+#include "../platform/platform.h"
 #include "Language.h"
 #include "LanguagePack.h"
 #include "StringIds.h"
@@ -74,6 +77,67 @@ std::string LocalisationService::GetLanguagePath(uint32_t languageId) const
     return languagePath;
 }
 
+std::string LocalisationService::GetCompiledLanguagePath(uint32_t languageId) const
+{
+    auto locale = std::string(LanguagesDescriptors[languageId].locale);
+    auto languageDirectory = _env->GetDirectoryPath(DIRBASE::CACHE, DIRID::LANGUAGE);
+    return Path::Combine(languageDirectory, locale + ".bin");
+}
+
+std::unique_ptr<ILanguagePack> LocalisationService::LoadLanguagePack(uint32_t languageId) const
+{
+    auto path = GetLanguagePath(languageId);
+    auto compiledPath = GetCompiledLanguagePath(languageId);
+    auto sourceModified = File::GetLastModified(path);
+    if (File::Exists(compiledPath))
+    {
+        try
+        {
+            auto languagePack = LanguagePackFactory::FromCompiled(
+                languageId, std::make_unique<MemoryMappedFile>(compiledPath), sourceModified);
+            if (languagePack != nullptr)
+            {
+                return std::unique_ptr<ILanguagePack>(languagePack);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            log_warning("Unable to map '%s': %s", compiledPath.c_str(), e.what());
+        }
+    }
+
+    // The text file is new or has changed, compile it again so the next start can map it
+    auto data = LanguagePackFactory::CompileFromFile(languageId, path.c_str(), sourceModified);
+    if (data.empty())
+    {
+        return nullptr;
+    }
+    try
+    {
+        // Other processes may have the old file mapped, so it is replaced rather than written over
+        auto tempPath = File::GetTemporaryPath(compiledPath);
+        platform_ensure_directory_exists(Path::GetDirectory(compiledPath).c_str());
+        try
+        {
+            File::WriteAllBytes(tempPath, data.data(), data.size());
+        }
+        catch (const std::exception&)
+        {
+            File::Delete(tempPath);
+            throw;
+        }
+        if (!File::Replace(tempPath, compiledPath))
+        {
+            File::Delete(tempPath);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        log_warning("Unable to write '%s': %s", compiledPath.c_str(), e.what());
+    }
+    return std::unique_ptr<ILanguagePack>(LanguagePackFactory::FromCompiled(languageId, std::move(data), sourceModified));
+}
+
 void LocalisationService::OpenLanguage(int32_t id)
 {
     CloseLanguages();
@@ -82,16 +146,12 @@ void LocalisationService::OpenLanguage(int32_t id)
         throw std::invalid_argument("id was undefined");
     }
 
-    std::string filename;
     if (id != LANGUAGE_ENGLISH_UK)
     {
-        filename = GetLanguagePath(LANGUAGE_ENGLISH_UK);
-        _languageFallback = std::unique_ptr<ILanguagePack>(
-            LanguagePackFactory::FromFile(LANGUAGE_ENGLISH_UK, filename.c_str()));
+        _languageFallback = LoadLanguagePack(LANGUAGE_ENGLISH_UK);
     }
 
-    filename = GetLanguagePath(id);
-    _languageCurrent = std::unique_ptr<ILanguagePack>(LanguagePackFactory::FromFile(id, filename.c_str()));
+    _languageCurrent = LoadLanguagePack(id);
     if (_languageCurrent != nullptr)
     {
         _currentLanguage = id;
@@ -59,11 +59,15 @@ namespace OpenRCT2::Localisation
             const std::string& scenarioFilename) const;
         rct_string_id GetObjectOverrideStringId(const std::string_view& legacyIdentifier, uint8_t index) const;
         std::string GetLanguagePath(uint32_t languageId) const;
+        std::string GetCompiledLanguagePath(uint32_t languageId) const;
 
         void OpenLanguage(int32_t id);
         void CloseLanguages();
         rct_string_id AllocateObjectString(const std::string& target);
         void FreeObjectString(rct_string_id stringId);
+
+    private:
+        std::unique_ptr<ILanguagePack> LoadLanguagePack(uint32_t languageId) const;
     };
 } // namespace OpenRCT2::Localisation
 
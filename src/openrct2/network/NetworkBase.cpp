@@ -34,16 +34,51 @@
 // This string specifies which version of network stream current build uses.
 // It is used for making sure only compatible builds get connected, even within
 // single OpenRCT2 version.
-#define NETWORK_STREAM_VERSION "1"
+#define NETWORK_STREAM_VERSION "7"
 #define NETWORK_STREAM_ID OPENRCT2_VERSION "-" NETWORK_STREAM_VERSION
 
 static Peep* _pickup_peep = nullptr;
 static int32_t _pickup_peep_old_x = LOCATION_NULL;
 
+// Ticks on which both sides checksum the entities, the server sends its result once the worker finished.
+static constexpr uint32_t SPRITE_CHECKSUM_INTERVAL = 100;
+// Checksums computed but not yet compared are dropped beyond this, e.g. when the server stopped sending them.
+static constexpr size_t SPRITE_CHECKSUM_MAX_PENDING = 8;
+
+// A client that desyncs again this soon after being patched is not patched again.
+static constexpr uint32_t RESYNC_RETRY_TICKS = 40 * 10;
+
 // General chunk size is 63 KiB, this can not be any larger because the packet size is encoded
 // with uint16_t and needs some spare room for other data in the packet.
 static constexpr uint32_t CHUNK_SIZE = 1024 * 63;
 
+// Writes 7 bits per byte, the high bit marks that more bytes follow.
+static void WriteVarUInt(NetworkPacket& packet, uint32_t value)
+{
+    while (value >= 0x80)
+    {
+        packet << static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    packet << static_cast<uint8_t>(value);
+}
+
+static bool ReadVarUInt(NetworkPacket& packet, uint32_t& value)
+{
+    value = 0;
+    for (uint32_t shift = 0; shift < 32; shift += 7)
+    {
+        const uint8_t* byte = packet.Read(1);
+        if (byte == nullptr)
+            return false;
+
+        value |= static_cast<uint32_t>(*byte & 0x7F) << shift;
+        if ((*byte & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
 #ifndef DISABLE_NETWORK
 
 #    include "../Cheats.h"
@@ -52,6 +87,7 @@ static constexpr uint32_t CHUNK_SIZE = 1024 * 63;
 #    include "../actions/GameAction.h"
 #    include "../config/Config.h"
 #    include "../core/Console.hpp"
+#    include "../core/File.h"
 #    include "../core/FileStream.hpp"
 #    include "../core/MemoryStream.h"
 #    include "../core/Nullable.hpp"
@@ -80,6 +116,7 @@ static constexpr uint32_t CHUNK_SIZE = 1024 * 63;
 #    include <algorithm>
 #    include <array>
 #    include <cerrno>
+#    include <chrono>
 #    include <cmath>
 #    include <fstream>
 #    include <functional>
@@ -111,7 +148,7 @@ NetworkBase::NetworkBase()
     client_command_handlers[NetworkCommand::Auth] = &NetworkBase::Client_Handle_AUTH;
     client_command_handlers[NetworkCommand::Map] = &NetworkBase::Client_Handle_MAP;
     client_command_handlers[NetworkCommand::Chat] = &NetworkBase::Client_Handle_CHAT;
-    client_command_handlers[NetworkCommand::GameAction] = &NetworkBase::Client_Handle_GAME_ACTION;
+    client_command_handlers[NetworkCommand::GameActionBatch] = &NetworkBase::Client_Handle_GAME_ACTION_BATCH;
     client_command_handlers[NetworkCommand::Tick] = &NetworkBase::Client_Handle_TICK;
     client_command_handlers[NetworkCommand::PlayerList] = &NetworkBase::Client_Handle_PLAYERLIST;
     client_command_handlers[NetworkCommand::PlayerInfo] = &NetworkBase::Client_Handle_PLAYERINFO;
@@ -190,12 +227,16 @@ void NetworkBase::Close()
         CloseServerLog();
         CloseConnection();
 
+        _mapSnapshots.clear();
+        _gameActionBatch.Clear();
         client_connection_list.clear();
         GameActions::ClearQueue();
         GameActions::ResumeQueue();
         player_list.clear();
         group_list.clear();
         _serverTickData.clear();
+        _serverSpriteHashes.clear();
+        _spriteChecksumJobs.clear();
         _pendingPlayerLists.clear();
         _pendingPlayerInfo.clear();
 
@@ -228,6 +269,7 @@ void NetworkBase::CloseConnection()
     }
     else if (mode == NETWORK_MODE_SERVER)
     {
+        _socketPoller.reset();
         _listenSocket.reset();
         _advertiser.reset();
     }
@@ -258,11 +300,14 @@ bool NetworkBase::BeginClient(const std::string& host, uint16_t port)
     _serverConnection->Socket = CreateTcpSocket();
     _serverConnection->Socket->ConnectAsync(host, port);
     _serverState.gamestateSnapshotsEnabled = false;
+    _resynchronising = false;
+    _lastResyncTick.reset();
 
     status = NETWORK_STATUS_CONNECTING;
     _lastConnectStatus = SocketStatus::Closed;
     _clientMapLoaded = false;
     _serverTickData.clear();
+    _serverSpriteHashes.clear();
 
     BeginChatLog();
     BeginServerLog();
@@ -356,6 +401,8 @@ bool NetworkBase::BeginServer(uint16_t port, const std::string& address)
     try
     {
         _listenSocket->Listen(address, port);
+        _socketPoller = CreateSocketPoller();
+        _socketPoller->Add(_listenSocket.get());
     }
     catch (const std::exception& ex)
     {
@@ -396,6 +443,9 @@ bool NetworkBase::BeginServer(uint16_t port, const std::string& address)
 
     status = NETWORK_STATUS_CONNECTED;
     listening_port = port;
+    _startTime = platform_get_ticks();
+    _lastMetricsTime = _startTime;
+    _tickTimes.clear();
     _serverState.gamestateSnapshotsEnabled = gConfigNetwork.desync_debugging;
     _advertiser = CreateServerAdvertiser(listening_port);
 
@@ -489,6 +539,14 @@ void NetworkBase::Flush()
     }
     else
     {
+        Server_Send_GAME_ACTION_BATCH();
+        if (_tickStartTime.has_value())
+        {
+            auto tickTime = std::chrono::high_resolution_clock::now() - *_tickStartTime;
+            _tickTimes.push_back(
+                static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(tickTime).count()));
+            _tickStartTime.reset();
+        }
         for (auto& it : client_connection_list)
         {
             it->SendQueuedPackets();
@@ -498,15 +556,22 @@ void NetworkBase::Flush()
 
 void NetworkBase::UpdateServer()
 {
+    // Actions executed outside of a tick have to reach the clients before anything the requests below produce, e.g. a map.
+    Server_Send_GAME_ACTION_BATCH();
+
+    // Only sockets with pending input are read, idle connections just get their queue flushed and timeout checked.
+    PollSockets(0);
+
     for (auto& connection : client_connection_list)
     {
         // This can be called multiple times before the connection is removed.
         if (connection->IsDisconnected)
             continue;
 
-        if (!ProcessConnection(*connection))
+        if (!ProcessConnection(*connection, IsSocketReady(connection->Socket.get())))
         {
             connection->IsDisconnected = true;
+            _socketPoller->Remove(connection->Socket.get());
         }
         else
         {
@@ -526,10 +591,66 @@ void NetworkBase::UpdateServer()
         _advertiser->Update();
     }
 
-    std::unique_ptr<ITcpSocket> tcpSocket = _listenSocket->Accept();
-    if (tcpSocket != nullptr)
+    UpdateMapSnapshots();
+    UpdateMetrics();
+
+    AcceptClient();
+}
+
+void NetworkBase::Wait(uint32_t timeoutMs)
+{
+    if (GetMode() != NETWORK_MODE_SERVER || _socketPoller == nullptr)
+    {
+        platform_sleep(timeoutMs);
+        return;
+    }
+
+    // Handle input as soon as it arrives rather than at the next game tick, pings, snapshots and the advertiser are
+    // left to Update().
+    PollSockets(timeoutMs);
+    if (_readySockets.empty())
+        return;
+
+    _closeLock = true;
+    for (auto& connection : client_connection_list)
+    {
+        if (connection->IsDisconnected || !IsSocketReady(connection->Socket.get()))
+            continue;
+
+        if (!ProcessConnection(*connection))
+        {
+            connection->IsDisconnected = true;
+            _socketPoller->Remove(connection->Socket.get());
+        }
+    }
+    AcceptClient();
+    _closeLock = false;
+    if (_requireClose)
+    {
+        Close();
+    }
+}
+
+void NetworkBase::PollSockets(uint32_t timeoutMs)
+{
+    _socketPoller->Wait(timeoutMs, _readySockets);
+    std::sort(_readySockets.begin(), _readySockets.end());
+}
+
+bool NetworkBase::IsSocketReady(const ITcpSocket* socket) const
+{
+    return std::binary_search(_readySockets.begin(), _readySockets.end(), socket);
+}
+
+void NetworkBase::AcceptClient()
+{
+    if (IsSocketReady(_listenSocket.get()))
     {
-        AddClient(std::move(tcpSocket));
+        std::unique_ptr<ITcpSocket> tcpSocket = _listenSocket->Accept();
+        if (tcpSocket != nullptr)
+        {
+            AddClient(std::move(tcpSocket));
+        }
     }
 }
 
@@ -716,6 +837,8 @@ const char* NetworkBase::FormatChat(NetworkPlayer* fromplayer, const char* text)
 
 void NetworkBase::SendPacketToClients(const NetworkPacket& packet, bool front, bool gameCmd)
 {
+    // Encode once, every connection shares the same immutable buffer
+    auto buffer = packet.Encode();
     for (auto& client_connection : client_connection_list)
     {
         if (client_connection->IsDisconnected)
@@ -735,8 +858,7 @@ void NetworkBase::SendPacketToClients(const NetworkPacket& packet, bool front, b
                 continue;
             }
         }
-        auto packetCopy = packet;
-        client_connection->QueuePacket(std::move(packetCopy), front);
+        client_connection->QueuePacket(buffer, front);
     }
 }
 
@@ -759,13 +881,47 @@ bool NetworkBase::CheckSRAND(uint32_t tick, uint32_t srand0)
         return false;
     }
 
-    if (!storedTick.spriteHash.empty())
+    return true;
+}
+
+bool NetworkBase::CheckSpriteChecksums()
+{
+    if (!_clientMapLoaded)
+        return true;
+
+    if (gCurrentTicks % SPRITE_CHECKSUM_INTERVAL == 0)
     {
-        rct_sprite_checksum checksum = sprite_checksum();
-        std::string clientSpriteHash = checksum.ToString();
-        if (clientSpriteHash != storedTick.spriteHash)
+        QueueSpriteChecksum();
+    }
+
+    // Either side may finish first, compare once both the server and the worker have the checksum of a tick.
+    for (auto it = _spriteChecksumJobs.begin(); it != _spriteChecksumJobs.end();)
+    {
+        auto itServerHash = _serverSpriteHashes.find(it->Tick);
+        if (itServerHash == _serverSpriteHashes.end())
+        {
+            // The server sends its checksums in order, a later one means this tick will never arrive
+            bool skipped = !_serverSpriteHashes.empty() && _serverSpriteHashes.rbegin()->first > it->Tick;
+            it = skipped ? _spriteChecksumJobs.erase(it) : std::next(it);
+            continue;
+        }
+        if (it->Result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            ++it;
+            continue;
+        }
+
+        std::string clientSpriteHash = it->Result.get().ToString();
+        std::string serverSpriteHash = std::move(itServerHash->second);
+        uint32_t tick = it->Tick;
+        _serverSpriteHashes.erase(itServerHash);
+        it = _spriteChecksumJobs.erase(it);
+
+        if (clientSpriteHash != serverSpriteHash)
         {
-            log_info("Sprite hash mismatch, client = %s, server = %s", clientSpriteHash.c_str(), storedTick.spriteHash.c_str());
+            log_info(
+                "Sprite hash mismatch on tick %u, client = %s, server = %s", tick, clientSpriteHash.c_str(),
+                serverSpriteHash.c_str());
             return false;
         }
     }
@@ -773,6 +929,20 @@ bool NetworkBase::CheckSRAND(uint32_t tick, uint32_t srand0)
     return true;
 }
 
+void NetworkBase::QueueSpriteChecksum()
+{
+    while (_spriteChecksumJobs.size() >= SPRITE_CHECKSUM_MAX_PENDING)
+    {
+        _spriteChecksumJobs.pop_front();
+    }
+
+    // Copying the entities is cheap compared to hashing them, only the copy happens on the game thread.
+    auto sprites = std::make_shared<std::vector<rct_sprite>>(sprite_checksum_capture());
+    auto& job = _spriteChecksumJobs.emplace_back();
+    job.Tick = gCurrentTicks;
+    job.Result = std::async(std::launch::async, [sprites]() { return sprite_checksum(*sprites); });
+}
+
 bool NetworkBase::IsDesynchronised()
 {
     return _serverState.state == NetworkServerState::Desynced;
@@ -782,7 +952,7 @@ bool NetworkBase::CheckDesynchronizaton()
 {
     // Check synchronisation
     if (GetMode() == NETWORK_MODE_CLIENT && _serverState.state != NetworkServerState::Desynced
-        && !CheckSRAND(gCurrentTicks, scenario_rand_state().s0))
+        && (!CheckSRAND(gCurrentTicks, scenario_rand_state().s0) || !CheckSpriteChecksums()))
     {
         _serverState.state = NetworkServerState::Desynced;
         _serverState.desyncTick = gCurrentTicks;
@@ -794,7 +964,8 @@ bool NetworkBase::CheckDesynchronizaton()
         intent.putExtra(INTENT_EXTRA_MESSAGE, std::string{ str_desync });
         context_open_intent(&intent);
 
-        if (!gConfigNetwork.stay_connected)
+        // Decided once the server answered when the diverged entities can be patched
+        if (!gConfigNetwork.stay_connected && !CanResynchronise())
         {
             Close();
         }
@@ -812,6 +983,37 @@ void NetworkBase::RequestStateSnapshot()
     Client_Send_RequestGameState(_serverState.desyncTick);
 }
 
+bool NetworkBase::IsResynchronising() const
+{
+    return _resynchronising;
+}
+
+bool NetworkBase::CanResynchronise() const
+{
+    if (!_serverState.gamestateSnapshotsEnabled)
+        return false;
+
+    // Patching did not help last time, most likely something outside the entities diverged
+    return !_lastResyncTick.has_value() || gCurrentTicks - *_lastResyncTick > RESYNC_RETRY_TICKS;
+}
+
+void NetworkBase::FinishResynchronise(bool success)
+{
+    _resynchronising = false;
+    if (success)
+    {
+        // Computed from the entities before they were patched
+        _spriteChecksumJobs.clear();
+        _serverState.state = NetworkServerState::Ok;
+        _lastResyncTick = gCurrentTicks;
+        gfx_invalidate_screen();
+    }
+    else if (!gConfigNetwork.stay_connected)
+    {
+        Close();
+    }
+}
+
 NetworkServerState_t NetworkBase::GetServerState() const
 {
     return _serverState;
@@ -1197,11 +1399,26 @@ void NetworkBase::Client_Send_RequestGameState(uint32_t tick)
         return;
     }
 
+    IGameStateSnapshots* snapshots = GetContext()->GetGameStateSnapshots();
+    const GameStateSnapshot_t* snapshot = snapshots->GetLinkedSnapshot(tick);
+    if (snapshot == nullptr || !CanResynchronise())
+    {
+        FinishResynchronise(false);
+        return;
+    }
+
     log_verbose("Requesting gamestate from server for tick %u", tick);
 
+    // Only the entity ranges that hash differently are sent back, the game is held on this tick until then
+    auto hashes = snapshots->GetSpriteRangeHashes(*snapshot);
     NetworkPacket packet(NetworkCommand::RequestGameState);
-    packet << tick;
+    packet << tick << static_cast<uint32_t>(hashes.size());
+    for (auto hash : hashes)
+    {
+        packet << hash;
+    }
     _serverConnection->QueuePacket(std::move(packet));
+    _resynchronising = true;
 }
 
 void NetworkBase::Client_Send_TOKEN()
@@ -1365,81 +1582,196 @@ void NetworkBase::Server_Send_AUTH(NetworkConnection& connection)
 
 void NetworkBase::Server_Send_MAP(NetworkConnection* connection)
 {
-    std::vector<const ObjectRepositoryItem*> objects;
     if (connection)
     {
-        objects = connection->RequestedObjects;
+        QueueMapSnapshot(*connection);
+        return;
+    }
+
+    // This will send all custom objects to connected clients
+    // TODO: fix it so custom objects negotiation is performed even in this case.
+    auto context = GetContext();
+    auto& objManager = context->GetObjectManager();
+    auto objects = objManager.GetPackableObjects();
+
+    bool RLEState = gUseRLE;
+    gUseRLE = false;
+    auto ms = OpenRCT2::MemoryStream();
+    bool saved = SaveMap(&ms, objects);
+    gUseRLE = RLEState;
+    if (!saved)
+    {
+        log_warning("Failed to export map.");
+        return;
+    }
+
+    auto data = static_cast<const uint8_t*>(ms.GetData());
+    auto size = static_cast<uint32_t>(ms.GetLength());
+    for (uint32_t offset = 0; offset < size; offset += CHUNK_SIZE)
+    {
+        SendPacketToClients(CreateMapFramePacket(data, size, offset));
+    }
+}
+
+NetworkPacket NetworkBase::CreateMapFramePacket(const uint8_t* data, uint32_t size, uint32_t offset, bool compress)
+{
+    // Every frame is compressed on its own so the client can decompress it as soon as it arrives
+    uint32_t frameSize = std::min(CHUNK_SIZE, size - offset);
+    NetworkPacket packet(NetworkCommand::Map);
+    packet << size << offset << frameSize;
+    auto compressed = compress ? util_zlib_deflate(data + offset, frameSize) : std::nullopt;
+    if (compressed != std::nullopt && compressed->size() < frameSize)
+    {
+        packet.Write(compressed->data(), compressed->size());
     }
     else
     {
-        // This will send all custom objects to connected clients
-        // TODO: fix it so custom objects negotiation is performed even in this case.
-        auto context = GetContext();
-        auto& objManager = context->GetObjectManager();
-        objects = objManager.GetPackableObjects();
+        // Stored as is, the client tells the two apart by the payload size
+        packet.Write(data + offset, frameSize);
     }
+    return packet;
+}
+
+void NetworkBase::QueueMapSnapshot(NetworkConnection& connection)
+{
+    // Packets queued for this client from now on must arrive after the map
+    connection.HoldPackets();
 
-    auto header = save_for_network(objects);
-    if (header.empty())
+    auto it = std::find_if(_mapSnapshots.begin(), _mapSnapshots.end(), [&connection](const MapSnapshot& snapshot) {
+        return snapshot.Tick == gCurrentTicks && snapshot.Objects == connection.RequestedObjects;
+    });
+    if (it != _mapSnapshots.end())
     {
-        if (connection)
+        connection.InsertHeldPackets(it->Packets);
+        if (it->Job.valid())
         {
-            connection->SetLastDisconnectReason(STR_MULTIPLAYER_CONNECTION_CLOSED);
-            connection->Socket->Disconnect();
+            it->Waiting.push_back(&connection);
+            return;
         }
-        return;
+        if (!it->Packets.empty())
+        {
+            connection.ReleaseHeldPackets();
+            return;
+        }
+        _mapSnapshots.erase(it);
+    }
+
+    // Copy the game state on this thread, writing and compressing the copy is left to the background job
+    map_reorganise_elements();
+    viewport_set_saved_view();
+    auto exporter = std::make_shared<S6Exporter>();
+    auto extras = std::make_shared<OpenRCT2::MemoryStream>();
+    try
+    {
+        exporter->ExportObjectsList = connection.RequestedObjects;
+        exporter->Export();
+        SaveMapExtras(extras.get());
     }
-    size_t chunksize = CHUNK_SIZE;
-    for (size_t i = 0; i < header.size(); i += chunksize)
+    catch (const std::exception& e)
     {
-        size_t datasize = std::min(chunksize, header.size() - i);
-        NetworkPacket packet(NetworkCommand::Map);
-        packet << static_cast<uint32_t>(header.size()) << static_cast<uint32_t>(i);
-        packet.Write(&header[i], datasize);
-        if (connection)
+        log_warning("Failed to export map: %s", e.what());
+        connection.SetLastDisconnectReason(STR_MULTIPLAYER_CONNECTION_CLOSED);
+        connection.Socket->Disconnect();
+        connection.ReleaseHeldPackets();
+        return;
+    }
+
+    auto stream = std::make_shared<MapSnapshotStream>();
+    auto& snapshot = _mapSnapshots.emplace_back();
+    snapshot.Tick = gCurrentTicks;
+    snapshot.Objects = connection.RequestedObjects;
+    snapshot.Stream = stream;
+    snapshot.Waiting.push_back(&connection);
+    snapshot.Job = std::async(std::launch::async, [exporter, extras, stream]() {
+        gUseRLE = false;
+        try
         {
-            connection->QueuePacket(std::move(packet));
+            // The park file compresses its blocks in parallel, so the frames do not need to be compressed again
+            auto ms = OpenRCT2::MemoryStream();
+            exporter->UseParkFile = true;
+            exporter->SaveGame(&ms);
+            ms.Write(extras->GetData(), extras->GetLength());
+
+            // Publish each frame as soon as it is compressed so the transfer starts before the whole map is done
+            auto data = static_cast<const uint8_t*>(ms.GetData());
+            auto size = static_cast<uint32_t>(ms.GetLength());
+            size_t compressedSize = 0;
+            for (uint32_t offset = 0; offset < size; offset += CHUNK_SIZE)
+            {
+                auto packet = CreateMapFramePacket(data, size, offset, false);
+                compressedSize += packet.Data.size();
+                std::lock_guard<std::mutex> lock(stream->Mutex);
+                stream->Frames.push_back(std::move(packet));
+            }
+            log_verbose("Sending map of size %u bytes, compressed to %zu bytes", size, compressedSize);
         }
-        else
+        catch (const std::exception& e)
         {
-            SendPacketToClients(packet);
+            log_warning("Failed to save map: %s", e.what());
+            std::lock_guard<std::mutex> lock(stream->Mutex);
+            stream->Failed = true;
         }
-    }
+    });
 }
 
-std::vector<uint8_t> NetworkBase::save_for_network(const std::vector<const ObjectRepositoryItem*>& objects) const
+void NetworkBase::UpdateMapSnapshots()
 {
-    std::vector<uint8_t> header;
-    bool RLEState = gUseRLE;
-    gUseRLE = false;
-
-    auto ms = OpenRCT2::MemoryStream();
-    if (!SaveMap(&ms, objects))
+    for (auto it = _mapSnapshots.begin(); it != _mapSnapshots.end();)
     {
-        log_warning("Failed to export map.");
-        return header;
-    }
-    gUseRLE = RLEState;
+        auto& snapshot = *it;
+        if (snapshot.Job.valid())
+        {
+            // Check for completion first so no frame published before the job ended is missed
+            bool finished = snapshot.Job.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            std::vector<NetworkPacket> frames;
+            bool failed;
+            {
+                std::lock_guard<std::mutex> lock(snapshot.Stream->Mutex);
+                frames.swap(snapshot.Stream->Frames);
+                failed = snapshot.Stream->Failed;
+            }
+
+            std::vector<std::shared_ptr<const NetworkPacketBuffer>> packets;
+            for (const auto& frame : frames)
+            {
+                packets.push_back(frame.Encode());
+            }
+            snapshot.Packets.insert(snapshot.Packets.end(), packets.begin(), packets.end());
+            for (auto connection : snapshot.Waiting)
+            {
+                connection->InsertHeldPackets(packets);
+            }
 
-    const void* data = ms.GetData();
-    int32_t size = ms.GetLength();
+            if (finished)
+            {
+                snapshot.Job.get();
+                for (auto connection : snapshot.Waiting)
+                {
+                    if (failed)
+                    {
+                        connection->SetLastDisconnectReason(STR_MULTIPLAYER_CONNECTION_CLOSED);
+                        connection->Socket->Disconnect();
+                    }
+                    connection->ReleaseHeldPackets();
+                }
+                snapshot.Waiting.clear();
+                if (failed)
+                {
+                    snapshot.Packets.clear();
+                }
+            }
+        }
 
-    auto compressed = util_zlib_deflate(static_cast<const uint8_t*>(data), size);
-    if (compressed != std::nullopt)
-    {
-        std::string headerString = "open2_sv6_zlib";
-        header.resize(headerString.size() + 1 + compressed->size());
-        std::memcpy(&header[0], headerString.c_str(), headerString.size() + 1);
-        std::memcpy(&header[headerString.size() + 1], compressed->data(), compressed->size());
-        log_verbose("Sending map of size %u bytes, compressed to %u bytes", size, headerString.size() + 1 + compressed->size());
-    }
-    else
-    {
-        log_warning("Failed to compress the data, falling back to non-compressed sv6.");
-        header.resize(size);
-        std::memcpy(header.data(), data, size);
+        // Only joins on the same tick can share a map, older ones are dropped once delivered
+        if (!snapshot.Job.valid() && snapshot.Tick != gCurrentTicks)
+        {
+            it = _mapSnapshots.erase(it);
+        }
+        else
+        {
+            it++;
+        }
     }
-    return header;
 }
 
 void NetworkBase::Client_Send_CHAT(const char* text)
@@ -1461,12 +1793,13 @@ void NetworkBase::Server_Send_CHAT(const char* text, const std::vector<uint8_t>&
     }
     else
     {
+        auto buffer = packet.Encode();
         for (auto playerId : playerIds)
         {
             auto conn = GetPlayerConnection(playerId);
             if (conn != nullptr && !conn->IsDisconnected)
             {
-                conn->QueuePacket(packet);
+                conn->QueuePacket(buffer);
             }
         }
     }
@@ -1495,29 +1828,58 @@ void NetworkBase::Client_Send_GAME_ACTION(const GameAction* action)
 
 void NetworkBase::Server_Send_GAME_ACTION(const GameAction* action)
 {
-    NetworkPacket packet(NetworkCommand::GameAction);
-
     DataSerialiser stream(true);
     action->Serialise(stream);
 
-    packet << gCurrentTicks << action->GetType() << stream;
+    const auto& actionData = stream.GetStream();
+    uint32_t actionSize = static_cast<uint32_t>(actionData.GetLength());
 
-    SendPacketToClients(packet);
+    // A batch only holds actions of one tick and has to fit into a single packet, the type and size take up to 5 bytes each
+    if (!_gameActionBatch.Data.empty()
+        && (_gameActionBatchTick != gCurrentTicks || _gameActionBatch.Data.size() + actionSize + 10 > CHUNK_SIZE))
+    {
+        Server_Send_GAME_ACTION_BATCH();
+    }
+    if (_gameActionBatch.Data.empty())
+    {
+        _gameActionBatchTick = gCurrentTicks;
+        _gameActionBatch << gCurrentTicks;
+    }
+
+    _gameActionsSent++;
+    WriteVarUInt(_gameActionBatch, action->GetType());
+    WriteVarUInt(_gameActionBatch, actionSize);
+    _gameActionBatch.Write(actionData.GetData(), actionSize);
+}
+
+void NetworkBase::Server_Send_GAME_ACTION_BATCH()
+{
+    if (_gameActionBatch.Data.empty())
+        return;
+
+    SendPacketToClients(_gameActionBatch);
+    _gameActionBatch.Clear();
 }
 
 void NetworkBase::Server_Send_TICK()
 {
+    // Clients may run up to this tick once they receive it, the actions have to be there before.
+    Server_Send_GAME_ACTION_BATCH();
+    _tickStartTime = std::chrono::high_resolution_clock::now();
+
     NetworkPacket packet(NetworkCommand::Tick);
     packet << gCurrentTicks << scenario_rand_state().s0;
     uint32_t flags = 0;
-    // Simple counter which limits how often a sprite checksum gets sent.
-    // This can get somewhat expensive, so we don't want to push it every tick in release,
-    // but debug version can check more often.
-    static int32_t checksum_counter = 0;
-    checksum_counter++;
-    if (checksum_counter >= 100)
-    {
-        checksum_counter = 0;
+    // The sprite checksum is too expensive to compute on every tick, clients checksum the same ticks.
+    // It is hashed on a worker and attached to whichever tick packet goes out once it finished.
+    bool checksumTick = gCurrentTicks % SPRITE_CHECKSUM_INTERVAL == 0;
+    if (checksumTick)
+    {
+        QueueSpriteChecksum();
+    }
+    if (!_spriteChecksumJobs.empty()
+        && _spriteChecksumJobs.front().Result.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
         flags |= NETWORK_TICK_FLAG_CHECKSUMS;
     }
     // Send flags always, so we can understand packet structure on the other end,
@@ -1525,11 +1887,25 @@ void NetworkBase::Server_Send_TICK()
     packet << flags;
     if (flags & NETWORK_TICK_FLAG_CHECKSUMS)
     {
-        rct_sprite_checksum checksum = sprite_checksum();
+        auto& checksumJob = _spriteChecksumJobs.front();
+        rct_sprite_checksum checksum = checksumJob.Result.get();
+        packet << checksumJob.Tick;
         packet.WriteString(checksum.ToString().c_str());
+        _spriteChecksumJobs.pop_front();
     }
 
     SendPacketToClients(packet);
+
+    // Report outbound buffer use over the same interval as the checksums
+    if (checksumTick)
+    {
+        const auto stats = NetworkPacket::GetBufferStats();
+        log_verbose(
+            "Outbound packet buffers: %.1f allocations, %.0f bytes copied per tick for %zu clients",
+            (stats.Allocations - _lastPacketBufferStats.Allocations) / 100.0,
+            (stats.BytesCopied - _lastPacketBufferStats.BytesCopied) / 100.0, client_connection_list.size());
+        _lastPacketBufferStats = stats;
+    }
 }
 
 void NetworkBase::Server_Send_PLAYERINFO(int32_t playerId)
@@ -1559,6 +1935,7 @@ void NetworkBase::Server_Send_PLAYERLIST()
 void NetworkBase::Client_Send_PING()
 {
     NetworkPacket packet(NetworkCommand::Ping);
+    packet << gCurrentTicks;
     _serverConnection->QueuePacket(std::move(packet));
 }
 
@@ -1602,6 +1979,161 @@ json_t NetworkBase::GetServerInfoAsJson() const
     return jsonObj;
 }
 
+static const char* GetCommandName(NetworkCommand command)
+{
+    switch (command)
+    {
+        case NetworkCommand::Auth:
+            return "auth";
+        case NetworkCommand::Map:
+            return "map";
+        case NetworkCommand::Chat:
+            return "chat";
+        case NetworkCommand::Tick:
+            return "tick";
+        case NetworkCommand::PlayerList:
+            return "playerList";
+        case NetworkCommand::Ping:
+            return "ping";
+        case NetworkCommand::PingList:
+            return "pingList";
+        case NetworkCommand::DisconnectMessage:
+            return "disconnectMessage";
+        case NetworkCommand::GameInfo:
+            return "gameInfo";
+        case NetworkCommand::ShowError:
+            return "showError";
+        case NetworkCommand::GroupList:
+            return "groupList";
+        case NetworkCommand::Event:
+            return "event";
+        case NetworkCommand::Token:
+            return "token";
+        case NetworkCommand::ObjectsList:
+            return "objectsList";
+        case NetworkCommand::MapRequest:
+            return "mapRequest";
+        case NetworkCommand::GameAction:
+            return "gameAction";
+        case NetworkCommand::PlayerInfo:
+            return "playerInfo";
+        case NetworkCommand::RequestGameState:
+            return "requestGameState";
+        case NetworkCommand::GameState:
+            return "gameState";
+        case NetworkCommand::Scripts:
+            return "scripts";
+        case NetworkCommand::Heartbeat:
+            return "heartbeat";
+        case NetworkCommand::GameActionBatch:
+            return "gameActionBatch";
+        default:
+            return nullptr;
+    }
+}
+
+static json_t GetCommandBytesAsJson(const uint64_t (&bytes)[EnumValue(NetworkCommand::Max)])
+{
+    json_t jsonBytes = json_t::object();
+    for (size_t i = 0; i < std::size(bytes); i++)
+    {
+        const char* name = GetCommandName(static_cast<NetworkCommand>(i));
+        if (name != nullptr && bytes[i] != 0)
+        {
+            jsonBytes[name] = bytes[i];
+        }
+    }
+    return jsonBytes;
+}
+
+json_t NetworkBase::GetMetricsAsJson() const
+{
+    std::vector<uint32_t> tickTimes;
+    for (size_t i = 0; i < _tickTimes.size(); i++)
+    {
+        tickTimes.push_back(_tickTimes[i]);
+    }
+    std::sort(tickTimes.begin(), tickTimes.end());
+    auto percentile = [&tickTimes](size_t p) -> uint32_t {
+        return tickTimes.empty() ? 0 : tickTimes[(tickTimes.size() - 1) * p / 100];
+    };
+
+    const auto bufferStats = NetworkPacket::GetBufferStats();
+    json_t jsonConnections = json_t::array();
+    for (const auto& connection : client_connection_list)
+    {
+        json_t jsonConnection = {
+            { "host", connection->Socket->GetHostName() },
+            { "clientTick", connection->ClientTick },
+            { "tickLag", connection->ClientTick != 0 ? gCurrentTicks - connection->ClientTick : 0 },
+            { "sendQueueBytes", connection->GetSendQueueSize() },
+            { "sendQueuePeakBytes", connection->GetSendQueuePeak() },
+            { "gameActionsReceived", connection->GameActionsReceived },
+            { "gameStateRequests", connection->GameStateRequests },
+            { "bytesSent", GetCommandBytesAsJson(connection->Stats.bytesSentByCommand) },
+            { "bytesReceived", GetCommandBytesAsJson(connection->Stats.bytesReceivedByCommand) },
+        };
+        if (connection->Player != nullptr)
+        {
+            jsonConnection["player"] = connection->Player->Name;
+            jsonConnection["playerId"] = connection->Player->Id;
+            jsonConnection["ping"] = connection->Player->Ping;
+        }
+        jsonConnections.push_back(jsonConnection);
+    }
+
+    json_t jsonObj = {
+        { "port", listening_port },
+        { "uptime", (platform_get_ticks() - _startTime) / 1000 },
+        { "tick", gCurrentTicks },
+        { "players", player_list.size() },
+        { "tickTime",
+          {
+              { "samples", tickTimes.size() },
+              { "p50", percentile(50) },
+              { "p95", percentile(95) },
+              { "p99", percentile(99) },
+              { "max", percentile(100) },
+          } },
+        { "gameActionsSent", _gameActionsSent },
+        { "packetBuffers",
+          {
+              { "allocations", bufferStats.Allocations },
+              { "bytesCopied", bufferStats.BytesCopied },
+          } },
+        { "connections", jsonConnections },
+    };
+    return jsonObj;
+}
+
+void NetworkBase::UpdateMetrics()
+{
+    if (gConfigNetwork.metrics_file.empty() || gConfigNetwork.metrics_interval <= 0)
+        return;
+
+    uint32_t ticks = platform_get_ticks();
+    if (ticks - _lastMetricsTime < static_cast<uint32_t>(gConfigNetwork.metrics_interval) * 1000)
+        return;
+    _lastMetricsTime = ticks;
+
+    // Written next to the target first so readers never see a partial file
+    const auto& path = gConfigNetwork.metrics_file;
+    auto tempPath = path + ".tmp";
+    try
+    {
+        Json::WriteToFile(tempPath.c_str(), GetMetricsAsJson());
+        if (!File::Move(tempPath, path))
+        {
+            File::Delete(path);
+            File::Move(tempPath, path);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        log_error("Unable to write metrics to '%s': %s", path.c_str(), e.what());
+    }
+}
+
 void NetworkBase::Server_Send_GAMEINFO(NetworkConnection& connection)
 {
     NetworkPacket packet(NetworkCommand::GameInfo);
@@ -1659,12 +2191,12 @@ void NetworkBase::Server_Send_EVENT_PLAYER_DISCONNECTED(const char* playerName,
     SendPacketToClients(packet);
 }
 
-bool NetworkBase::ProcessConnection(NetworkConnection& connection)
+bool NetworkBase::ProcessConnection(NetworkConnection& connection, bool readable)
 {
     NetworkReadPacket packetStatus;
     do
     {
-        packetStatus = connection.ReadPacket();
+        packetStatus = readable ? connection.ReadPacket() : NetworkReadPacket::NoData;
         switch (packetStatus)
         {
             case NetworkReadPacket::Disconnected:
@@ -1925,6 +2457,12 @@ void NetworkBase::ProcessDisconnectedClients()
         auto& connection = *it;
         if (connection->IsDisconnected)
         {
+            for (auto& snapshot : _mapSnapshots)
+            {
+                auto& waiting = snapshot.Waiting;
+                waiting.erase(std::remove(waiting.begin(), waiting.end(), connection.get()), waiting.end());
+            }
+            _socketPoller->Remove(connection->Socket.get());
             ServerClientDisconnected(connection);
             RemovePlayer(connection);
 
@@ -1947,6 +2485,7 @@ void NetworkBase::AddClient(std::unique_ptr<ITcpSocket>&& socket)
     // Store connection
     auto connection = std::make_unique<NetworkConnection>();
     connection->Socket = std::move(socket);
+    _socketPoller->Add(connection->Socket.get());
 
     client_connection_list.push_back(std::move(connection));
 }
@@ -2167,7 +2706,9 @@ void NetworkBase::Client_Handle_TOKEN(NetworkConnection& connection, NetworkPack
 void NetworkBase::Server_Handle_REQUEST_GAMESTATE(NetworkConnection& connection, NetworkPacket& packet)
 {
     uint32_t tick;
-    packet >> tick;
+    uint32_t numHashes;
+    packet >> tick >> numHashes;
+    connection.GameStateRequests++;
 
     if (_serverState.gamestateSnapshotsEnabled == false)
     {
@@ -2175,15 +2716,31 @@ void NetworkBase::Server_Handle_REQUEST_GAMESTATE(NetworkConnection& connection,
         return;
     }
 
+    std::vector<uint64_t> hashes;
+    numHashes = std::min<uint32_t>(numHashes, (MAX_SPRITES + GameStateSpriteRangeSize - 1) / GameStateSpriteRangeSize);
+    for (uint32_t i = 0; i < numHashes; i++)
+    {
+        uint64_t hash{};
+        packet >> hash;
+        hashes.push_back(hash);
+    }
+
     IGameStateSnapshots* snapshots = GetContext()->GetGameStateSnapshots();
 
     const GameStateSnapshot_t* snapshot = snapshots->GetLinkedSnapshot(tick);
-    if (snapshot)
+    if (snapshot == nullptr)
+    {
+        // The tick fell out of the history, the client has to carry on desynchronised
+        NetworkPacket packetGameStateChunk(NetworkCommand::GameState);
+        packetGameStateChunk << tick << uint32_t{ 0 } << uint32_t{ 0 } << uint32_t{ 0 };
+        connection.QueuePacket(std::move(packetGameStateChunk));
+    }
+    else
     {
         MemoryStream snapshotMemory;
         DataSerialiser ds(true, snapshotMemory);
 
-        snapshots->SerialiseSnapshot(const_cast<GameStateSnapshot_t&>(*snapshot), ds);
+        snapshots->SerialiseDelta(*snapshot, hashes, ds);
 
         uint32_t bytesSent = 0;
         uint32_t length = static_cast<uint32_t>(snapshotMemory.GetLength());
@@ -2396,6 +2953,13 @@ void NetworkBase::Client_Handle_GAMESTATE(NetworkConnection& connection, Network
 
     packet >> tick >> totalSize >> offset >> dataSize;
 
+    if (totalSize == 0)
+    {
+        log_warning("Server no longer has the game state of tick %u", tick);
+        FinishResynchronise(false);
+        return;
+    }
+
     if (offset == 0)
     {
         // Reset
@@ -2418,8 +2982,12 @@ void NetworkBase::Client_Handle_GAMESTATE(NetworkConnection& connection, Network
 
         IGameStateSnapshots* snapshots = GetContext()->GetGameStateSnapshots();
 
+        size_t numRanges = snapshots->ApplyDelta(ds);
+        log_info("Resynchronised %zu entity ranges for tick %u", numRanges, tick);
+
+        // After patching the entities match the server, capture them to report what had diverged
         GameStateSnapshot_t& serverSnapshot = snapshots->CreateSnapshot();
-        snapshots->SerialiseSnapshot(serverSnapshot, ds);
+        snapshots->Capture(serverSnapshot);
 
         const GameStateSnapshot_t* desyncSnapshot = snapshots->GetLinkedSnapshot(tick);
         if (desyncSnapshot)
@@ -2453,6 +3021,8 @@ void NetworkBase::Client_Handle_GAMESTATE(NetworkConnection& connection, Network
                 context_open_intent(&intent);
             }
         }
+
+        FinishResynchronise(true);
     }
 }
 
@@ -2615,10 +3185,10 @@ void NetworkBase::Server_Handle_AUTH(NetworkConnection& connection, NetworkPacke
 
 void NetworkBase::Client_Handle_MAP([[maybe_unused]] NetworkConnection& connection, NetworkPacket& packet)
 {
-    uint32_t size, offset;
-    packet >> size >> offset;
-    int32_t chunksize = static_cast<int32_t>(packet.Header.Size - packet.BytesRead);
-    if (chunksize <= 0)
+    uint32_t size, offset, frameSize;
+    packet >> size >> offset >> frameSize;
+    size_t payloadSize = packet.Header.Size - packet.BytesRead;
+    if (payloadSize == 0 || payloadSize > frameSize)
     {
         return;
     }
@@ -2630,15 +3200,36 @@ void NetworkBase::Client_Handle_MAP([[maybe_unused]] NetworkConnection& connecti
         GameActions::SuspendQueue();
 
         _serverTickData.clear();
+        _serverSpriteHashes.clear();
+        _spriteChecksumJobs.clear();
         _clientMapLoaded = false;
+        _mapBytesReceived = 0;
+        chunk_buffer.resize(size);
     }
-    if (size > chunk_buffer.size())
+    if (size != chunk_buffer.size() || offset + frameSize > size)
     {
-        chunk_buffer.resize(size);
+        log_warning("Received map frame outside of the map.");
+        Close();
+        return;
+    }
+
+    // Frames are independent, decompress each one straight into the map as it arrives
+    const auto* payload = static_cast<const uint8_t*>(packet.Read(payloadSize));
+    if (payloadSize == frameSize)
+    {
+        std::memcpy(&chunk_buffer[offset], payload, frameSize);
+    }
+    else if (!util_zlib_inflate_to(payload, payloadSize, &chunk_buffer[offset], frameSize))
+    {
+        log_warning("Failed to decompress data sent from server.");
+        Close();
+        return;
     }
+    _mapBytesReceived += frameSize;
+
     char str_downloading_map[256];
     uint32_t downloading_map_args[2] = {
-        (offset + chunksize) / 1024,
+        _mapBytesReceived / 1024,
         size / 1024,
     };
     format_string(str_downloading_map, 256, STR_MULTIPLAYER_DOWNLOADING_MAP, downloading_map_args);
@@ -2648,36 +3239,14 @@ void NetworkBase::Client_Handle_MAP([[maybe_unused]] NetworkConnection& connecti
     intent.putExtra(INTENT_EXTRA_CALLBACK, []() -> void { gNetwork.Close(); });
     context_open_intent(&intent);
 
-    std::memcpy(&chunk_buffer[offset], const_cast<void*>(static_cast<const void*>(packet.Read(chunksize))), chunksize);
-    if (offset + chunksize == size)
+    if (_mapBytesReceived == size)
     {
         // Allow queue processing of game actions again.
         GameActions::ResumeQueue();
 
         context_force_close_window_by_class(WC_NETWORK_STATUS);
-        bool has_to_free = false;
-        uint8_t* data = &chunk_buffer[0];
-        size_t data_size = size;
-        // zlib-compressed
-        if (strcmp("open2_sv6_zlib", reinterpret_cast<char*>(&chunk_buffer[0])) == 0)
-        {
-            log_verbose("Received zlib-compressed sv6 map");
-            has_to_free = true;
-            size_t header_len = strlen("open2_sv6_zlib") + 1;
-            data = util_zlib_inflate(&chunk_buffer[header_len], size - header_len, &data_size);
-            if (data == nullptr)
-            {
-                log_warning("Failed to decompress data sent from server.");
-                Close();
-                return;
-            }
-        }
-        else
-        {
-            log_verbose("Assuming received map is in plain sv6 format");
-        }
 
-        auto ms = MemoryStream(data, data_size);
+        auto ms = MemoryStream(chunk_buffer.data(), size, MEMORY_ACCESS::READ);
         if (LoadMap(&ms))
         {
             game_load_init();
@@ -2705,10 +3274,7 @@ void NetworkBase::Client_Handle_MAP([[maybe_unused]] NetworkConnection& connecti
             auto loadOrQuitAction = LoadOrQuitAction(LoadOrQuitModes::OpenSavePrompt, PromptMode::SaveBeforeQuit);
             GameActions::Execute(&loadOrQuitAction);
         }
-        if (has_to_free)
-        {
-            free(data);
-        }
+        chunk_buffer = {};
     }
 }
 
@@ -2778,34 +3344,7 @@ bool NetworkBase::SaveMap(IStream* stream, const std::vector<const ObjectReposit
         s6exporter->ExportObjectsList = objects;
         s6exporter->Export();
         s6exporter->SaveGame(stream);
-
-        // Write other data not in normal save files
-        stream->WriteValue<uint32_t>(gGamePaused);
-        stream->WriteValue<uint32_t>(_guestGenerationProbability);
-        stream->WriteValue<uint32_t>(_suggestedGuestMaximum);
-        stream->WriteValue<uint8_t>(gCheatsAllowTrackPlaceInvalidHeights);
-        stream->WriteValue<uint8_t>(gCheatsEnableAllDrawableTrackPieces);
-        stream->WriteValue<uint8_t>(gCheatsSandboxMode);
-        stream->WriteValue<uint8_t>(gCheatsDisableClearanceChecks);
-        stream->WriteValue<uint8_t>(gCheatsDisableSupportLimits);
-        stream->WriteValue<uint8_t>(gCheatsDisableTrainLengthLimit);
-        stream->WriteValue<uint8_t>(gCheatsEnableChainLiftOnAllTrack);
-        stream->WriteValue<uint8_t>(gCheatsShowAllOperatingModes);
-        stream->WriteValue<uint8_t>(gCheatsShowVehiclesFromOtherTrackTypes);
-        stream->WriteValue<uint8_t>(gCheatsFastLiftHill);
-        stream->WriteValue<uint8_t>(gCheatsDisableBrakesFailure);
-        stream->WriteValue<uint8_t>(gCheatsDisableAllBreakdowns);
-        stream->WriteValue<uint8_t>(gCheatsBuildInPauseMode);
-        stream->WriteValue<uint8_t>(gCheatsIgnoreRideIntensity);
-        stream->WriteValue<uint8_t>(gCheatsDisableVandalism);
-        stream->WriteValue<uint8_t>(gCheatsDisableLittering);
-        stream->WriteValue<uint8_t>(gCheatsNeverendingMarketing);
-        stream->WriteValue<uint8_t>(gCheatsFreezeWeather);
-        stream->WriteValue<uint8_t>(gCheatsDisablePlantAging);
-        stream->WriteValue<uint8_t>(gCheatsAllowArbitraryRideTypeChanges);
-        stream->WriteValue<uint8_t>(gCheatsDisableRideValueAging);
-        stream->WriteValue<uint8_t>(gConfigGeneral.show_real_names_of_guests);
-        stream->WriteValue<uint8_t>(gCheatsIgnoreResearchStatus);
+        SaveMapExtras(stream);
 
         result = true;
     }
@@ -2815,6 +3354,37 @@ bool NetworkBase::SaveMap(IStream* stream, const std::vector<const ObjectReposit
     return result;
 }
 
+void NetworkBase::SaveMapExtras(IStream* stream) const
+{
+    // Write other data not in normal save files
+    stream->WriteValue<uint32_t>(gGamePaused);
+    stream->WriteValue<uint32_t>(_guestGenerationProbability);
+    stream->WriteValue<uint32_t>(_suggestedGuestMaximum);
+    stream->WriteValue<uint8_t>(gCheatsAllowTrackPlaceInvalidHeights);
+    stream->WriteValue<uint8_t>(gCheatsEnableAllDrawableTrackPieces);
+    stream->WriteValue<uint8_t>(gCheatsSandboxMode);
+    stream->WriteValue<uint8_t>(gCheatsDisableClearanceChecks);
+    stream->WriteValue<uint8_t>(gCheatsDisableSupportLimits);
+    stream->WriteValue<uint8_t>(gCheatsDisableTrainLengthLimit);
+    stream->WriteValue<uint8_t>(gCheatsEnableChainLiftOnAllTrack);
+    stream->WriteValue<uint8_t>(gCheatsShowAllOperatingModes);
+    stream->WriteValue<uint8_t>(gCheatsShowVehiclesFromOtherTrackTypes);
+    stream->WriteValue<uint8_t>(gCheatsFastLiftHill);
+    stream->WriteValue<uint8_t>(gCheatsDisableBrakesFailure);
+    stream->WriteValue<uint8_t>(gCheatsDisableAllBreakdowns);
+    stream->WriteValue<uint8_t>(gCheatsBuildInPauseMode);
+    stream->WriteValue<uint8_t>(gCheatsIgnoreRideIntensity);
+    stream->WriteValue<uint8_t>(gCheatsDisableVandalism);
+    stream->WriteValue<uint8_t>(gCheatsDisableLittering);
+    stream->WriteValue<uint8_t>(gCheatsNeverendingMarketing);
+    stream->WriteValue<uint8_t>(gCheatsFreezeWeather);
+    stream->WriteValue<uint8_t>(gCheatsDisablePlantAging);
+    stream->WriteValue<uint8_t>(gCheatsAllowArbitraryRideTypeChanges);
+    stream->WriteValue<uint8_t>(gCheatsDisableRideValueAging);
+    stream->WriteValue<uint8_t>(gConfigGeneral.show_real_names_of_guests);
+    stream->WriteValue<uint8_t>(gCheatsIgnoreResearchStatus);
+}
+
 void NetworkBase::Client_Handle_CHAT([[maybe_unused]] NetworkConnection& connection, NetworkPacket& packet)
 {
     const char* text = packet.ReadString();
@@ -2890,40 +3460,56 @@ void NetworkBase::Server_Handle_CHAT(NetworkConnection& connection, NetworkPacke
     Server_Send_CHAT(formatted);
 }
 
-void NetworkBase::Client_Handle_GAME_ACTION([[maybe_unused]] NetworkConnection& connection, NetworkPacket& packet)
+void NetworkBase::Client_Handle_GAME_ACTION_BATCH([[maybe_unused]] NetworkConnection& connection, NetworkPacket& packet)
 {
     uint32_t tick;
-    uint32_t actionType;
-    packet >> tick >> actionType;
+    packet >> tick;
 
-    MemoryStream stream;
-    const size_t size = packet.Header.Size - packet.BytesRead;
-    stream.WriteArray(packet.Read(size), size);
-    stream.SetPosition(0);
+    while (packet.BytesRead < packet.Header.Size)
+    {
+        uint32_t actionType;
+        uint32_t actionSize;
+        if (!ReadVarUInt(packet, actionType) || !ReadVarUInt(packet, actionSize))
+        {
+            log_error("Received malformed game action batch for tick %u", tick);
+            return;
+        }
 
-    DataSerialiser ds(false, stream);
+        const uint8_t* actionData = packet.Read(actionSize);
+        if (actionData == nullptr)
+        {
+            log_error("Received truncated game action batch for tick %u", tick);
+            return;
+        }
 
-    GameAction::Ptr action = GameActions::Create(actionType);
-    if (action == nullptr)
-    {
-        log_error("Received unregistered game action type: 0x%08X", actionType);
-        return;
-    }
-    action->Serialise(ds);
+        GameAction::Ptr action = GameActions::Create(actionType);
+        if (action == nullptr)
+        {
+            log_error("Received unregistered game action type: 0x%08X", actionType);
+            continue;
+        }
 
-    if (player_id == action->GetPlayer().id)
-    {
-        // Only execute callbacks that belong to us,
-        // clients can have identical network ids assigned.
-        auto itr = _gameActionCallbacks.find(action->GetNetworkId());
-        if (itr != _gameActionCallbacks.end())
+        MemoryStream stream;
+        stream.WriteArray(actionData, actionSize);
+        stream.SetPosition(0);
+
+        DataSerialiser ds(false, stream);
+        action->Serialise(ds);
+
+        if (player_id == action->GetPlayer().id)
         {
-            action->SetCallback(itr->second);
-            _gameActionCallbacks.erase(itr);
+            // Only execute callbacks that belong to us,
+            // clients can have identical network ids assigned.
+            auto itr = _gameActionCallbacks.find(action->GetNetworkId());
+            if (itr != _gameActionCallbacks.end())
+            {
+                action->SetCallback(itr->second);
+                _gameActionCallbacks.erase(itr);
+            }
         }
-    }
 
-    GameActions::Enqueue(std::move(action), tick);
+        GameActions::Enqueue(std::move(action), tick);
+    }
 }
 
 void NetworkBase::Server_Handle_GAME_ACTION(NetworkConnection& connection, NetworkPacket& packet)
@@ -2938,6 +3524,7 @@ void NetworkBase::Server_Handle_GAME_ACTION(NetworkConnection& connection, Netwo
     }
 
     packet >> tick >> actionType;
+    connection.GameActionsReceived++;
 
     // Don't let clients send pause or quit
     if (actionType == GAME_COMMAND_TOGGLE_PAUSE || actionType == GAME_COMMAND_LOAD_OR_QUIT)
@@ -3012,10 +3599,13 @@ void NetworkBase::Client_Handle_TICK([[maybe_unused]] NetworkConnection& connect
 
     if (flags & NETWORK_TICK_FLAG_CHECKSUMS)
     {
+        // The checksum belongs to an earlier tick, it was computed while the game carried on
+        uint32_t checksumTick;
+        packet >> checksumTick;
         const char* text = packet.ReadString();
         if (text != nullptr)
         {
-            tickData.spriteHash = text;
+            _serverSpriteHashes[checksumTick] = text;
         }
     }
 
@@ -3024,6 +3614,10 @@ void NetworkBase::Client_Handle_TICK([[maybe_unused]] NetworkConnection& connect
     {
         _serverTickData.erase(_serverTickData.begin());
     }
+    while (_serverSpriteHashes.size() > SPRITE_CHECKSUM_MAX_PENDING)
+    {
+        _serverSpriteHashes.erase(_serverSpriteHashes.begin());
+    }
 
     _serverState.tick = serverTick;
     _serverTickData.emplace(serverTick, tickData);
@@ -3063,8 +3657,10 @@ void NetworkBase::Client_Handle_PING([[maybe_unused]] NetworkConnection& connect
     Client_Send_PING();
 }
 
-void NetworkBase::Server_Handle_PING(NetworkConnection& connection, [[maybe_unused]] NetworkPacket& packet)
+void NetworkBase::Server_Handle_PING(NetworkConnection& connection, NetworkPacket& packet)
 {
+    packet >> connection.ClientTick;
+
     int32_t ping = platform_get_ticks() - connection.PingTime;
     if (ping < 0)
     {
@@ -3232,6 +3828,11 @@ void network_update()
     gNetwork.Update();
 }
 
+void network_wait(uint32_t timeoutMs)
+{
+    gNetwork.Wait(timeoutMs);
+}
+
 void network_process_pending()
 {
     gNetwork.ProcessPending();
@@ -3267,6 +3868,11 @@ void network_request_gamestate_snapshot()
     return gNetwork.RequestStateSnapshot();
 }
 
+bool network_is_resynchronising()
+{
+    return gNetwork.IsResynchronising();
+}
+
 void network_send_tick()
 {
     gNetwork.Server_Send_TICK();
@@ -4011,6 +4617,10 @@ bool network_check_desynchronisation()
 void network_request_gamestate_snapshot()
 {
 }
+bool network_is_resynchronising()
+{
+    return false;
+}
 void network_send_game_action(const GameAction* action)
 {
 }
@@ -4020,6 +4630,10 @@ void network_send_map()
 void network_update()
 {
 }
+void network_wait(uint32_t timeoutMs)
+{
+    platform_sleep(timeoutMs);
+}
 void network_process_pending()
 {
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../actions/GameAction.h"
+#include "../core/CircularBuffer.h"
+#include "../world/Sprite.h"
 #include "NetworkConnection.h"
 #include "NetworkGroup.h"
 #include "NetworkPlayer.h"
@@ -8,7 +10,11 @@
 #include "NetworkTypes.h"
 #include "NetworkUser.h"
 
+#include <chrono>
 #include <fstream>
+#include <future>
+#include <mutex>
+#include <optional>
 
 #ifndef DISABLE_NETWORK
 
@@ -43,8 +49,9 @@ public: // Common
     void CloseChatLog();
     NetworkStats_t GetStats() const;
     json_t GetServerInfoAsJson() const;
-    bool ProcessConnection(NetworkConnection& connection);
+    bool ProcessConnection(NetworkConnection& connection, bool readable = true);
     void CloseConnection();
+    void QueueSpriteChecksum();
     NetworkPlayer* AddPlayer(const std::string& name, const std::string& keyhash);
     void ProcessPacket(NetworkConnection& connection, NetworkPacket& packet);
 
@@ -67,9 +74,16 @@ public: // Server
     void SetupDefaultGroups();
     void RemovePlayer(std::unique_ptr<NetworkConnection>& connection);
     void UpdateServer();
+    void Wait(uint32_t timeoutMs);
+    void PollSockets(uint32_t timeoutMs);
+    bool IsSocketReady(const ITcpSocket* socket) const;
+    void AcceptClient();
     void ServerClientDisconnected(std::unique_ptr<NetworkConnection>& connection);
     bool SaveMap(OpenRCT2::IStream* stream, const std::vector<const ObjectRepositoryItem*>& objects) const;
-    std::vector<uint8_t> save_for_network(const std::vector<const ObjectRepositoryItem*>& objects) const;
+    void SaveMapExtras(OpenRCT2::IStream* stream) const;
+    static NetworkPacket CreateMapFramePacket(const uint8_t* data, uint32_t size, uint32_t offset, bool compress = true);
+    void QueueMapSnapshot(NetworkConnection& connection);
+    void UpdateMapSnapshots();
     std::string MakePlayerNameUnique(const std::string& name);
 
     // Packet dispatchers.
@@ -78,6 +92,9 @@ public: // Server
     void Server_Send_MAP(NetworkConnection* connection = nullptr);
     void Server_Send_CHAT(const char* text, const std::vector<uint8_t>& playerIds = {});
     void Server_Send_GAME_ACTION(const GameAction* action);
+    void Server_Send_GAME_ACTION_BATCH();
+    json_t GetMetricsAsJson() const;
+    void UpdateMetrics();
     void Server_Send_TICK();
     void Server_Send_PLAYERINFO(int32_t playerId);
     void Server_Send_PLAYERLIST();
@@ -115,9 +132,13 @@ public: // Client
     static const char* FormatChat(NetworkPlayer* fromplayer, const char* text);
     void SendPacketToClients(const NetworkPacket& packet, bool front = false, bool gameCmd = false);
     bool CheckSRAND(uint32_t tick, uint32_t srand0);
+    bool CheckSpriteChecksums();
     bool CheckDesynchronizaton();
     void RequestStateSnapshot();
     bool IsDesynchronised();
+    bool IsResynchronising() const;
+    bool CanResynchronise() const;
+    void FinishResynchronise(bool success);
     NetworkServerState_t GetServerState() const;
     void ServerClientDisconnected();
     bool LoadMap(OpenRCT2::IStream* stream);
@@ -139,7 +160,7 @@ public: // Client
     void Client_Handle_AUTH(NetworkConnection& connection, NetworkPacket& packet);
     void Client_Handle_MAP(NetworkConnection& connection, NetworkPacket& packet);
     void Client_Handle_CHAT(NetworkConnection& connection, NetworkPacket& packet);
-    void Client_Handle_GAME_ACTION(NetworkConnection& connection, NetworkPacket& packet);
+    void Client_Handle_GAME_ACTION_BATCH(NetworkConnection& connection, NetworkPacket& packet);
     void Client_Handle_TICK(NetworkConnection& connection, NetworkPacket& packet);
     void Client_Handle_PLAYERINFO(NetworkConnection& connection, NetworkPacket& packet);
     void Client_Handle_PLAYERLIST(NetworkConnection& connection, NetworkPacket& packet);
@@ -175,6 +196,7 @@ private: // Common Data
 
     std::shared_ptr<OpenRCT2::IPlatformEnvironment> _env;
     std::vector<uint8_t> chunk_buffer;
+    uint32_t _mapBytesReceived = 0;
     std::ofstream _chat_log_fs;
     uint32_t _lastUpdateTime = 0;
     uint32_t _currentDeltaTime = 0;
@@ -184,9 +206,19 @@ private: // Common Data
     bool _requireClose = false;
     bool wsa_initialized = false;
 
+    // Sprite checksum of a tick, hashed on a worker thread from a copy of the entities taken at the start of the tick.
+    struct SpriteChecksumJob
+    {
+        uint32_t Tick = 0;
+        std::future<rct_sprite_checksum> Result;
+    };
+    std::list<SpriteChecksumJob> _spriteChecksumJobs;
+
 private: // Server Data
     std::unordered_map<NetworkCommand, CommandHandler> server_command_handlers;
     std::unique_ptr<ITcpSocket> _listenSocket;
+    std::unique_ptr<ISocketPoller> _socketPoller;
+    std::vector<ITcpSocket*> _readySockets;
     std::unique_ptr<INetworkServerAdvertiser> _advertiser;
     std::list<std::unique_ptr<NetworkConnection>> client_connection_list;
     std::string _serverLogPath;
@@ -194,6 +226,38 @@ private: // Server Data
     std::ofstream _server_log_fs;
     uint16_t listening_port = 0;
     bool _playerListInvalidated = false;
+    NetworkPacketBufferStats _lastPacketBufferStats;
+
+    // Game actions of one tick are sent to the clients as a single packet.
+    NetworkPacket _gameActionBatch{ NetworkCommand::GameActionBatch };
+    uint32_t _gameActionBatchTick = 0;
+
+    // Reported in the metrics file, tick times are in microseconds and measured from the tick packet to the flush.
+    CircularBuffer<uint32_t, 1000> _tickTimes;
+    std::optional<std::chrono::high_resolution_clock::time_point> _tickStartTime;
+    uint64_t _gameActionsSent = 0;
+    uint32_t _startTime = 0;
+    uint32_t _lastMetricsTime = 0;
+
+    // Frames compressed by a map snapshot job that have not been picked up by the server yet.
+    struct MapSnapshotStream
+    {
+        std::mutex Mutex;
+        std::vector<NetworkPacket> Frames;
+        bool Failed = false;
+    };
+
+    // Compressed maps sent to joining clients, shared by every join that asks for the same objects on the same tick.
+    struct MapSnapshot
+    {
+        uint32_t Tick = 0;
+        std::vector<const ObjectRepositoryItem*> Objects;
+        std::shared_ptr<MapSnapshotStream> Stream;
+        std::future<void> Job;
+        std::vector<std::shared_ptr<const NetworkPacketBuffer>> Packets;
+        std::vector<NetworkConnection*> Waiting;
+    };
+    std::list<MapSnapshot> _mapSnapshots;
 
 private: // Client Data
     struct PlayerListUpdate
@@ -205,7 +269,6 @@ private: // Client Data
     {
         uint32_t srand0;
         uint32_t tick;
-        std::string spriteHash;
     };
 
     std::unordered_map<NetworkCommand, CommandHandler> client_command_handlers;
@@ -213,6 +276,7 @@ private: // Client Data
     std::map<uint32_t, PlayerListUpdate> _pendingPlayerLists;
     std::multimap<uint32_t, NetworkPlayer> _pendingPlayerInfo;
     std::map<uint32_t, ServerTickData_t> _serverTickData;
+    std::map<uint32_t, std::string> _serverSpriteHashes;
     std::vector<std::string> _missingObjects;
     std::string _host;
     std::string _chatLogPath;
@@ -230,6 +294,8 @@ private: // Client Data
     SocketStatus _lastConnectStatus = SocketStatus::Closed;
     bool _requireReconnect = false;
     bool _clientMapLoaded = false;
+    bool _resynchronising = false;
+    std::optional<uint32_t> _lastResyncTick;
 };
 
 #endif // DISABLE_NETWORK
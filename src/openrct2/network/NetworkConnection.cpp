@@ -19,6 +19,8 @@
 
 constexpr size_t NETWORK_DISCONNECT_REASON_BUFFER_SIZE = 256;
 constexpr size_t NetworkBufferSize = 1024 * 64; // 64 KiB, maximum packet size.
+constexpr size_t MaxPacketsPerSend = 256;
+constexpr size_t SendQueueHighWaterMark = 1024 * 1024 * 8; // 8 MiB, logged when a client falls this far behind.
 
 NetworkConnection::NetworkConnection()
 {
@@ -89,7 +91,7 @@ NetworkReadPacket NetworkConnection::ReadPacket()
             // Received complete packet.
             _lastPacketTime = platform_get_ticks();
 
-            RecordPacketStats(InboundPacket, false);
+            RecordPacketStats(InboundPacket.GetCommand(), InboundPacket.BytesTransferred, false);
 
             return NetworkReadPacket::Success;
         }
@@ -98,44 +100,28 @@ NetworkReadPacket NetworkConnection::ReadPacket()
     return NetworkReadPacket::MoreData;
 }
 
-bool NetworkConnection::SendPacket(NetworkPacket& packet)
+void NetworkConnection::QueuePacket(const NetworkPacket& packet, bool front)
 {
-    auto header = packet.Header;
-
-    std::vector<uint8_t> buffer;
-    buffer.reserve(sizeof(header) + header.Size);
-
-    // NOTE: For compatibility reasons for the master server we need to add sizeof(Header.Id) to the size.
-    // Previously the Id field was not part of the header rather part of the body.
-    header.Size += sizeof(header.Id);
-    header.Size = Convert::HostToNetwork(header.Size);
-    header.Id = ByteSwapBE(header.Id);
-
-    buffer.insert(buffer.end(), reinterpret_cast<uint8_t*>(&header), reinterpret_cast<uint8_t*>(&header) + sizeof(header));
-    buffer.insert(buffer.end(), packet.Data.begin(), packet.Data.end());
-
-    size_t bufferSize = buffer.size() - packet.BytesTransferred;
-    size_t sent = Socket->SendData(buffer.data() + packet.BytesTransferred, bufferSize);
-    if (sent > 0)
-    {
-        packet.BytesTransferred += sent;
-    }
-
-    bool sendComplete = packet.BytesTransferred == buffer.size();
-    if (sendComplete)
+    if (AuthStatus == NetworkAuth::Ok || !packet.CommandRequiresAuth())
     {
-        RecordPacketStats(packet, true);
+        QueuePacket(packet.Encode(), front);
     }
-    return sendComplete;
 }
 
-void NetworkConnection::QueuePacket(NetworkPacket&& packet, bool front)
+void NetworkConnection::QueuePacket(const std::shared_ptr<const NetworkPacketBuffer>& buffer, bool front)
 {
-    if (AuthStatus == NetworkAuth::Ok || !packet.CommandRequiresAuth())
+    if (AuthStatus == NetworkAuth::Ok || !buffer->CommandRequiresAuth())
     {
-        packet.Header.Size = static_cast<uint16_t>(packet.Data.size());
+        OutboundPacket packet{ buffer };
+        AddOutboundBytes(buffer->Bytes.size());
+
         if (front)
         {
+            if (_holdingPackets)
+            {
+                _holdPosition++;
+            }
+
             // If the first packet was already partially sent add new packet to second position
             if (!_outboundPackets.empty() && _outboundPackets.front().BytesTransferred > 0)
             {
@@ -157,10 +143,110 @@ void NetworkConnection::QueuePacket(NetworkPacket&& packet, bool front)
 
 void NetworkConnection::SendQueuedPackets()
 {
-    while (!_outboundPackets.empty() && SendPacket(_outboundPackets.front()))
+    if (_outboundPackets.empty())
+    {
+        return;
+    }
+
+    // Gather the pending packets so they go out in a single write
+    size_t maxPackets = _holdingPackets ? std::min(_holdPosition, MaxPacketsPerSend) : MaxPacketsPerSend;
+    _sendBuffers.clear();
+    for (const auto& packet : _outboundPackets)
     {
+        if (_sendBuffers.size() >= maxPackets)
+            break;
+
+        const auto& bytes = packet.Buffer->Bytes;
+        _sendBuffers.push_back({ bytes.data() + packet.BytesTransferred, bytes.size() - packet.BytesTransferred });
+    }
+
+    if (_sendBuffers.empty())
+    {
+        return;
+    }
+
+    size_t sent = Socket->SendData(_sendBuffers.data(), _sendBuffers.size());
+    _outboundBytes -= sent;
+
+    // Retire everything that was fully written, the first packet not completed keeps its offset for the next call
+    while (sent > 0 && !_outboundPackets.empty())
+    {
+        auto& packet = _outboundPackets.front();
+        size_t packetSize = packet.Buffer->Bytes.size();
+        size_t written = std::min(sent, packetSize - packet.BytesTransferred);
+        packet.BytesTransferred += written;
+        sent -= written;
+        if (packet.BytesTransferred < packetSize)
+        {
+            break;
+        }
+
+        RecordPacketStats(packet.Buffer->Command, packetSize, true);
         _outboundPackets.pop_front();
+        if (_holdingPackets)
+        {
+            _holdPosition--;
+        }
     }
+
+    if (_outboundBytes <= SendQueueHighWaterMark / 2)
+    {
+        _outboundAboveHighWater = false;
+    }
+}
+
+void NetworkConnection::HoldPackets()
+{
+    if (!_holdingPackets)
+    {
+        _holdingPackets = true;
+        _holdPosition = _outboundPackets.size();
+    }
+}
+
+void NetworkConnection::InsertHeldPackets(const std::vector<std::shared_ptr<const NetworkPacketBuffer>>& buffers)
+{
+    if (!_holdingPackets)
+    {
+        return;
+    }
+
+    for (const auto& buffer : buffers)
+    {
+        if (AuthStatus == NetworkAuth::Ok || !buffer->CommandRequiresAuth())
+        {
+            AddOutboundBytes(buffer->Bytes.size());
+            _outboundPackets.insert(_outboundPackets.begin() + _holdPosition, OutboundPacket{ buffer });
+            _holdPosition++;
+        }
+    }
+}
+
+void NetworkConnection::ReleaseHeldPackets()
+{
+    _holdingPackets = false;
+    _holdPosition = 0;
+}
+
+void NetworkConnection::AddOutboundBytes(size_t size)
+{
+    _outboundBytes += size;
+    _outboundBytesPeak = std::max(_outboundBytesPeak, _outboundBytes);
+    if (_outboundBytes > SendQueueHighWaterMark && !_outboundAboveHighWater)
+    {
+        _outboundAboveHighWater = true;
+        log_warning("Send queue of %s exceeds %zu bytes", Socket->GetHostName(), SendQueueHighWaterMark);
+    }
+}
+
+size_t NetworkConnection::GetSendQueueSize() const
+{
+    return _outboundBytes;
+}
+
+size_t NetworkConnection::GetSendQueuePeak() const
+{
+    return _outboundBytesPeak;
 }
 
 void NetworkConnection::ResetLastPacketTime()
@@ -207,14 +293,15 @@ void NetworkConnection::SetLastDisconnectReason(const rct_string_id string_id, v
     SetLastDisconnectReason(buffer);
 }
 
-void NetworkConnection::RecordPacketStats(const NetworkPacket& packet, bool sending)
+void NetworkConnection::RecordPacketStats(NetworkCommand command, size_t size, bool sending)
 {
-    uint32_t packetSize = static_cast<uint32_t>(packet.BytesTransferred);
+    uint32_t packetSize = static_cast<uint32_t>(size);
     NetworkStatisticsGroup trafficGroup;
 
-    switch (packet.GetCommand())
+    switch (command)
     {
         case NetworkCommand::GameAction:
+        case NetworkCommand::GameActionBatch:
             trafficGroup = NetworkStatisticsGroup::Commands;
             break;
         case NetworkCommand::Map:
@@ -225,15 +312,21 @@ void NetworkConnection::RecordPacketStats(const NetworkPacket& packet, bool send
             break;
     }
 
+    // Peers may send anything as the command
+    bool knownCommand = command < NetworkCommand::Max;
     if (sending)
     {
         Stats.bytesSent[EnumValue(trafficGroup)] += packetSize;
         Stats.bytesSent[EnumValue(NetworkStatisticsGroup::Total)] += packetSize;
+        if (knownCommand)
+            Stats.bytesSentByCommand[EnumValue(command)] += packetSize;
     }
     else
     {
         Stats.bytesReceived[EnumValue(trafficGroup)] += packetSize;
         Stats.bytesReceived[EnumValue(NetworkStatisticsGroup::Total)] += packetSize;
+        if (knownCommand)
+            Stats.bytesReceivedByCommand[EnumValue(command)] += packetSize;
     }
 }
 
@@ -32,6 +32,9 @@ public:
     NetworkStats_t Stats = {};
     NetworkPlayer* Player = nullptr;
     uint32_t PingTime = 0;
+    uint32_t ClientTick = 0;
+    uint64_t GameActionsReceived = 0;
+    uint32_t GameStateRequests = 0;
     NetworkKey Key;
     std::vector<uint8_t> Challenge;
     std::vector<const ObjectRepositoryItem*> RequestedObjects;
@@ -41,14 +44,29 @@ public:
     ~NetworkConnection();
 
     NetworkReadPacket ReadPacket();
-    void QueuePacket(NetworkPacket&& packet, bool front = false);
-    void QueuePacket(const NetworkPacket& packet, bool front = false)
-    {
-        auto copy = packet;
-        return QueuePacket(std::move(copy), front);
-    }
+    void QueuePacket(const NetworkPacket& packet, bool front = false);
+    void QueuePacket(const std::shared_ptr<const NetworkPacketBuffer>& buffer, bool front = false);
 
     void SendQueuedPackets();
+
+    /**
+     * Packets queued from now on are held back until ReleaseHeldPackets is called, everything queued before keeps
+     * being sent.
+     */
+    void HoldPackets();
+
+    /**
+     * Inserts the given packets ahead of those held back since HoldPackets, they are sent right away.
+     */
+    void InsertHeldPackets(const std::vector<std::shared_ptr<const NetworkPacketBuffer>>& buffers);
+
+    /**
+     * Resumes sending the packets held back since HoldPackets.
+     */
+    void ReleaseHeldPackets();
+
+    size_t GetSendQueueSize() const;
+    size_t GetSendQueuePeak() const;
     void ResetLastPacketTime();
     bool ReceivedPacketRecently();
 
@@ -57,12 +75,24 @@ public:
     void SetLastDisconnectReason(const rct_string_id string_id, void* args = nullptr);
 
 private:
-    std::deque<NetworkPacket> _outboundPackets;
+    struct OutboundPacket
+    {
+        std::shared_ptr<const NetworkPacketBuffer> Buffer;
+        size_t BytesTransferred = 0;
+    };
+
+    std::deque<OutboundPacket> _outboundPackets;
+    std::vector<SocketSendBuffer> _sendBuffers;
+    size_t _outboundBytes = 0;
+    size_t _outboundBytesPeak = 0;
+    bool _outboundAboveHighWater = false;
+    bool _holdingPackets = false;
+    size_t _holdPosition = 0;
     uint32_t _lastPacketTime = 0;
     utf8* _lastDisconnectReason = nullptr;
 
-    void RecordPacketStats(const NetworkPacket& packet, bool sending);
-    bool SendPacket(NetworkPacket& packet);
+    void RecordPacketStats(NetworkCommand command, size_t size, bool sending);
+    void AddOutboundBytes(size_t size);
 };
 
 #endif // DISABLE_NETWORK
@@ -12,9 +12,37 @@
 #    include "NetworkPacket.h"
 
 #    include "NetworkTypes.h"
+#    include "Socket.h"
 
+#    include <atomic>
 #    include <memory>
 
+// Packets are encoded from more than one thread, the counters are only read as a snapshot
+static std::atomic<uint64_t> _bufferAllocations;
+static std::atomic<uint64_t> _bufferBytesCopied;
+
+static bool CommandRequiresAuth(NetworkCommand command)
+{
+    switch (command)
+    {
+        case NetworkCommand::Ping:
+        case NetworkCommand::Auth:
+        case NetworkCommand::Token:
+        case NetworkCommand::GameInfo:
+        case NetworkCommand::ObjectsList:
+        case NetworkCommand::MapRequest:
+        case NetworkCommand::Heartbeat:
+            return false;
+        default:
+            return true;
+    }
+}
+
+bool NetworkPacketBuffer::CommandRequiresAuth() const
+{
+    return ::CommandRequiresAuth(Command);
+}
+
 NetworkPacket::NetworkPacket(NetworkCommand id)
     : Header{ 0, id }
 {
@@ -42,21 +70,41 @@ void NetworkPacket::Clear()
     Data.clear();
 }
 
-bool NetworkPacket::CommandRequiresAuth()
+bool NetworkPacket::CommandRequiresAuth() const
 {
-    switch (GetCommand())
-    {
-        case NetworkCommand::Ping:
-        case NetworkCommand::Auth:
-        case NetworkCommand::Token:
-        case NetworkCommand::GameInfo:
-        case NetworkCommand::ObjectsList:
-        case NetworkCommand::MapRequest:
-        case NetworkCommand::Heartbeat:
-            return false;
-        default:
-            return true;
-    }
+    return ::CommandRequiresAuth(GetCommand());
+}
+
+std::shared_ptr<const NetworkPacketBuffer> NetworkPacket::Encode() const
+{
+    PacketHeader header;
+    header.Size = static_cast<uint16_t>(Data.size());
+    header.Id = Header.Id;
+
+    // NOTE: For compatibility reasons for the master server we need to add sizeof(Header.Id) to the size.
+    // Previously the Id field was not part of the header rather part of the body.
+    header.Size += sizeof(header.Id);
+    header.Size = Convert::HostToNetwork(header.Size);
+    header.Id = ByteSwapBE(header.Id);
+
+    auto buffer = std::make_shared<NetworkPacketBuffer>();
+    buffer->Command = Header.Id;
+    buffer->Bytes.reserve(sizeof(header) + Data.size());
+    buffer->Bytes.insert(
+        buffer->Bytes.end(), reinterpret_cast<const uint8_t*>(&header), reinterpret_cast<const uint8_t*>(&header) + sizeof(header));
+    buffer->Bytes.insert(buffer->Bytes.end(), Data.begin(), Data.end());
+
+    _bufferAllocations.fetch_add(1, std::memory_order_relaxed);
+    _bufferBytesCopied.fetch_add(buffer->Bytes.size(), std::memory_order_relaxed);
+    return buffer;
+}
+
+NetworkPacketBufferStats NetworkPacket::GetBufferStats()
+{
+    NetworkPacketBufferStats stats;
+    stats.Allocations = _bufferAllocations.load(std::memory_order_relaxed);
+    stats.BytesCopied = _bufferBytesCopied.load(std::memory_order_relaxed);
+    return stats;
 }
 
 void NetworkPacket::Write(const void* bytes, size_t size)
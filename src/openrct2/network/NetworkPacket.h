@@ -25,6 +25,24 @@ struct PacketHeader
 static_assert(sizeof(PacketHeader) == 6);
 #pragma pack(pop)
 
+/**
+ * The wire encoding of a packet, header included. It is never modified after being created, so a single buffer can be
+ * queued on any number of connections.
+ */
+struct NetworkPacketBuffer final
+{
+    NetworkCommand Command = NetworkCommand::Invalid;
+    std::vector<uint8_t> Bytes;
+
+    bool CommandRequiresAuth() const;
+};
+
+struct NetworkPacketBufferStats
+{
+    uint64_t Allocations = 0;
+    uint64_t BytesCopied = 0;
+};
+
 struct NetworkPacket final
 {
     NetworkPacket() = default;
@@ -36,7 +54,10 @@ struct NetworkPacket final
     NetworkCommand GetCommand() const;
 
     void Clear();
-    bool CommandRequiresAuth();
+    bool CommandRequiresAuth() const;
+
+    std::shared_ptr<const NetworkPacketBuffer> Encode() const;
+    static NetworkPacketBufferStats GetBufferStats();
 
     const uint8_t* Read(size_t size);
     const utf8* ReadString();
@@ -83,6 +83,7 @@ enum class NetworkCommand : uint32_t
     GameState,
     Scripts,
     Heartbeat,
+    GameActionBatch,
     Max,
     Invalid = static_cast<uint32_t>(-1),
 };
@@ -145,4 +146,6 @@ struct NetworkStats_t
 {
     uint64_t bytesReceived[EnumValue(NetworkStatisticsGroup::Max)];
     uint64_t bytesSent[EnumValue(NetworkStatisticsGroup::Max)];
+    uint64_t bytesReceivedByCommand[EnumValue(NetworkCommand::Max)];
+    uint64_t bytesSentByCommand[EnumValue(NetworkCommand::Max)];
 };
@@ -9,6 +9,7 @@
 
 #ifndef DISABLE_NETWORK
 
+#    include <algorithm>
 #    include <atomic>
 #    include <chrono>
 #    include <cmath>
@@ -51,6 +52,11 @@
     #include <netinet/tcp.h>
     #include <sys/ioctl.h>
     #include <sys/socket.h>
+    #include <sys/uio.h>
+    #include <unistd.h>
+    #if defined(__linux__)
+        #include <sys/epoll.h>
+    #endif // defined(__linux__)
     #include "../common.h"
     using SOCKET = int32_t;
     #define SOCKET_ERROR -1
@@ -250,6 +256,8 @@ private:
 class TcpSocket final : public ITcpSocket, protected Socket
 {
 private:
+    static constexpr size_t MaxSendBuffersPerCall = 64;
+
     std::atomic<SocketStatus> _status = ATOMIC_VAR_INIT(SocketStatus::Closed);
     uint16_t _listeningPort = 0;
     SOCKET _socket = INVALID_SOCKET;
@@ -262,6 +270,11 @@ private:
 public:
     TcpSocket() = default;
 
+    SOCKET GetSocket() const
+    {
+        return _socket;
+    }
+
     ~TcpSocket() override
     {
         if (_connectFuture.valid())
@@ -566,6 +579,76 @@ public:
         return totalSent;
     }
 
+    size_t SendData(const SocketSendBuffer* buffers, size_t count) override
+    {
+        if (_status != SocketStatus::Connected)
+        {
+            throw std::runtime_error("Socket not connected.");
+        }
+
+        // Hand the buffers to the kernel in groups, skipping past whatever a partial write already covered
+        size_t totalSent = 0;
+        size_t index = 0;
+        size_t offset = 0;
+        while (index < count)
+        {
+            size_t groupSize = 0;
+            size_t groupBytes = 0;
+#    ifdef _WIN32
+            WSABUF group[MaxSendBuffersPerCall];
+            for (size_t i = index; i < count && groupSize < MaxSendBuffersPerCall; i++, groupSize++)
+            {
+                size_t skip = (i == index) ? offset : 0;
+                group[groupSize].buf = const_cast<char*>(static_cast<const char*>(buffers[i].Data) + skip);
+                group[groupSize].len = static_cast<ULONG>(buffers[i].Size - skip);
+                groupBytes += group[groupSize].len;
+            }
+
+            DWORD sentBytes = 0;
+            if (WSASend(_socket, group, static_cast<DWORD>(groupSize), &sentBytes, 0, nullptr, nullptr) == SOCKET_ERROR)
+            {
+                return totalSent;
+            }
+#    else
+            iovec group[MaxSendBuffersPerCall];
+            for (size_t i = index; i < count && groupSize < MaxSendBuffersPerCall; i++, groupSize++)
+            {
+                size_t skip = (i == index) ? offset : 0;
+                group[groupSize].iov_base = const_cast<char*>(static_cast<const char*>(buffers[i].Data) + skip);
+                group[groupSize].iov_len = buffers[i].Size - skip;
+                groupBytes += group[groupSize].iov_len;
+            }
+
+            msghdr message{};
+            message.msg_iov = group;
+            message.msg_iovlen = groupSize;
+            ssize_t sentBytes = sendmsg(_socket, &message, FLAG_NO_PIPE);
+            if (sentBytes == SOCKET_ERROR)
+            {
+                return totalSent;
+            }
+#    endif
+            totalSent += sentBytes;
+            if (static_cast<size_t>(sentBytes) < groupBytes)
+            {
+                // Partial write, advance to where it stopped and try again
+                size_t remaining = sentBytes + offset;
+                while (index < count && remaining >= buffers[index].Size)
+                {
+                    remaining -= buffers[index].Size;
+                    index++;
+                }
+                offset = remaining;
+            }
+            else
+            {
+                index += groupSize;
+                offset = 0;
+            }
+        }
+        return totalSent;
+    }
+
     NetworkReadPacket ReceiveData(void* buffer, size_t size, size_t* sizeReceived) override
     {
         if (_status != SocketStatus::Connected)
@@ -883,6 +966,106 @@ private:
     }
 };
 
+#    if defined(__linux__)
+/**
+ * Readiness is tracked by the kernel, waiting costs the same regardless of how many sockets are idle.
+ */
+class EpollSocketPoller final : public ISocketPoller
+{
+private:
+    static constexpr int32_t MaxEventsPerWait = 256;
+
+    int32_t _epoll = -1;
+
+public:
+    EpollSocketPoller()
+    {
+        _epoll = epoll_create1(EPOLL_CLOEXEC);
+        if (_epoll == -1)
+        {
+            throw std::runtime_error("Unable to create epoll instance.");
+        }
+    }
+
+    ~EpollSocketPoller() override
+    {
+        close(_epoll);
+    }
+
+    void Add(ITcpSocket* socket) override
+    {
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.ptr = socket;
+        if (epoll_ctl(_epoll, EPOLL_CTL_ADD, static_cast<TcpSocket*>(socket)->GetSocket(), &ev) == -1)
+        {
+            log_error("Unable to add socket to epoll: %d", LAST_SOCKET_ERROR());
+        }
+    }
+
+    void Remove(ITcpSocket* socket) override
+    {
+        // Closed sockets are dropped by the kernel already, so failure here is expected
+        epoll_ctl(_epoll, EPOLL_CTL_DEL, static_cast<TcpSocket*>(socket)->GetSocket(), nullptr);
+    }
+
+    void Wait(uint32_t timeoutMs, std::vector<ITcpSocket*>& ready) override
+    {
+        ready.clear();
+
+        epoll_event events[MaxEventsPerWait];
+        int32_t count = epoll_wait(_epoll, events, MaxEventsPerWait, static_cast<int32_t>(timeoutMs));
+        for (int32_t i = 0; i < count; i++)
+        {
+            ready.push_back(static_cast<ITcpSocket*>(events[i].data.ptr));
+        }
+    }
+};
+#    endif // defined(__linux__)
+
+/**
+ * Fallback for platforms without a readiness backend. Polling reports every socket as ready, while a timed wait only
+ * sleeps and reports nothing so the sockets are read at the next poll as before.
+ */
+class PollAllSocketPoller final : public ISocketPoller
+{
+private:
+    std::vector<ITcpSocket*> _sockets;
+
+public:
+    void Add(ITcpSocket* socket) override
+    {
+        _sockets.push_back(socket);
+    }
+
+    void Remove(ITcpSocket* socket) override
+    {
+        _sockets.erase(std::remove(_sockets.begin(), _sockets.end(), socket), _sockets.end());
+    }
+
+    void Wait(uint32_t timeoutMs, std::vector<ITcpSocket*>& ready) override
+    {
+        if (timeoutMs > 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+            ready.clear();
+        }
+        else
+        {
+            ready = _sockets;
+        }
+    }
+};
+
+std::unique_ptr<ISocketPoller> CreateSocketPoller()
+{
+#    if defined(__linux__)
+    return std::make_unique<EpollSocketPoller>();
+#    else
+    return std::make_unique<PollAllSocketPoller>();
+#    endif
+}
+
 std::unique_ptr<ITcpSocket> CreateTcpSocket()
 {
     InitialiseWSA();
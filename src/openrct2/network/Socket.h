@@ -33,6 +33,15 @@ enum class NetworkReadPacket : int32_t
     Disconnected
 };
 
+/**
+ * A region of memory to be sent as part of a gathered write.
+ */
+struct SocketSendBuffer
+{
+    const void* Data;
+    size_t Size;
+};
+
 /**
  * Represents an address and port.
  */
@@ -66,6 +75,7 @@ public:
     virtual void ConnectAsync(const std::string& address, uint16_t port) abstract;
 
     virtual size_t SendData(const void* buffer, size_t size) abstract;
+    virtual size_t SendData(const SocketSendBuffer* buffers, size_t count) abstract;
     virtual NetworkReadPacket ReceiveData(void* buffer, size_t size, size_t* sizeReceived) abstract;
 
     virtual void SetNoDelay(bool noDelay) abstract;
@@ -75,6 +85,25 @@ public:
     virtual void Close() abstract;
 };
 
+/**
+ * Waits for incoming data or connections on a set of TCP sockets, so only the sockets with pending input need to be
+ * read.
+ */
+struct ISocketPoller
+{
+public:
+    virtual ~ISocketPoller() = default;
+
+    virtual void Add(ITcpSocket* socket) abstract;
+    virtual void Remove(ITcpSocket* socket) abstract;
+
+    /**
+     * Waits at most timeoutMs milliseconds for any of the sockets to become readable and fills ready with those that
+     * are. Returns immediately when timeoutMs is 0.
+     */
+    virtual void Wait(uint32_t timeoutMs, std::vector<ITcpSocket*>& ready) abstract;
+};
+
 /**
  * Represents a UDP socket / listener.
  */
@@ -100,6 +129,7 @@ public:
 
 std::unique_ptr<ITcpSocket> CreateTcpSocket();
 std::unique_ptr<IUdpSocket> CreateUdpSocket();
+std::unique_ptr<ISocketPoller> CreateSocketPoller();
 std::vector<std::unique_ptr<INetworkEndpoint>> GetBroadcastAddresses();
 
 namespace Convert
@@ -51,9 +51,11 @@ int32_t network_get_status();
 bool network_is_desynchronised();
 bool network_check_desynchronisation();
 void network_request_gamestate_snapshot();
+bool network_is_resynchronising();
 void network_send_tick();
 bool network_gamestate_snapshots_enabled();
 void network_update();
+void network_wait(uint32_t timeoutMs);
 void network_process_pending();
 void network_flush();
 
@@ -12,10 +12,12 @@
 #include "../Context.h"
 #include "../OpenRCT2.h"
 #include "../PlatformEnvironment.h"
+#include "../config/Config.h"
 #include "../core/File.h"
 #include "../core/FileScanner.h"
 #include "../core/IStream.hpp"
 #include "../core/Json.hpp"
+#include "../core/Parallel.h"
 #include "../core/Path.hpp"
 #include "../core/String.hpp"
 #include "../drawing/ImageImporter.h"
@@ -35,6 +37,14 @@ struct ImageTable::RequiredImage
     rct_g1_element g1{};
     std::unique_ptr<RequiredImage> next_zoom;
 
+    // A PNG image that still has to be decoded, see DecodeImages
+    bool png_pending{};
+    std::string png_path;
+    std::vector<uint8_t> png_data;
+    int16_t png_x_offset{};
+    int16_t png_y_offset{};
+    ImageImporter::IMPORT_FLAGS png_import_flags{};
+
     bool HasData() const
     {
         return g1.offset != nullptr;
@@ -45,11 +55,17 @@ struct ImageTable::RequiredImage
 
     RequiredImage(const rct_g1_element& orig)
     {
-        auto length = g1_calculate_data_size(&orig);
-        g1 = orig;
-        g1.offset = new uint8_t[length];
-        std::memcpy(g1.offset, orig.offset, length);
-        g1.flags &= ~G1_FLAG_HAS_ZOOM_SPRITE;
+        SetImage(orig);
+    }
+
+    RequiredImage(std::string path, std::vector<uint8_t> data, int16_t x, int16_t y, ImageImporter::IMPORT_FLAGS flags)
+        : png_pending(true)
+        , png_path(std::move(path))
+        , png_data(std::move(data))
+        , png_x_offset(x)
+        , png_y_offset(y)
+        , png_import_flags(flags)
+    {
     }
 
     RequiredImage(uint32_t idx, std::function<const rct_g1_element*(uint32_t)> getter)
@@ -78,6 +94,16 @@ struct ImageTable::RequiredImage
     {
         delete[] g1.offset;
     }
+
+    void SetImage(const rct_g1_element& orig)
+    {
+        auto length = g1_calculate_data_size(&orig);
+        delete[] g1.offset;
+        g1 = orig;
+        g1.offset = new uint8_t[length];
+        std::memcpy(g1.offset, orig.offset, length);
+        g1.flags &= ~G1_FLAG_HAS_ZOOM_SPRITE;
+    }
 };
 
 std::vector<std::unique_ptr<ImageTable::RequiredImage>> ImageTable::ParseImages(IReadObjectContext* context, std::string s)
@@ -132,12 +158,7 @@ std::vector<std::unique_ptr<ImageTable::RequiredImage>> ImageTable::ParseImages(
         try
         {
             auto imageData = context->GetData(s);
-            auto image = Imaging::ReadFromBuffer(imageData, IMAGE_FORMAT::PNG_32);
-
-            ImageImporter importer;
-            auto importResult = importer.Import(image, 0, 0, ImageImporter::IMPORT_FLAGS::RLE);
-
-            result.push_back(std::make_unique<RequiredImage>(importResult.Element));
+            result.push_back(std::make_unique<RequiredImage>(s, std::move(imageData), 0, 0, ImageImporter::IMPORT_FLAGS::RLE));
         }
         catch (const std::exception& e)
         {
@@ -167,14 +188,7 @@ std::vector<std::unique_ptr<ImageTable::RequiredImage>> ImageTable::ParseImages(
             flags = static_cast<ImageImporter::IMPORT_FLAGS>(flags | ImageImporter::IMPORT_FLAGS::RLE);
         }
         auto imageData = context->GetData(path);
-        auto image = Imaging::ReadFromBuffer(imageData, IMAGE_FORMAT::PNG_32);
-
-        ImageImporter importer;
-        auto importResult = importer.Import(image, 0, 0, flags);
-        auto g1Element = importResult.Element;
-        g1Element.x_offset = x;
-        g1Element.y_offset = y;
-        result.push_back(std::make_unique<RequiredImage>(g1Element));
+        result.push_back(std::make_unique<RequiredImage>(path, std::move(imageData), x, y, flags));
     }
     catch (const std::exception& e)
     {
@@ -196,6 +210,20 @@ std::vector<std::unique_ptr<ImageTable::RequiredImage>> ImageTable::LoadObjectIm
         auto& imgTable = static_cast<const Object*>(obj.get())->GetImageTable();
         auto numImages = static_cast<int32_t>(imgTable.GetCount());
         auto images = imgTable.GetImages();
+
+        // The images are copied below, so read their data now if it is read on demand
+        std::vector<uint8_t> onDemandData;
+        std::vector<rct_g1_element> onDemandImages;
+        if (imgTable._dataLoader)
+        {
+            onDemandData = imgTable._dataLoader();
+            onDemandImages.assign(images, images + numImages);
+            for (auto& g1 : onDemandImages)
+            {
+                g1.offset = onDemandData.data() + reinterpret_cast<uintptr_t>(g1.offset);
+            }
+            images = onDemandImages.data();
+        }
         size_t placeHoldersAdded = 0;
         for (auto i : range)
         {
@@ -230,6 +258,48 @@ std::vector<std::unique_ptr<ImageTable::RequiredImage>> ImageTable::LoadObjectIm
     return result;
 }
 
+void ImageTable::DecodeImages(IReadObjectContext* context, std::vector<std::unique_ptr<RequiredImage>>& images)
+{
+    std::vector<RequiredImage*> pngImages;
+    for (auto& image : images)
+    {
+        if (image->png_pending)
+        {
+            pngImages.push_back(image.get());
+        }
+    }
+
+    // Decoding and converting to the palette is most of the time spent loading an object, the images do not depend on
+    // each other so they are spread over the worker threads. The context is not thread safe, so errors are logged after.
+    std::vector<std::string> errors(pngImages.size());
+    Parallel::For(pngImages.size(), [&pngImages, &errors](size_t i) {
+        auto& required = *pngImages[i];
+        try
+        {
+            auto image = Imaging::ReadFromBuffer(required.png_data, IMAGE_FORMAT::PNG_32);
+
+            ImageImporter importer;
+            auto importResult = importer.Import(
+                image, required.png_x_offset, required.png_y_offset, required.png_import_flags);
+            required.SetImage(importResult.Element);
+        }
+        catch (const std::exception& e)
+        {
+            errors[i] = String::StdFormat("Unable to load image '%s': %s", required.png_path.c_str(), e.what());
+        }
+        required.png_pending = false;
+        required.png_data = {};
+    });
+
+    for (const auto& error : errors)
+    {
+        if (!error.empty())
+        {
+            context->LogWarning(ObjectError::BadImageTable, error.c_str());
+        }
+    }
+}
+
 std::vector<int32_t> ImageTable::ParseRange(std::string s)
 {
     // Currently only supports [###] or [###..###]
@@ -290,7 +360,7 @@ std::string ImageTable::FindLegacyObject(const std::string& name)
 
 ImageTable::~ImageTable()
 {
-    if (_data == nullptr)
+    if (_data == nullptr && !_dataLoader)
     {
         for (auto& entry : _entries)
         {
@@ -320,22 +390,15 @@ void ImageTable::Read(IReadObjectContext* context, OpenRCT2::IStream* stream)
         }
 
         auto dataSize = static_cast<size_t>(imageDataSize);
-        auto data = std::make_unique<uint8_t[]>(dataSize);
-        if (data == nullptr)
-        {
-            context->LogError(ObjectError::BadImageTable, "Image table too large.");
-            throw std::runtime_error("Image table too large.");
-        }
 
-        // Read g1 element headers
-        uintptr_t imageDataBase = reinterpret_cast<uintptr_t>(data.get());
+        // Read g1 element headers, the offsets stay relative to the start of the data until it is read
         std::vector<rct_g1_element> newEntries;
         for (uint32_t i = 0; i < numImages; i++)
         {
             rct_g1_element g1Element;
 
             uintptr_t imageDataOffset = static_cast<uintptr_t>(stream->ReadValue<uint32_t>());
-            g1Element.offset = reinterpret_cast<uint8_t*>(imageDataBase + imageDataOffset);
+            g1Element.offset = reinterpret_cast<uint8_t*>(imageDataOffset);
 
             g1Element.width = stream->ReadValue<int16_t>();
             g1Element.height = stream->ReadValue<int16_t>();
@@ -347,6 +410,41 @@ void ImageTable::Read(IReadObjectContext* context, OpenRCT2::IStream* stream)
             newEntries.push_back(g1Element);
         }
 
+        auto legacyDataLoader = context->GetLegacyDataLoader();
+        if (legacyDataLoader && _entries.empty() && gConfigGeneral.load_object_images_on_demand)
+        {
+            // Only remember where the data is, it is read again once one of the images is drawn
+            auto dataOffset = static_cast<size_t>(stream->GetPosition());
+            auto legacyDataLength = static_cast<size_t>(stream->GetLength());
+            if (legacyDataLength - dataOffset < dataSize)
+            {
+                context->LogWarning(ObjectError::BadImageTable, "Image table size shorter than expected.");
+            }
+            _dataLoader = [legacyDataLoader, dataOffset, legacyDataLength, dataSize]() {
+                auto legacyData = legacyDataLoader();
+                if (legacyData.size() != legacyDataLength)
+                {
+                    throw std::runtime_error("Object file has changed since it was loaded.");
+                }
+                std::vector<uint8_t> data(dataSize);
+                std::copy_n(legacyData.begin() + dataOffset, std::min(dataSize, legacyDataLength - dataOffset), data.begin());
+                return data;
+            };
+            _entries = std::move(newEntries);
+            return;
+        }
+
+        auto data = std::make_unique<uint8_t[]>(dataSize);
+        if (data == nullptr)
+        {
+            context->LogError(ObjectError::BadImageTable, "Image table too large.");
+            throw std::runtime_error("Image table too large.");
+        }
+        for (auto& g1Element : newEntries)
+        {
+            g1Element.offset = data.get() + reinterpret_cast<uintptr_t>(g1Element.offset);
+        }
+
         // Read g1 element data
         size_t readBytes = static_cast<size_t>(stream->TryRead(data.get(), dataSize));
 
@@ -394,6 +492,7 @@ void ImageTable::ReadJson(IReadObjectContext* context, json_t& root)
                     allImages.end(), std::make_move_iterator(images.begin()), std::make_move_iterator(images.end()));
             }
         }
+        DecodeImages(context, allImages);
 
         // Now add all the images to the image table
         auto imagesStartIndex = GetCount();
@@ -432,6 +531,15 @@ void ImageTable::ReadJson(IReadObjectContext* context, json_t& root)
     }
 }
 
+uint32_t ImageTable::AllocateImages() const
+{
+    if (_dataLoader)
+    {
+        return gfx_object_allocate_images(_entries.data(), GetCount(), _dataLoader);
+    }
+    return gfx_object_allocate_images(_entries.data(), GetCount());
+}
+
 void ImageTable::AddImage(const rct_g1_element* g1)
 {
     rct_g1_element newg1 = *g1;
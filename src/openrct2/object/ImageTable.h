@@ -27,6 +27,8 @@ class ImageTable
 private:
     std::unique_ptr<uint8_t[]> _data;
     std::vector<rct_g1_element> _entries;
+    // Set when the image data is read on demand, the offsets of the entries are then relative to the data
+    ImageDataLoader _dataLoader;
 
     /**
      * Container for a G1 image, additional information and RAII. Used by ReadJson
@@ -39,6 +41,10 @@ private:
     static std::vector<std::unique_ptr<ImageTable::RequiredImage>> ParseImages(IReadObjectContext* context, json_t& el);
     static std::vector<std::unique_ptr<ImageTable::RequiredImage>> LoadObjectImages(
         IReadObjectContext* context, const std::string& name, const std::vector<int32_t>& range);
+    /**
+     * Decodes the PNG images read by ParseImages.
+     */
+    static void DecodeImages(IReadObjectContext* context, std::vector<std::unique_ptr<ImageTable::RequiredImage>>& images);
     static std::vector<int32_t> ParseRange(std::string s);
     static std::string FindLegacyObject(const std::string& name);
 
@@ -62,4 +68,8 @@ public:
         return static_cast<uint32_t>(_entries.size());
     }
     void AddImage(const rct_g1_element* g1);
+    /**
+     * Allocates the images for drawing, free them with gfx_object_free_images.
+     */
+    uint32_t AllocateImages() const;
 };
@@ -15,6 +15,7 @@
 #include "StringTable.h"
 
 #include <algorithm>
+#include <functional>
 #include <optional>
 #include <string_view>
 #include <vector>
@@ -162,6 +163,11 @@ struct IReadObjectContext
     virtual IObjectRepository& GetObjectRepository() abstract;
     virtual bool ShouldLoadImages() abstract;
     virtual std::vector<uint8_t> GetData(const std::string_view& path) abstract;
+    /**
+     * Gets a function that reads the legacy data of the object again, or an empty function if the data did not come from
+     * a file. Used to read images once they are drawn.
+     */
+    virtual std::function<std::vector<uint8_t>()> GetLegacyDataLoader() abstract;
 
     virtual void LogWarning(ObjectError code, const utf8* text) abstract;
     virtual void LogError(ObjectError code, const utf8* text) abstract;
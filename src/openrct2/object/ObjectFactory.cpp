@@ -89,6 +89,7 @@ private:
 
     std::string _identifier;
     bool _loadImages;
+    std::function<std::vector<uint8_t>()> _legacyDataLoader;
     std::string _basePath;
     bool _wasWarning = false;
     bool _wasError = false;
@@ -137,6 +138,16 @@ public:
         return {};
     }
 
+    std::function<std::vector<uint8_t>()> GetLegacyDataLoader() override
+    {
+        return _legacyDataLoader;
+    }
+
+    void SetLegacyDataLoader(std::function<std::vector<uint8_t>()> legacyDataLoader)
+    {
+        _legacyDataLoader = std::move(legacyDataLoader);
+    }
+
     void LogWarning(ObjectError code, const utf8* text) override
     {
         _wasWarning = true;
@@ -200,6 +211,19 @@ namespace ObjectFactory
         }
     }
 
+    /**
+     * Reads the decoded chunk of a legacy object file.
+     */
+    static std::vector<uint8_t> ReadLegacyData(const std::string& path)
+    {
+        auto fs = OpenRCT2::FileStream(path, OpenRCT2::FILE_MODE_OPEN);
+        auto chunkReader = SawyerChunkReader(&fs);
+        fs.ReadValue<rct_object_entry>();
+        auto chunk = chunkReader.ReadChunk();
+        auto data = static_cast<const uint8_t*>(chunk->GetData());
+        return std::vector<uint8_t>(data, data + chunk->GetLength());
+    }
+
     std::unique_ptr<Object> CreateObjectFromLegacyFile(IObjectRepository& objectRepository, const utf8* path)
     {
         log_verbose("CreateObjectFromLegacyFile(..., \"%s\")", path);
@@ -225,6 +249,7 @@ namespace ObjectFactory
 
                 auto chunkStream = OpenRCT2::MemoryStream(chunk->GetData(), chunk->GetLength());
                 auto readContext = ReadObjectContext(objectRepository, objectName, !gOpenRCT2NoGraphics, nullptr);
+                readContext.SetLegacyDataLoader([objectPath = std::string(path)]() { return ReadLegacyData(objectPath); });
                 ReadObjectLegacy(*result, &readContext, &chunkStream);
                 if (readContext.WasError())
                 {
@@ -0,0 +1,307 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "ObjectIndexTable.h"
+
+#include "../core/File.h"
+#include "../core/IStream.hpp"
+#include "../core/MemoryMappedFile.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace OpenRCT2;
+
+#pragma pack(push, 1)
+struct ObjectIndexTableHeader
+{
+    uint32_t Magic;
+    uint16_t Version;
+    uint64_t ScanChecksum;
+    uint32_t NumItems;
+    uint32_t NumHashSlots;
+    uint32_t StringPoolLength;
+    uint32_t ExtraLength;
+};
+assert_struct_size(ObjectIndexTableHeader, 30);
+
+struct ObjectIndexTableRecord
+{
+    rct_object_entry ObjectEntry;
+    uint32_t Path;  // Offset into the string pool
+    uint32_t Name;  // Offset into the string pool
+    uint32_t Extra; // Offset of the author string offsets, then the scenery group entries, then the sources
+    uint16_t NumSceneryGroupEntries;
+    uint8_t NumAuthors;
+    uint8_t NumSources;
+    uint8_t RideFlags;
+    uint8_t RideCategory[MAX_CATEGORIES_PER_RIDE];
+    uint8_t RideType[MAX_RIDE_TYPES_PER_RIDE_ENTRY];
+};
+#pragma pack(pop)
+
+static constexpr uint32_t MAGIC_NUMBER = 0x4D44494F; // OIDM
+static constexpr uint16_t VERSION = 1;
+
+static uint32_t GetNameHash(const rct_object_entry& entry)
+{
+    uint32_t hash = 5381;
+    for (auto i : entry.name)
+    {
+        hash = ((hash << 5) + hash) + i;
+    }
+    return hash;
+}
+
+static size_t GetExtraLength(const ObjectIndexTableRecord& record)
+{
+    return record.NumAuthors * sizeof(uint32_t) + record.NumSceneryGroupEntries * sizeof(rct_object_entry)
+        + record.NumSources;
+}
+
+template<typename T> static void Append(std::vector<uint8_t>& buffer, const T* data, size_t count)
+{
+    auto bytes = reinterpret_cast<const uint8_t*>(data);
+    buffer.insert(buffer.end(), bytes, bytes + count * sizeof(T));
+}
+
+void ObjectIndexTable::Write(const std::string& path, uint64_t scanChecksum, const std::deque<ObjectRepositoryItem>& items)
+{
+    std::vector<ObjectIndexTableRecord> records(items.size());
+    std::vector<char> strings;
+    std::vector<uint8_t> extra;
+    auto addString = [&strings](const std::string& value) {
+        auto offset = static_cast<uint32_t>(strings.size());
+        strings.insert(strings.end(), value.begin(), value.end());
+        strings.push_back('\0');
+        return offset;
+    };
+
+    for (size_t i = 0; i < items.size(); i++)
+    {
+        const auto& item = items[i];
+        auto& record = records[i];
+        record = {};
+        record.ObjectEntry = item.ObjectEntry;
+        record.Path = addString(item.Path);
+        record.Name = addString(item.Name);
+        record.Extra = static_cast<uint32_t>(extra.size());
+        record.NumAuthors = static_cast<uint8_t>(std::min<size_t>(item.Authors.size(), UINT8_MAX));
+        record.NumSources = static_cast<uint8_t>(std::min<size_t>(item.Sources.size(), UINT8_MAX));
+        for (size_t j = 0; j < record.NumAuthors; j++)
+        {
+            auto offset = addString(item.Authors[j]);
+            Append(extra, &offset, 1);
+        }
+        switch (item.ObjectEntry.GetType())
+        {
+            case OBJECT_TYPE_RIDE:
+                record.RideFlags = item.RideInfo.RideFlags;
+                std::memcpy(record.RideCategory, item.RideInfo.RideCategory, sizeof(record.RideCategory));
+                std::memcpy(record.RideType, item.RideInfo.RideType, sizeof(record.RideType));
+                break;
+            case OBJECT_TYPE_SCENERY_GROUP:
+                record.NumSceneryGroupEntries = static_cast<uint16_t>(
+                    std::min<size_t>(item.SceneryGroupInfo.Entries.size(), UINT16_MAX));
+                Append(extra, item.SceneryGroupInfo.Entries.data(), record.NumSceneryGroupEntries);
+                break;
+        }
+        Append(extra, item.Sources.data(), record.NumSources);
+    }
+
+    // Open addressing with linear probing, at most half of the slots are used
+    uint32_t numHashSlots = 16;
+    while (numHashSlots < items.size() * 2)
+    {
+        numHashSlots *= 2;
+    }
+    std::vector<uint32_t> hashSlots(numHashSlots);
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        auto slot = GetNameHash(records[i].ObjectEntry) & (numHashSlots - 1);
+        while (hashSlots[slot] != 0)
+        {
+            slot = (slot + 1) & (numHashSlots - 1);
+        }
+        hashSlots[slot] = static_cast<uint32_t>(i + 1);
+    }
+
+    ObjectIndexTableHeader header{};
+    header.Magic = MAGIC_NUMBER;
+    header.Version = VERSION;
+    header.ScanChecksum = scanChecksum;
+    header.NumItems = static_cast<uint32_t>(records.size());
+    header.NumHashSlots = numHashSlots;
+    header.StringPoolLength = static_cast<uint32_t>(strings.size());
+    header.ExtraLength = static_cast<uint32_t>(extra.size());
+
+    std::vector<uint8_t> buffer;
+    Append(buffer, &header, 1);
+    Append(buffer, records.data(), records.size());
+    Append(buffer, hashSlots.data(), hashSlots.size());
+    Append(buffer, strings.data(), strings.size());
+    Append(buffer, extra.data(), extra.size());
+
+    // Other instances may have the old table mapped, so it is replaced rather than written over
+    auto tempPath = File::GetTemporaryPath(path);
+    try
+    {
+        File::WriteAllBytes(tempPath, buffer.data(), buffer.size());
+    }
+    catch (const std::exception&)
+    {
+        File::Delete(tempPath);
+        throw;
+    }
+    if (!File::Replace(tempPath, path))
+    {
+        File::Delete(tempPath);
+        throw IOException("Unable to replace " + path);
+    }
+}
+
+std::unique_ptr<ObjectIndexTable> ObjectIndexTable::Open(const std::string& path, uint64_t scanChecksum)
+{
+    if (!File::Exists(path))
+    {
+        return nullptr;
+    }
+
+    auto table = std::make_unique<ObjectIndexTable>(std::make_unique<MemoryMappedFile>(path));
+    if (!table->Validate(scanChecksum))
+    {
+        return nullptr;
+    }
+    return table;
+}
+
+ObjectIndexTable::ObjectIndexTable(std::unique_ptr<MemoryMappedFile> file)
+    : _file(std::move(file))
+{
+}
+
+ObjectIndexTable::~ObjectIndexTable() = default;
+
+bool ObjectIndexTable::Validate(uint64_t scanChecksum)
+{
+    const uint8_t* data = _file->GetData();
+    size_t length = _file->GetLength();
+    if (length < sizeof(ObjectIndexTableHeader))
+    {
+        return false;
+    }
+
+    ObjectIndexTableHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.Magic != MAGIC_NUMBER || header.Version != VERSION || header.ScanChecksum != scanChecksum)
+    {
+        return false;
+    }
+    if (header.NumHashSlots < header.NumItems * 2ULL || (header.NumHashSlots & (header.NumHashSlots - 1)) != 0)
+    {
+        return false;
+    }
+    uint64_t expectedLength = sizeof(ObjectIndexTableHeader) + header.NumItems * uint64_t{ sizeof(ObjectIndexTableRecord) }
+        + header.NumHashSlots * uint64_t{ sizeof(uint32_t) } + header.StringPoolLength + header.ExtraLength;
+    if (expectedLength != length)
+    {
+        return false;
+    }
+    // Strings are read up to their terminator, so the pool has to end with one. A table without items has no strings.
+    if (header.StringPoolLength == 0 ? header.NumItems != 0 : data[length - header.ExtraLength - 1] != '\0')
+    {
+        return false;
+    }
+
+    _records = reinterpret_cast<const ObjectIndexTableRecord*>(data + sizeof(ObjectIndexTableHeader));
+    _hashSlots = reinterpret_cast<const uint32_t*>(_records + header.NumItems);
+    _numItems = header.NumItems;
+    _numHashSlots = header.NumHashSlots;
+    _strings = reinterpret_cast<const char*>(_hashSlots + header.NumHashSlots);
+    _extra = reinterpret_cast<const uint8_t*>(_strings + header.StringPoolLength);
+
+    // Check every offset once here, so that reading items later can not go past the end of the file
+    for (uint32_t i = 0; i < _numItems; i++)
+    {
+        const auto& record = _records[i];
+        if (record.Path >= header.StringPoolLength || record.Name >= header.StringPoolLength
+            || record.Extra + uint64_t{ GetExtraLength(record) } > header.ExtraLength)
+        {
+            return false;
+        }
+        for (size_t j = 0; j < record.NumAuthors; j++)
+        {
+            uint32_t offset;
+            std::memcpy(&offset, _extra + record.Extra + j * sizeof(uint32_t), sizeof(offset));
+            if (offset >= header.StringPoolLength)
+            {
+                return false;
+            }
+        }
+    }
+    for (uint32_t i = 0; i < _numHashSlots; i++)
+    {
+        uint32_t index;
+        std::memcpy(&index, &_hashSlots[i], sizeof(index));
+        if (index > _numItems)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::optional<size_t> ObjectIndexTable::Find(const rct_object_entry& entry) const
+{
+    auto slot = GetNameHash(entry) & (_numHashSlots - 1);
+    for (uint32_t probes = 0; probes < _numHashSlots; probes++)
+    {
+        uint32_t index;
+        std::memcpy(&index, &_hashSlots[slot], sizeof(index));
+        if (index == 0)
+        {
+            break;
+        }
+        if (std::memcmp(_records[index - 1].ObjectEntry.name, entry.name, sizeof(entry.name)) == 0)
+        {
+            return index - 1;
+        }
+        slot = (slot + 1) & (_numHashSlots - 1);
+    }
+    return std::nullopt;
+}
+
+void ObjectIndexTable::ReadItem(size_t index, ObjectRepositoryItem& item) const
+{
+    const auto& record = _records[index];
+    item.ObjectEntry = record.ObjectEntry;
+    item.Path = _strings + record.Path;
+    item.Name = _strings + record.Name;
+
+    const uint8_t* extra = _extra + record.Extra;
+    item.Authors.clear();
+    for (size_t i = 0; i < record.NumAuthors; i++)
+    {
+        uint32_t offset;
+        std::memcpy(&offset, extra, sizeof(offset));
+        item.Authors.emplace_back(_strings + offset);
+        extra += sizeof(offset);
+    }
+
+    item.SceneryGroupInfo.Entries.resize(record.NumSceneryGroupEntries);
+    std::memcpy(item.SceneryGroupInfo.Entries.data(), extra, record.NumSceneryGroupEntries * sizeof(rct_object_entry));
+    extra += record.NumSceneryGroupEntries * sizeof(rct_object_entry);
+
+    item.Sources.resize(record.NumSources);
+    std::memcpy(item.Sources.data(), extra, record.NumSources);
+
+    item.RideInfo.RideFlags = record.RideFlags;
+    std::memcpy(item.RideInfo.RideCategory, record.RideCategory, sizeof(record.RideCategory));
+    std::memcpy(item.RideInfo.RideType, record.RideType, sizeof(record.RideType));
+}
@@ -0,0 +1,77 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "ObjectRepository.h"
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace OpenRCT2
+{
+    class MemoryMappedFile;
+}
+
+struct ObjectIndexTableHeader;
+struct ObjectIndexTableRecord;
+
+/**
+ * A memory mapped copy of the object repository's items, so that startup does not have to read every item of the
+ * object index. Items are stored as fixed size records with their strings in a pool, and are found through a hash table
+ * on their name. Nothing is read from a record until the item is asked for.
+ */
+class ObjectIndexTable final
+{
+private:
+    std::unique_ptr<OpenRCT2::MemoryMappedFile> _file;
+    const ObjectIndexTableRecord* _records{};
+    const uint32_t* _hashSlots{};
+    uint32_t _numItems{};
+    uint32_t _numHashSlots{};
+    const char* _strings{};
+    const uint8_t* _extra{};
+
+public:
+    /**
+     * Writes the items to path in the order they are given.
+     * @param scanChecksum Identifies the object files the items were read from, see FileIndex::GetScanChecksum.
+     */
+    static void Write(const std::string& path, uint64_t scanChecksum, const std::deque<ObjectRepositoryItem>& items);
+
+    /**
+     * Maps the table at path. Returns nullptr if there is no table, or it was written for other object files.
+     */
+    static std::unique_ptr<ObjectIndexTable> Open(const std::string& path, uint64_t scanChecksum);
+
+    explicit ObjectIndexTable(std::unique_ptr<OpenRCT2::MemoryMappedFile> file);
+    ~ObjectIndexTable();
+
+    size_t GetNumItems() const
+    {
+        return _numItems;
+    }
+
+    /**
+     * Finds the item with the same name as entry.
+     */
+    std::optional<size_t> Find(const rct_object_entry& entry) const;
+
+    /**
+     * Reads an item from its record, Id and LoadedObject are left as they are.
+     */
+    void ReadItem(size_t index, ObjectRepositoryItem& item) const;
+
+private:
+    bool Validate(uint64_t scanChecksum);
+};
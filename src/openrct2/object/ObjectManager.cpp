@@ -13,6 +13,7 @@
 #include "../ParkImporter.h"
 #include "../core/Console.hpp"
 #include "../core/Memory.hpp"
+#include "../core/Parallel.h"
 #include "../localisation/StringIds.h"
 #include "FootpathItemObject.h"
 #include "LargeSceneryObject.h"
@@ -28,7 +29,6 @@
 #include <array>
 #include <memory>
 #include <mutex>
-#include <thread>
 #include <unordered_set>
 
 class ObjectManager final : public IObjectManager
@@ -202,13 +202,16 @@ public:
 
     std::vector<const ObjectRepositoryItem*> GetPackableObjects() override
     {
+        // Only look up the loaded objects, so the repository does not have to read every item
         std::vector<const ObjectRepositoryItem*> objects;
-        size_t numObjects = _objectRepository.GetNumObjects();
-        for (size_t i = 0; i < numObjects; i++)
+        for (const auto& loadedObject : _loadedObjects)
         {
-            const ObjectRepositoryItem* item = &_objectRepository.GetObjects()[i];
-            if (item->LoadedObject != nullptr && IsObjectCustom(item) && item->LoadedObject->GetLegacyData() != nullptr
-                && !item->LoadedObject->IsJsonObject())
+            if (loadedObject == nullptr)
+                continue;
+
+            const ObjectRepositoryItem* item = _objectRepository.FindObject(loadedObject->GetObjectEntry());
+            if (item != nullptr && item->LoadedObject == loadedObject.get() && IsObjectCustom(item)
+                && loadedObject->GetLegacyData() != nullptr && !loadedObject->IsJsonObject())
             {
                 objects.push_back(item);
             }
@@ -552,30 +555,6 @@ private:
         return requiredObjects;
     }
 
-    template<typename T, typename TFunc> static void ParallelFor(const std::vector<T>& items, TFunc func)
-    {
-        auto partitions = std::thread::hardware_concurrency();
-        auto partitionSize = (items.size() + (partitions - 1)) / partitions;
-        std::vector<std::thread> threads;
-        for (size_t n = 0; n < partitions; n++)
-        {
-            auto begin = n * partitionSize;
-            auto end = std::min(items.size(), begin + partitionSize);
-            threads.emplace_back(
-                [func](size_t pbegin, size_t pend) {
-                    for (size_t i = pbegin; i < pend; i++)
-                    {
-                        func(i);
-                    }
-                },
-                begin, end);
-        }
-        for (auto& t : threads)
-        {
-            t.join();
-        }
-    }
-
     std::vector<std::unique_ptr<Object>> LoadObjects(
         std::vector<const ObjectRepositoryItem*>& requiredObjects, size_t* outNewObjectsLoaded)
     {
@@ -587,7 +566,7 @@ private:
 
         // Read objects
         std::mutex commonMutex;
-        ParallelFor(requiredObjects, [this, &commonMutex, requiredObjects, &objects, &badObjects, &loadedObjects](size_t i) {
+        Parallel::For(requiredObjects.size(), [&](size_t i) {
             auto requiredObject = requiredObjects[i];
             std::unique_ptr<Object> object;
             if (requiredObject != nullptr)
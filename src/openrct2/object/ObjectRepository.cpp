@@ -33,12 +33,16 @@
 #include "../util/Util.h"
 #include "Object.h"
 #include "ObjectFactory.h"
+#include "ObjectIndexTable.h"
 #include "ObjectList.h"
 #include "ObjectManager.h"
 #include "RideObject.h"
 
 #include <algorithm>
+#include <chrono>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -226,9 +230,15 @@ class ObjectRepository final : public IObjectRepository
 {
     std::shared_ptr<IPlatformEnvironment> const _env;
     ObjectFileIndex const _fileIndex;
-    std::vector<ObjectRepositoryItem> _items;
+    // A deque, so that items that are added later do not move the ones callers already hold
+    mutable std::deque<ObjectRepositoryItem> _items;
     ObjectEntryMap _itemMap;
 
+    // Items in the table are only read once they are asked for
+    std::unique_ptr<ObjectIndexTable> _table;
+    mutable std::vector<bool> _itemsRead;
+    mutable std::mutex _itemsMutex;
+
 public:
     explicit ObjectRepository(const std::shared_ptr<IPlatformEnvironment>& env)
         : _env(env)
@@ -243,17 +253,34 @@ public:
 
     void LoadOrConstruct(int32_t language) override
     {
+        auto startTime = std::chrono::high_resolution_clock::now();
         ClearItems();
-        auto items = _fileIndex.LoadOrBuild(language);
-        AddItems(items);
-        SortItems();
+
+        auto scanResult = _fileIndex.Scan();
+        auto scanChecksum = _fileIndex.GetScanChecksum(language, scanResult);
+        if (!OpenTable(scanChecksum))
+        {
+            auto items = _fileIndex.LoadOrBuild(language, scanResult);
+            AddItems(items);
+            SortItems();
+            WriteTable(scanChecksum);
+        }
+
+        std::chrono::duration<float> duration = std::chrono::high_resolution_clock::now() - startTime;
+        log_verbose(
+            "Object repository ready with %zu objects in %.2f seconds (%s)", _items.size(), duration.count(),
+            _table != nullptr ? "mapped" : "read");
     }
 
     void Construct(int32_t language) override
     {
-        auto items = _fileIndex.Rebuild(language);
+        // Items that are already in the repository stay, only the table is replaced
+        CloseTable();
+        auto scanResult = _fileIndex.Scan();
+        auto items = _fileIndex.Rebuild(language, scanResult);
         AddItems(items);
         SortItems();
+        WriteTable(_fileIndex.GetScanChecksum(language, scanResult));
     }
 
     size_t GetNumObjects() const override
@@ -261,26 +288,36 @@ public:
         return _items.size();
     }
 
-    const ObjectRepositoryItem* GetObjects() const override
+    const std::deque<ObjectRepositoryItem>& GetObjects() const override
     {
-        return _items.data();
+        if (_table != nullptr)
+        {
+            for (size_t i = 0; i < _table->GetNumItems(); i++)
+            {
+                GetItem(i);
+            }
+        }
+        return _items;
     }
 
     const ObjectRepositoryItem* FindObject(const std::string_view& legacyIdentifier) const override
     {
         rct_object_entry entry = {};
         entry.SetName(legacyIdentifier);
-
-        auto kvp = _itemMap.find(entry);
-        if (kvp != _itemMap.end())
-        {
-            return &_items[kvp->second];
-        }
-        return nullptr;
+        return FindObject(&entry);
     }
 
     const ObjectRepositoryItem* FindObject(const rct_object_entry* objectEntry) const override final
     {
+        if (_table != nullptr)
+        {
+            auto index = _table->Find(*objectEntry);
+            if (index)
+            {
+                return GetItem(*index);
+            }
+        }
+
         auto kvp = _itemMap.find(*objectEntry);
         if (kvp != _itemMap.end())
         {
@@ -409,6 +446,75 @@ private:
     {
         _items.clear();
         _itemMap.clear();
+        _table = nullptr;
+        _itemsRead.clear();
+    }
+
+    bool OpenTable(uint64_t scanChecksum)
+    {
+        try
+        {
+            _table = ObjectIndexTable::Open(_env->GetFilePath(PATHID::CACHE_OBJECTS_TABLE), scanChecksum);
+        }
+        catch (const std::exception& e)
+        {
+            log_warning("Unable to open object table: %s", e.what());
+            _table = nullptr;
+        }
+        if (_table == nullptr)
+        {
+            return false;
+        }
+
+        // The table is written after the items are sorted, so the index of each item is its ID
+        auto numItems = _table->GetNumItems();
+        _items.resize(numItems);
+        _itemsRead.assign(numItems, false);
+        for (size_t i = 0; i < numItems; i++)
+        {
+            _items[i].Id = i;
+        }
+        return true;
+    }
+
+    /**
+     * Reads every item that is still in the table, so the items can be found without it.
+     */
+    void CloseTable()
+    {
+        if (_table != nullptr)
+        {
+            for (size_t i = 0; i < _table->GetNumItems(); i++)
+            {
+                _itemMap[GetItem(i)->ObjectEntry] = i;
+            }
+            _table = nullptr;
+            _itemsRead.clear();
+        }
+    }
+
+    void WriteTable(uint64_t scanChecksum) const
+    {
+        try
+        {
+            ObjectIndexTable::Write(_env->GetFilePath(PATHID::CACHE_OBJECTS_TABLE), scanChecksum, _items);
+        }
+        catch (const std::exception& e)
+        {
+            log_warning("Unable to write object table: %s", e.what());
+        }
+    }
+
+    const ObjectRepositoryItem* GetItem(size_t index) const
+    {
+        std::lock_guard<std::mutex> guard(_itemsMutex);
+        auto& item = _items[index];
+        if (!_itemsRead[index])
+        {
+            _table->ReadItem(index, item);
+            _itemsRead[index] = true;
+        }
+        return &item;
     }
 
     void SortItems()
@@ -453,6 +559,7 @@ private:
         auto conflict = FindObject(&item.ObjectEntry);
         if (conflict == nullptr)
         {
+            std::lock_guard<std::mutex> guard(_itemsMutex);
             size_t index = _items.size();
             auto copy = item;
             copy.Id = index;
@@ -731,7 +838,7 @@ size_t object_repository_get_items_count()
     return objectRepository.GetNumObjects();
 }
 
-const ObjectRepositoryItem* object_repository_get_items()
+const std::deque<ObjectRepositoryItem>& object_repository_get_items()
 {
     auto& objectRepository = GetContext()->GetObjectRepository();
     return objectRepository.GetObjects();
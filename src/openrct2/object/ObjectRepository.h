@@ -13,6 +13,7 @@
 #include "../object/Object.h"
 #include "../ride/Ride.h"
 
+#include <deque>
 #include <memory>
 #include <vector>
 
@@ -70,7 +71,7 @@ struct IObjectRepository
     virtual void LoadOrConstruct(int32_t language) abstract;
     virtual void Construct(int32_t language) abstract;
     virtual size_t GetNumObjects() const abstract;
-    virtual const ObjectRepositoryItem* GetObjects() const abstract;
+    virtual const std::deque<ObjectRepositoryItem>& GetObjects() const abstract;
     virtual const ObjectRepositoryItem* FindObject(const std::string_view& legacyIdentifier) const abstract;
     virtual const ObjectRepositoryItem* FindObject(const rct_object_entry* objectEntry) const abstract;
 
@@ -90,7 +91,7 @@ std::unique_ptr<IObjectRepository> CreateObjectRepository(const std::shared_ptr<
 bool IsObjectCustom(const ObjectRepositoryItem* object);
 
 size_t object_repository_get_items_count();
-const ObjectRepositoryItem* object_repository_get_items();
+const std::deque<ObjectRepositoryItem>& object_repository_get_items();
 const ObjectRepositoryItem* object_repository_find_object_by_entry(const rct_object_entry* entry);
 const ObjectRepositoryItem* object_repository_find_object_by_name(const char* name);
 std::unique_ptr<Object> object_repository_load_object(const rct_object_entry* objectEntry);
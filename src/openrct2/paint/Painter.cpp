@@ -36,6 +36,9 @@ Painter::Painter(const std::shared_ptr<IUiContext>& uiContext)
 
 void Painter::Paint(IDrawingEngine& de)
 {
+    // Nothing is being drawn yet, so the data of object images can be added and dropped safely
+    gfx_lazy_images_update();
+
     auto dpi = de.GetDrawingPixelInfo();
     if (gIntroState != IntroState::None)
     {
@@ -144,20 +147,24 @@ paint_session* Painter::CreateSession(rct_drawpixelinfo* dpi, uint32_t viewFlags
 {
     paint_session* session = nullptr;
 
-    if (_freePaintSessions.empty() == false)
     {
-        // Re-use.
-        const size_t idx = _freePaintSessions.size() - 1;
-        session = _freePaintSessions[idx];
+        // Sessions are allocated from several threads when the dirty regions are drawn in parallel
+        std::lock_guard<std::mutex> lock(_paintSessionMutex);
+        if (_freePaintSessions.empty() == false)
+        {
+            // Re-use.
+            const size_t idx = _freePaintSessions.size() - 1;
+            session = _freePaintSessions[idx];
 
-        // Shrink by one.
-        _freePaintSessions.pop_back();
-    }
-    else
-    {
-        // Create new one in pool.
-        _paintSessionPool.emplace_back(std::make_unique<paint_session>());
-        session = _paintSessionPool.back().get();
+            // Shrink by one.
+            _freePaintSessions.pop_back();
+        }
+        else
+        {
+            // Create new one in pool.
+            _paintSessionPool.emplace_back(std::make_unique<paint_session>());
+            session = _paintSessionPool.back().get();
+        }
     }
 
     session->DPI = *dpi;
@@ -183,5 +190,6 @@ paint_session* Painter::CreateSession(rct_drawpixelinfo* dpi, uint32_t viewFlags
 
 void Painter::ReleaseSession(paint_session* session)
 {
+    std::lock_guard<std::mutex> lock(_paintSessionMutex);
     _freePaintSessions.push_back(session);
 }
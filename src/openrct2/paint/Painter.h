@@ -14,6 +14,7 @@
 
 #include <ctime>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 struct rct_drawpixelinfo;
@@ -38,6 +39,7 @@ namespace OpenRCT2
             std::shared_ptr<Ui::IUiContext> const _uiContext;
             std::vector<std::unique_ptr<paint_session>> _paintSessionPool;
             std::vector<paint_session*> _freePaintSessions;
+            std::mutex _paintSessionMutex;
             time_t _lastSecond = 0;
             int32_t _currentFPS = 0;
             int32_t _frames = 0;
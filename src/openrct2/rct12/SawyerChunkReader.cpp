@@ -10,6 +10,7 @@
 #include "SawyerChunkReader.h"
 
 #include "../core/IStream.hpp"
+#include "../core/Parallel.h"
 
 // malloc is very slow for large allocations in MSVC debug builds as it allocates
 // memory on a special debug heap and then initialises all the memory to 0xCC.
@@ -21,6 +22,9 @@
 // Allow chunks to be uncompressed to a maximum of 16 MiB
 constexpr size_t MAX_UNCOMPRESSED_CHUNK_SIZE = 16 * 1024 * 1024;
 
+// Smaller chunks are decoded faster than they are handed to a worker thread
+constexpr size_t ASYNC_DECODE_MIN_CHUNK_SIZE = 64 * 1024;
+
 constexpr const char* EXCEPTION_MSG_CORRUPT_CHUNK_SIZE = "Corrupt chunk size.";
 constexpr const char* EXCEPTION_MSG_CORRUPT_RLE = "Corrupt RLE compression data.";
 constexpr const char* EXCEPTION_MSG_DESTINATION_TOO_SMALL = "Chunk data larger than allocated destination capacity.";
@@ -66,35 +70,16 @@ std::shared_ptr<SawyerChunk> SawyerChunkReader::ReadChunk()
     uint64_t originalPosition = _stream->GetPosition();
     try
     {
-        auto header = _stream->ReadValue<sawyercoding_chunk_header>();
-        if (header.length >= MAX_UNCOMPRESSED_CHUNK_SIZE)
-            throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_CHUNK_SIZE);
-
-        switch (header.encoding)
+        auto chunk = ReadEncodedChunk();
+        auto buffer = static_cast<uint8_t*>(AllocateLargeTempBuffer());
+        size_t uncompressedLength = DecodeChunk(buffer, MAX_UNCOMPRESSED_CHUNK_SIZE, chunk.Data.get(), chunk.Header);
+        if (uncompressedLength == 0)
         {
-            case CHUNK_ENCODING_NONE:
-            case CHUNK_ENCODING_RLE:
-            case CHUNK_ENCODING_RLECOMPRESSED:
-            case CHUNK_ENCODING_ROTATE:
-            {
-                std::unique_ptr<uint8_t[]> compressedData(new uint8_t[header.length]);
-                if (_stream->TryRead(compressedData.get(), header.length) != header.length)
-                {
-                    throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_CHUNK_SIZE);
-                }
-
-                auto buffer = static_cast<uint8_t*>(AllocateLargeTempBuffer());
-                size_t uncompressedLength = DecodeChunk(buffer, MAX_UNCOMPRESSED_CHUNK_SIZE, compressedData.get(), header);
-                if (uncompressedLength == 0)
-                {
-                    throw SawyerChunkException(EXCEPTION_MSG_ZERO_SIZED_CHUNK);
-                }
-                buffer = static_cast<uint8_t*>(FinaliseLargeTempBuffer(buffer, uncompressedLength));
-                return std::make_shared<SawyerChunk>(static_cast<SAWYER_ENCODING>(header.encoding), buffer, uncompressedLength);
-            }
-            default:
-                throw SawyerChunkException(EXCEPTION_MSG_INVALID_CHUNK_ENCODING);
+            FreeLargeTempBuffer(buffer);
+            throw SawyerChunkException(EXCEPTION_MSG_ZERO_SIZED_CHUNK);
         }
+        buffer = static_cast<uint8_t*>(FinaliseLargeTempBuffer(buffer, uncompressedLength));
+        return std::make_shared<SawyerChunk>(static_cast<SAWYER_ENCODING>(chunk.Header.encoding), buffer, uncompressedLength);
     }
     catch (const std::exception&)
     {
@@ -143,23 +128,184 @@ std::shared_ptr<SawyerChunk> SawyerChunkReader::ReadChunkTrack()
 
 void SawyerChunkReader::ReadChunk(void* dst, size_t length)
 {
-    auto chunk = ReadChunk();
-    auto chunkData = static_cast<const uint8_t*>(chunk->GetData());
-    auto chunkLength = chunk->GetLength();
-    if (chunkLength > length)
+    uint64_t originalPosition = _stream->GetPosition();
+    try
+    {
+        auto chunk = ReadEncodedChunk();
+        DecodeChunkTo(dst, length, chunk);
+    }
+    catch (const std::exception&)
+    {
+        // Rewind stream back to original position
+        _stream->SetPosition(originalPosition);
+        throw;
+    }
+}
+
+std::future<void> SawyerChunkReader::ReadChunksAsync(const std::vector<SawyerChunkDestination>& destinations)
+{
+    // The encoded data is read on this thread, only decoding is left to the background
+    auto chunks = std::make_shared<std::vector<EncodedChunk>>();
+    uint64_t originalPosition = _stream->GetPosition();
+    try
+    {
+        for (size_t i = 0; i < destinations.size(); i++)
+        {
+            chunks->push_back(ReadEncodedChunk());
+        }
+    }
+    catch (const std::exception&)
+    {
+        // Rewind stream back to original position
+        _stream->SetPosition(originalPosition);
+        throw;
+    }
+
+    return std::async(std::launch::async, [chunks, destinations]() {
+        // Chunks are independent of each other, so the large ones are spread over the shared worker threads
+        std::vector<size_t> largeChunks;
+        for (size_t i = 0; i < chunks->size(); i++)
+        {
+            if ((*chunks)[i].Header.length >= ASYNC_DECODE_MIN_CHUNK_SIZE)
+            {
+                largeChunks.push_back(i);
+            }
+            else
+            {
+                DecodeChunkTo(destinations[i].Data, destinations[i].Length, (*chunks)[i]);
+            }
+        }
+        Parallel::For(largeChunks.size(), [&chunks, &destinations, &largeChunks](size_t i) {
+            auto index = largeChunks[i];
+            DecodeChunkTo(destinations[index].Data, destinations[index].Length, (*chunks)[index]);
+        });
+    });
+}
+
+SawyerChunkReader::EncodedChunk SawyerChunkReader::ReadEncodedChunk()
+{
+    EncodedChunk chunk;
+    chunk.Header = _stream->ReadValue<sawyercoding_chunk_header>();
+    if (chunk.Header.length >= MAX_UNCOMPRESSED_CHUNK_SIZE)
+        throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_CHUNK_SIZE);
+
+    switch (chunk.Header.encoding)
+    {
+        case CHUNK_ENCODING_NONE:
+        case CHUNK_ENCODING_RLE:
+        case CHUNK_ENCODING_RLECOMPRESSED:
+        case CHUNK_ENCODING_ROTATE:
+            chunk.Data = std::make_unique<uint8_t[]>(chunk.Header.length);
+            if (_stream->TryRead(chunk.Data.get(), chunk.Header.length) != chunk.Header.length)
+            {
+                throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_CHUNK_SIZE);
+            }
+            return chunk;
+        default:
+            throw SawyerChunkException(EXCEPTION_MSG_INVALID_CHUNK_ENCODING);
+    }
+}
+
+void SawyerChunkReader::DecodeChunkTo(void* dst, size_t length, const EncodedChunk& chunk)
+{
+    const auto& header = chunk.Header;
+    const auto* src = chunk.Data.get();
+
+    // Every buffer is sized from the encoded data, rather than allocating the largest size a chunk can decode to
+    std::vector<uint8_t> rleData;
+    size_t decodedLength;
+    switch (header.encoding)
     {
-        std::memcpy(dst, chunkData, length);
+        case CHUNK_ENCODING_NONE:
+        case CHUNK_ENCODING_ROTATE:
+            decodedLength = header.length;
+            break;
+        case CHUNK_ENCODING_RLE:
+            decodedLength = GetDecodedLengthRLE(src, header.length);
+            break;
+        case CHUNK_ENCODING_RLECOMPRESSED:
+            rleData.resize(GetDecodedLengthRLE(src, header.length));
+            DecodeChunkRLE(rleData.data(), rleData.size(), src, header.length);
+            decodedLength = GetDecodedLengthRepeat(rleData.data(), rleData.size());
+            break;
+        default:
+            throw SawyerChunkException(EXCEPTION_MSG_INVALID_CHUNK_ENCODING);
+    }
+    if (decodedLength == 0)
+    {
+        throw SawyerChunkException(EXCEPTION_MSG_ZERO_SIZED_CHUNK);
+    }
+
+    auto decode = [&](void* buffer) {
+        if (header.encoding == CHUNK_ENCODING_RLECOMPRESSED)
+        {
+            DecodeChunkRepeat(buffer, decodedLength, rleData.data(), rleData.size());
+        }
+        else
+        {
+            DecodeChunk(buffer, decodedLength, src, header);
+        }
+    };
+
+    if (decodedLength <= length)
+    {
+        decode(dst);
+        std::fill_n(static_cast<uint8_t*>(dst) + decodedLength, length - decodedLength, 0x00);
     }
     else
     {
-        std::memcpy(dst, chunkData, chunkLength);
-        auto remainingLength = length - chunkLength;
-        if (remainingLength > 0)
+        std::vector<uint8_t> buffer(decodedLength);
+        decode(buffer.data());
+        std::memcpy(dst, buffer.data(), length);
+    }
+}
+
+size_t SawyerChunkReader::GetDecodedLengthRLE(const void* src, size_t srcLength)
+{
+    auto src8 = static_cast<const uint8_t*>(src);
+    size_t length = 0;
+    for (size_t i = 0; i < srcLength; i++)
+    {
+        uint8_t rleCodeByte = src8[i];
+        if (rleCodeByte & 128)
         {
-            auto offset = static_cast<uint8_t*>(dst) + chunkLength;
-            std::fill_n(offset, remainingLength, 0x00);
+            i++;
+            length += 257 - rleCodeByte;
+        }
+        else
+        {
+            length += rleCodeByte + 1;
+            i += rleCodeByte + 1;
+        }
+    }
+    if (length > MAX_UNCOMPRESSED_CHUNK_SIZE)
+    {
+        throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_CHUNK_SIZE);
+    }
+    return length;
+}
+
+size_t SawyerChunkReader::GetDecodedLengthRepeat(const void* src, size_t srcLength)
+{
+    auto src8 = static_cast<const uint8_t*>(src);
+    size_t length = 0;
+    for (size_t i = 0; i < srcLength; i++)
+    {
+        if (src8[i] == 0xFF)
+        {
+            i++;
+            length++;
+        }
+        else
+        {
+            length += (src8[i] & 7) + 1;
         }
     }
+    if (length > MAX_UNCOMPRESSED_CHUNK_SIZE)
+    {
+        throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_CHUNK_SIZE);
+    }
+    return length;
 }
 
 size_t SawyerChunkReader::DecodeChunk(void* dst, size_t dstCapacity, const void* src, const sawyercoding_chunk_header& header)
@@ -192,11 +338,9 @@ size_t SawyerChunkReader::DecodeChunk(void* dst, size_t dstCapacity, const void*
 
 size_t SawyerChunkReader::DecodeChunkRLERepeat(void* dst, size_t dstCapacity, const void* src, size_t srcLength)
 {
-    auto immBuffer = AllocateLargeTempBuffer();
-    auto immLength = DecodeChunkRLE(immBuffer, MAX_UNCOMPRESSED_CHUNK_SIZE, src, srcLength);
-    auto size = DecodeChunkRepeat(dst, dstCapacity, immBuffer, immLength);
-    FreeLargeTempBuffer(immBuffer);
-    return size;
+    std::vector<uint8_t> immBuffer(GetDecodedLengthRLE(src, srcLength));
+    auto immLength = DecodeChunkRLE(immBuffer.data(), immBuffer.size(), src, srcLength);
+    return DecodeChunkRepeat(dst, dstCapacity, immBuffer.data(), immLength);
 }
 
 size_t SawyerChunkReader::DecodeChunkRLE(void* dst, size_t dstCapacity, const void* src, size_t srcLength)
@@ -204,7 +348,11 @@ size_t SawyerChunkReader::DecodeChunkRLE(void* dst, size_t dstCapacity, const vo
     auto src8 = static_cast<const uint8_t*>(src);
     auto dst8 = static_cast<uint8_t*>(dst);
     auto dstEnd = dst8 + dstCapacity;
-    for (size_t i = 0; i < srcLength; i++)
+
+    // Runs far from the end of either buffer can not be corrupt or overflow, only the rest is checked
+    size_t i;
+    dst8 += sawyercoding_decode_rle_blocks(src8, srcLength, dst8, dstCapacity, &i);
+    for (; i < srcLength; i++)
     {
         uint8_t rleCodeByte = src8[i];
         if (rleCodeByte & 128)
@@ -256,6 +404,14 @@ size_t SawyerChunkReader::DecodeChunkRepeat(void* dst, size_t dstCapacity, const
     {
         if (src8[i] == 0xFF)
         {
+            if (i + 1 >= srcLength)
+            {
+                throw SawyerChunkException(EXCEPTION_MSG_CORRUPT_RLE);
+            }
+            if (dst8 >= dstEnd)
+            {
+                throw SawyerChunkException(EXCEPTION_MSG_DESTINATION_TOO_SMALL);
+            }
             *dst8++ = src8[++i];
         }
         else
@@ -263,7 +419,7 @@ size_t SawyerChunkReader::DecodeChunkRepeat(void* dst, size_t dstCapacity, const
             size_t count = (src8[i] & 7) + 1;
             const uint8_t* copySrc = dst8 + static_cast<int32_t>(src8[i] >> 3) - 32;
 
-            if (dst8 + count >= dstEnd || copySrc + count >= dstEnd)
+            if (dst8 + count > dstEnd || copySrc + count > dstEnd)
             {
                 throw SawyerChunkException(EXCEPTION_MSG_DESTINATION_TOO_SMALL);
             }
@@ -13,13 +13,24 @@
 #include "../util/SawyerCoding.h"
 #include "SawyerChunk.h"
 
+#include <future>
 #include <memory>
+#include <vector>
 
 namespace OpenRCT2
 {
     struct IStream;
 }
 
+/**
+ * Where ReadChunksAsync copies a decoded chunk to.
+ */
+struct SawyerChunkDestination
+{
+    void* Data;
+    size_t Length;
+};
+
 /**
  * Reads sawyer encoding chunks from a data stream. This can be used to read
  * SC6, SV6 and RCT2 objects.
@@ -58,6 +69,18 @@ public:
      */
     void ReadChunk(void* dst, size_t length);
 
+    /**
+     * Reads the next chunks from the stream, one for each destination, and
+     * decodes them concurrently on background threads. Each chunk is copied
+     * to its destination as ReadChunk(dst, length) does. The stream is left
+     * after the last chunk when this returns.
+     * @param destinations The destination buffers, these must stay valid
+     *                     until the returned future is ready.
+     * @return A future that is ready once all chunks are decoded, it
+     *         rethrows the first decoding error.
+     */
+    std::future<void> ReadChunksAsync(const std::vector<SawyerChunkDestination>& destinations);
+
     /**
      * Reads the next chunk from the stream into a buffer returned as the
      * specified type. If the chunk is smaller than the size of the type
@@ -71,6 +94,17 @@ public:
     }
 
 private:
+    struct EncodedChunk
+    {
+        sawyercoding_chunk_header Header{};
+        std::unique_ptr<uint8_t[]> Data;
+    };
+
+    EncodedChunk ReadEncodedChunk();
+
+    static void DecodeChunkTo(void* dst, size_t length, const EncodedChunk& chunk);
+    static size_t GetDecodedLengthRLE(const void* src, size_t srcLength);
+    static size_t GetDecodedLengthRepeat(const void* src, size_t srcLength);
     static size_t DecodeChunk(void* dst, size_t dstCapacity, const void* src, const sawyercoding_chunk_header& header);
     static size_t DecodeChunkRLERepeat(void* dst, size_t dstCapacity, const void* src, size_t srcLength);
     static size_t DecodeChunkRLE(void* dst, size_t dstCapacity, const void* src, size_t srcLength);
@@ -13,10 +13,12 @@
 #include "../Game.h"
 #include "../GameState.h"
 #include "../OpenRCT2.h"
+#include "../ParkFile.h"
 #include "../common.h"
 #include "../config/Config.h"
 #include "../core/FileStream.hpp"
 #include "../core/IStream.hpp"
+#include "../core/MemoryStream.h"
 #include "../core/String.hpp"
 #include "../interface/Viewport.h"
 #include "../interface/Window.h"
@@ -90,6 +92,31 @@ void S6Exporter::Save(OpenRCT2::IStream* stream, bool isScenario)
     _s6.header.magic_number = S6_MAGIC_NUMBER;
     _s6.game_version_number = 201028;
 
+    if (UseParkFile)
+    {
+        SaveParkFile(stream);
+    }
+    else
+    {
+        SaveSawyerChunks(stream);
+    }
+
+    // Determine number of bytes written
+    size_t fileSize = stream->GetLength();
+
+    // Read all written bytes back into a single buffer
+    stream->SetPosition(0);
+    auto data = std::unique_ptr<uint8_t, std::function<void(uint8_t*)>>(
+        stream->ReadArray<uint8_t>(fileSize), Memory::Free<uint8_t>);
+    uint32_t checksum = sawyercoding_calculate_checksum(data.get(), fileSize);
+
+    // Write the checksum on the end
+    stream->SetPosition(fileSize);
+    stream->WriteValue(checksum);
+}
+
+void S6Exporter::SaveSawyerChunks(OpenRCT2::IStream* stream)
+{
     auto chunkWriter = SawyerChunkWriter(stream);
 
     // 0: Write header chunk
@@ -104,8 +131,7 @@ void S6Exporter::Save(OpenRCT2::IStream* stream, bool isScenario)
     // 2: Write packed objects
     if (_s6.header.num_packed_objects > 0)
     {
-        auto& objRepo = OpenRCT2::GetContext()->GetObjectRepository();
-        objRepo.WritePackedObjects(stream, ExportObjectsList);
+        stream->Write(_packedObjects.data(), _packedObjects.size());
     }
 
     // 3: Write available objects chunk
@@ -134,19 +160,48 @@ void S6Exporter::Save(OpenRCT2::IStream* stream, bool isScenario)
         // 6: Everything else...
         chunkWriter.WriteChunk(&_s6.next_free_tile_element_pointer_index, 0x2E8570, SAWYER_ENCODING::RLECOMPRESSED);
     }
+}
 
-    // Determine number of bytes written
-    size_t fileSize = stream->GetLength();
-
-    // Read all written bytes back into a single buffer
-    stream->SetPosition(0);
-    auto data = std::unique_ptr<uint8_t, std::function<void(uint8_t*)>>(
-        stream->ReadArray<uint8_t>(fileSize), Memory::Free<uint8_t>);
-    uint32_t checksum = sawyercoding_calculate_checksum(data.get(), fileSize);
-
-    // Write the checksum on the end
-    stream->SetPosition(fileSize);
-    stream->WriteValue(checksum);
+void S6Exporter::SaveParkFile(OpenRCT2::IStream* stream)
+{
+    auto writer = std::make_shared<OpenRCT2::ParkFileWriter>();
+    writer->AddChunk(S6_PARK_CHUNK_HEADER, &_s6.header, sizeof(_s6.header));
+    if (_s6.header.type == S6_TYPE_SCENARIO)
+    {
+        writer->AddChunk(S6_PARK_CHUNK_INFO, &_s6.info, sizeof(_s6.info));
+    }
+    if (_s6.header.num_packed_objects > 0)
+    {
+        writer->AddChunk(S6_PARK_CHUNK_PACKED_OBJECTS, _packedObjects.data(), _packedObjects.size());
+    }
+    writer->AddChunk(S6_PARK_CHUNK_OBJECTS, _s6.objects, sizeof(_s6.objects));
+    writer->AddChunk(S6_PARK_CHUNK_MISC, &_s6.elapsed_months, 16);
+    writer->AddChunk(S6_PARK_CHUNK_TILE_ELEMENTS, &_s6.tile_elements, 0x180000);
+    if (_s6.header.type == S6_TYPE_SCENARIO)
+    {
+        // Leave out the same fields SC6 does
+        writer->AddChunk(S6_PARK_CHUNK_GAME_STATE, &_s6.next_free_tile_element_pointer_index, 0x27104C);
+        writer->AddChunk(S6_PARK_CHUNK_GAME_STATE + 1, &_s6.guests_in_park, 4);
+        writer->AddChunk(S6_PARK_CHUNK_GAME_STATE + 2, &_s6.last_guests_in_park, 8);
+        writer->AddChunk(S6_PARK_CHUNK_GAME_STATE + 3, &_s6.park_rating, 2);
+        writer->AddChunk(S6_PARK_CHUNK_GAME_STATE + 4, &_s6.active_research_types, 1082);
+        writer->AddChunk(S6_PARK_CHUNK_GAME_STATE + 5, &_s6.current_expenditure, 16);
+        writer->AddChunk(S6_PARK_CHUNK_GAME_STATE + 6, &_s6.park_value, 4);
+        writer->AddChunk(S6_PARK_CHUNK_GAME_STATE + 7, &_s6.completed_company_value, 0x761E8);
+    }
+    else
+    {
+        writer->AddChunk(S6_PARK_CHUNK_GAME_STATE, &_s6.next_free_tile_element_pointer_index, 0x2E8570);
+    }
+    if (DeltaBase != nullptr)
+    {
+        _deltaLength = writer->SaveDelta(stream, *DeltaBase, DeltaBasePath, Compression);
+    }
+    else
+    {
+        writer->Save(stream, Compression);
+    }
+    _parkFile = writer;
 }
 
 void S6Exporter::Export()
@@ -432,6 +487,21 @@ void S6Exporter::Export()
     game_convert_strings_to_rct2(&_s6);
 
     ExportUserStrings();
+    ExportPackedObjects();
+}
+
+void S6Exporter::ExportPackedObjects()
+{
+    // Saving can happen on another thread, which must not read the object repository while it changes
+    _packedObjects.clear();
+    if (!ExportObjectsList.empty())
+    {
+        OpenRCT2::MemoryStream ms;
+        auto& objRepo = OpenRCT2::GetContext()->GetObjectRepository();
+        objRepo.WritePackedObjects(&ms, ExportObjectsList);
+        auto data = static_cast<const uint8_t*>(ms.GetData());
+        _packedObjects.assign(data, data + ms.GetLength());
+    }
 }
 
 void S6Exporter::ExportPeepSpawns()
@@ -10,9 +10,11 @@
 #pragma once
 
 #include "../common.h"
+#include "../ParkFile.h"
 #include "../object/ObjectList.h"
 #include "../scenario/Scenario.h"
 
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -35,6 +37,12 @@ class S6Exporter final
 public:
     bool RemoveTracklessRides;
     std::vector<const ObjectRepositoryItem*> ExportObjectsList;
+    // Saves to a park file instead of an SV6 / SC6, which is much faster to write and read but only OpenRCT2 can load
+    bool UseParkFile = false;
+    OpenRCT2::ParkFileCompression Compression = OpenRCT2::ParkFileCompression::Fast;
+    // When set, park files are saved as a delta against this park file, see ParkFileWriter::SaveDelta
+    std::shared_ptr<const OpenRCT2::ParkFileWriter> DeltaBase;
+    std::string DeltaBasePath;
 
     S6Exporter();
 
@@ -54,11 +62,32 @@ public:
     void ExportSpriteMisc(RCT12SpriteBase* dst, const SpriteBase* src);
     void ExportSpriteLitter(RCT12SpriteLitter* dst, const Litter* src);
 
+    /**
+     * Gets the chunks of the last park file that was saved, which can be used as DeltaBase of a later save.
+     */
+    std::shared_ptr<const OpenRCT2::ParkFileWriter> GetParkFile() const
+    {
+        return _parkFile;
+    }
+
+    /**
+     * Gets the number of bytes the last delta holds before compression.
+     */
+    size_t GetDeltaLength() const
+    {
+        return _deltaLength;
+    }
+
 private:
     rct_s6_data _s6{};
     std::vector<std::string> _userStrings;
+    std::vector<uint8_t> _packedObjects;
+    std::shared_ptr<const OpenRCT2::ParkFileWriter> _parkFile;
+    size_t _deltaLength = 0;
 
     void Save(OpenRCT2::IStream* stream, bool isScenario);
+    void SaveSawyerChunks(OpenRCT2::IStream* stream);
+    void SaveParkFile(OpenRCT2::IStream* stream);
     static uint32_t GetLoanHash(money32 initialCash, money32 bankLoan, uint32_t maxBankLoan);
     void ExportResearchedRideTypes();
     void ExportResearchedRideEntries();
@@ -78,4 +107,5 @@ private:
 
     std::optional<uint16_t> AllocateUserString(const std::string_view& value);
     void ExportUserStrings();
+    void ExportPackedObjects();
 };
@@ -12,11 +12,13 @@
 #include "../Game.h"
 #include "../GameState.h"
 #include "../OpenRCT2.h"
+#include "../ParkFile.h"
 #include "../ParkImporter.h"
 #include "../config/Config.h"
 #include "../core/Console.hpp"
 #include "../core/FileStream.hpp"
 #include "../core/IStream.hpp"
+#include "../core/MemoryStream.h"
 #include "../core/Path.hpp"
 #include "../core/Random.hpp"
 #include "../core/String.hpp"
@@ -54,6 +56,7 @@
 #include "../world/Surface.h"
 
 #include <algorithm>
+#include <future>
 
 /**
  * Class to import RollerCoaster Tycoon 2 scenarios (*.SC6) and saved games (*.SV6).
@@ -68,6 +71,9 @@ private:
     uint8_t _gameVersion = 0;
     bool _isSV7 = false;
 
+    // Decodes the large chunks into _s6 while the objects are loaded, declared after _s6 so it is waited for first
+    std::future<void> _chunkDecodeJob;
+
 public:
     S6Importer(IObjectRepository& objectRepository)
         : _objectRepository(objectRepository)
@@ -81,7 +87,7 @@ public:
         {
             return LoadScenario(path);
         }
-        else if (String::Equals(extension, ".sv6", true))
+        else if (String::Equals(extension, ".sv6", true) || String::Equals(extension, ".park", true))
         {
             return LoadSavedGame(path);
         }
@@ -94,7 +100,7 @@ public:
     ParkLoadResult LoadSavedGame(const utf8* path, bool skipObjectCheck = false) override
     {
         auto fs = OpenRCT2::FileStream(path, OpenRCT2::FILE_MODE_OPEN);
-        auto result = LoadFromStream(&fs, false, skipObjectCheck);
+        auto result = LoadFromStream(&fs, false, skipObjectCheck, path);
         _s6Path = path;
         return result;
     }
@@ -102,7 +108,7 @@ public:
     ParkLoadResult LoadScenario(const utf8* path, bool skipObjectCheck = false) override
     {
         auto fs = OpenRCT2::FileStream(path, OpenRCT2::FILE_MODE_OPEN);
-        auto result = LoadFromStream(&fs, true, skipObjectCheck);
+        auto result = LoadFromStream(&fs, true, skipObjectCheck, path);
         _s6Path = path;
         return result;
     }
@@ -116,29 +122,39 @@ public:
             throw IOException("Invalid checksum.");
         }
 
-        auto chunkReader = SawyerChunkReader(stream);
-        chunkReader.ReadChunk(&_s6.header, sizeof(_s6.header));
+        if (_chunkDecodeJob.valid())
+        {
+            _chunkDecodeJob.wait();
+        }
 
-        log_verbose("saved game classic_flag = 0x%02x", _s6.header.classic_flag);
-        if (isScenario)
+        if (OpenRCT2::ParkFileReader::IsParkFile(stream))
         {
-            if (_s6.header.type != S6_TYPE_SCENARIO)
-            {
-                throw std::runtime_error("Park is not a scenario.");
-            }
-            chunkReader.ReadChunk(&_s6.info, sizeof(_s6.info));
+            ReadParkFile(stream, isScenario, path);
         }
         else
         {
-            if (_s6.header.type != S6_TYPE_SAVEDGAME)
-            {
-                throw std::runtime_error("Park is not a saved game.");
-            }
+            ReadSawyerChunks(stream, isScenario);
         }
 
-        if (_s6.header.classic_flag == 0xf)
+        if (path)
         {
-            throw UnsupportedRCTCFlagException(_s6.header.classic_flag);
+            auto extension = path_get_extension(path);
+            _isSV7 = _stricmp(extension, ".sv7") == 0;
+        }
+
+        _s6Path = path;
+
+        return ParkLoadResult(GetRequiredObjects());
+    }
+
+    void ReadSawyerChunks(OpenRCT2::IStream* stream, bool isScenario)
+    {
+        auto chunkReader = SawyerChunkReader(stream);
+        chunkReader.ReadChunk(&_s6.header, sizeof(_s6.header));
+        ValidateHeader(isScenario);
+        if (isScenario)
+        {
+            chunkReader.ReadChunk(&_s6.info, sizeof(_s6.info));
         }
 
         // Read packed objects
@@ -148,37 +164,119 @@ public:
             _objectRepository.ExportPackedObject(stream);
         }
 
-        if (path)
+        // Only the object list is needed to return the required objects, the rest is decoded in the background until
+        // Import needs it so the caller can load the objects in the meantime.
+        chunkReader.ReadChunk(&_s6.objects, sizeof(_s6.objects));
+        if (isScenario)
         {
-            auto extension = path_get_extension(path);
-            _isSV7 = _stricmp(extension, ".sv7") == 0;
+            _chunkDecodeJob = chunkReader.ReadChunksAsync({
+                { &_s6.elapsed_months, 16 },
+                { &_s6.tile_elements, sizeof(_s6.tile_elements) },
+                { &_s6.next_free_tile_element_pointer_index, 2560076 },
+                { &_s6.guests_in_park, 4 },
+                { &_s6.last_guests_in_park, 8 },
+                { &_s6.park_rating, 2 },
+                { &_s6.active_research_types, 1082 },
+                { &_s6.current_expenditure, 16 },
+                { &_s6.park_value, 4 },
+                { &_s6.completed_company_value, 483816 },
+            });
+        }
+        else
+        {
+            _chunkDecodeJob = chunkReader.ReadChunksAsync({
+                { &_s6.elapsed_months, 16 },
+                { &_s6.tile_elements, sizeof(_s6.tile_elements) },
+                { &_s6.next_free_tile_element_pointer_index, 3048816 },
+            });
+        }
+    }
+
+    void ReadParkFile(OpenRCT2::IStream* stream, bool isScenario, const utf8* path)
+    {
+        auto reader = OpenRCT2::ParkFileReader(stream);
+
+        // Incremental autosaves only store what changed since their base, which is only needed while the blocks are read
+        std::unique_ptr<OpenRCT2::FileStream> baseStream;
+        if (reader.IsDelta())
+        {
+            // The base is always written next to the delta, anything else could point outside of the save directory
+            auto baseName = reader.GetBasePath();
+            if (baseName.empty() || baseName == "." || baseName == ".." || baseName.find_first_of("/\\:") != std::string::npos)
+            {
+                throw std::runtime_error("Invalid base path in incremental park file.");
+            }
+            auto basePath = Path::Combine(Path::GetDirectory(std::string(path == nullptr ? "" : path)), baseName);
+            baseStream = std::make_unique<OpenRCT2::FileStream>(basePath, OpenRCT2::FILE_MODE_OPEN);
+            reader.SetBase(baseStream.get());
         }
 
+        reader.ReadChunk(S6_PARK_CHUNK_HEADER, &_s6.header, sizeof(_s6.header));
+        ValidateHeader(isScenario);
         if (isScenario)
         {
-            chunkReader.ReadChunk(&_s6.objects, sizeof(_s6.objects));
-            chunkReader.ReadChunk(&_s6.elapsed_months, 16);
-            chunkReader.ReadChunk(&_s6.tile_elements, sizeof(_s6.tile_elements));
-            chunkReader.ReadChunk(&_s6.next_free_tile_element_pointer_index, 2560076);
-            chunkReader.ReadChunk(&_s6.guests_in_park, 4);
-            chunkReader.ReadChunk(&_s6.last_guests_in_park, 8);
-            chunkReader.ReadChunk(&_s6.park_rating, 2);
-            chunkReader.ReadChunk(&_s6.active_research_types, 1082);
-            chunkReader.ReadChunk(&_s6.current_expenditure, 16);
-            chunkReader.ReadChunk(&_s6.park_value, 4);
-            chunkReader.ReadChunk(&_s6.completed_company_value, 483816);
+            reader.ReadChunk(S6_PARK_CHUNK_INFO, &_s6.info, sizeof(_s6.info));
+        }
+
+        if (_s6.header.num_packed_objects > 0)
+        {
+            auto packedObjects = reader.ReadChunk(S6_PARK_CHUNK_PACKED_OBJECTS);
+            auto ms = OpenRCT2::MemoryStream(packedObjects.data(), packedObjects.size());
+            for (uint16_t i = 0; i < _s6.header.num_packed_objects; i++)
+            {
+                _objectRepository.ExportPackedObject(&ms);
+            }
+        }
+
+        // As with SV6, the remaining chunks are decompressed in the background while the objects load
+        reader.ReadChunk(S6_PARK_CHUNK_OBJECTS, &_s6.objects, sizeof(_s6.objects));
+        if (isScenario)
+        {
+            _chunkDecodeJob = reader.ReadChunksAsync({
+                { S6_PARK_CHUNK_MISC, &_s6.elapsed_months, 16 },
+                { S6_PARK_CHUNK_TILE_ELEMENTS, &_s6.tile_elements, sizeof(_s6.tile_elements) },
+                { S6_PARK_CHUNK_GAME_STATE, &_s6.next_free_tile_element_pointer_index, 2560076 },
+                { S6_PARK_CHUNK_GAME_STATE + 1, &_s6.guests_in_park, 4 },
+                { S6_PARK_CHUNK_GAME_STATE + 2, &_s6.last_guests_in_park, 8 },
+                { S6_PARK_CHUNK_GAME_STATE + 3, &_s6.park_rating, 2 },
+                { S6_PARK_CHUNK_GAME_STATE + 4, &_s6.active_research_types, 1082 },
+                { S6_PARK_CHUNK_GAME_STATE + 5, &_s6.current_expenditure, 16 },
+                { S6_PARK_CHUNK_GAME_STATE + 6, &_s6.park_value, 4 },
+                { S6_PARK_CHUNK_GAME_STATE + 7, &_s6.completed_company_value, 483816 },
+            });
         }
         else
         {
-            chunkReader.ReadChunk(&_s6.objects, sizeof(_s6.objects));
-            chunkReader.ReadChunk(&_s6.elapsed_months, 16);
-            chunkReader.ReadChunk(&_s6.tile_elements, sizeof(_s6.tile_elements));
-            chunkReader.ReadChunk(&_s6.next_free_tile_element_pointer_index, 3048816);
+            _chunkDecodeJob = reader.ReadChunksAsync({
+                { S6_PARK_CHUNK_MISC, &_s6.elapsed_months, 16 },
+                { S6_PARK_CHUNK_TILE_ELEMENTS, &_s6.tile_elements, sizeof(_s6.tile_elements) },
+                { S6_PARK_CHUNK_GAME_STATE, &_s6.next_free_tile_element_pointer_index, 3048816 },
+            });
         }
+    }
 
-        _s6Path = path;
+    void ValidateHeader(bool isScenario)
+    {
+        log_verbose("saved game classic_flag = 0x%02x", _s6.header.classic_flag);
+        if (isScenario)
+        {
+            if (_s6.header.type != S6_TYPE_SCENARIO)
+            {
+                throw std::runtime_error("Park is not a scenario.");
+            }
+        }
+        else
+        {
+            if (_s6.header.type != S6_TYPE_SAVEDGAME)
+            {
+                throw std::runtime_error("Park is not a saved game.");
+            }
+        }
 
-        return ParkLoadResult(GetRequiredObjects());
+        if (_s6.header.classic_flag == 0xf)
+        {
+            throw UnsupportedRCTCFlagException(_s6.header.classic_flag);
+        }
     }
 
     bool GetDetails(scenario_index_entry* dst) override
@@ -189,6 +287,11 @@ public:
 
     void Import() override
     {
+        if (_chunkDecodeJob.valid())
+        {
+            _chunkDecodeJob.get();
+        }
+
         Initialise();
 
         // _s6.header
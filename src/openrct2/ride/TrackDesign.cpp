@@ -2083,6 +2083,12 @@ void track_design_draw_preview(TrackDesign* td6, uint8_t* pixels)
         view.viewPos = { left, top };
         viewport_paint(&view, &dpi, left, top, right, bottom);
 
+        // Object images that had not been read yet were left out
+        if (gfx_lazy_images_load_requested())
+        {
+            viewport_paint(&view, &dpi, left, top, right, bottom);
+        }
+
         dpi.bits += TRACK_PREVIEW_IMAGE_SIZE;
     }
 
@@ -312,6 +312,18 @@ enum
     S6_TYPE_SCENARIO
 };
 
+// Chunk ids used when S6 data is stored in a park file, in the same order as the chunks of an SV6 / SC6
+enum : uint32_t
+{
+    S6_PARK_CHUNK_HEADER,
+    S6_PARK_CHUNK_INFO,
+    S6_PARK_CHUNK_PACKED_OBJECTS,
+    S6_PARK_CHUNK_OBJECTS,
+    S6_PARK_CHUNK_MISC,
+    S6_PARK_CHUNK_TILE_ELEMENTS,
+    S6_PARK_CHUNK_GAME_STATE, // Scenarios split this into 8 chunks like SC6 does, numbered from here
+};
+
 #define S6_RCT2_VERSION 120001
 #define S6_MAGIC_NUMBER 0x00031144
 
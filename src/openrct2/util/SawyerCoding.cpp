@@ -23,9 +23,52 @@ static size_t encode_chunk_rle(const uint8_t* src_buffer, uint8_t* dst_buffer, s
 static size_t encode_chunk_repeat(const uint8_t* src_buffer, uint8_t* dst_buffer, size_t length);
 static void encode_chunk_rotate(uint8_t* buffer, size_t length);
 
-bool gUseRLE = true;
+thread_local bool gUseRLE = true;
+thread_local bool gUseVectorisedSawyerCoding = true;
+
+struct SawyerCodingFunctions
+{
+    uint32_t (*CalculateChecksum)(const uint8_t* buffer, size_t length);
+    size_t (*CountLiterals)(const uint8_t* src, size_t maxCount);
+    size_t (*CountRepeats)(const uint8_t* src, size_t maxCount);
+    size_t (*FindRepeat)(const uint8_t* src, size_t length, size_t position, size_t* repeatIndex);
+    size_t (*DecodeRLEBlocks)(const uint8_t* src, size_t srcLength, uint8_t* dst, size_t dstCapacity, size_t* srcRead);
+};
+
+static constexpr SawyerCodingFunctions ScalarFunctions = {
+    sawyercoding_calculate_checksum_scalar, sawyercoding_count_literals_scalar, sawyercoding_count_repeats_scalar,
+    sawyercoding_find_repeat_scalar, sawyercoding_decode_rle_blocks_scalar,
+};
+
+static constexpr SawyerCodingFunctions SSE41Functions = {
+    sawyercoding_calculate_checksum_sse4_1, sawyercoding_count_literals_sse4_1, sawyercoding_count_repeats_sse4_1,
+    sawyercoding_find_repeat_sse4_1, sawyercoding_decode_rle_blocks_sse4_1,
+};
+
+static const SawyerCodingFunctions& sawyercoding_get_functions()
+{
+    if (!gUseVectorisedSawyerCoding)
+        return ScalarFunctions;
+
+    // Chunks are encoded and decoded from worker threads as well, so this is selected on first use
+    static const SawyerCodingFunctions& functions = []() -> const SawyerCodingFunctions& {
+        if (sse41_available())
+        {
+            log_verbose("registering SSE4.1 sawyer coding functions");
+            return SSE41Functions;
+        }
+        log_verbose("registering scalar sawyer coding functions");
+        return ScalarFunctions;
+    }();
+    return functions;
+}
 
 uint32_t sawyercoding_calculate_checksum(const uint8_t* buffer, size_t length)
+{
+    return sawyercoding_get_functions().CalculateChecksum(buffer, length);
+}
+
+uint32_t sawyercoding_calculate_checksum_scalar(const uint8_t* buffer, size_t length)
 {
     size_t i;
     uint32_t checksum = 0;
@@ -35,6 +78,87 @@ uint32_t sawyercoding_calculate_checksum(const uint8_t* buffer, size_t length)
     return checksum;
 }
 
+/**
+ * Counts the bytes from src that are each different from the byte after them, reads up to src[maxCount].
+ */
+size_t sawyercoding_count_literals_scalar(const uint8_t* src, size_t maxCount)
+{
+    size_t count = 0;
+    while (count < maxCount && src[count] != src[count + 1])
+        count++;
+    return count;
+}
+
+/**
+ * Counts the bytes from src that are equal to the first one, up to maxCount.
+ */
+size_t sawyercoding_count_repeats_scalar(const uint8_t* src, size_t maxCount)
+{
+    size_t count = 0;
+    while (count < maxCount && src[count] == src[0])
+        count++;
+    return count;
+}
+
+/**
+ * Finds the longest run of up to 8 bytes in the 32 bytes before position that matches the bytes at position, the
+ * earliest one if there are several.
+ * @param repeatIndex Receives where the run starts.
+ * @return The length of the run, 0 if not even the first byte matches.
+ */
+size_t sawyercoding_find_repeat_scalar(const uint8_t* src, size_t length, size_t position, size_t* repeatIndex)
+{
+    size_t searchIndex = (position < 32) ? 0 : (position - 32);
+    size_t searchEnd = position - 1;
+
+    size_t bestRepeatIndex = 0;
+    size_t bestRepeatCount = 0;
+    for (size_t index = searchIndex; index <= searchEnd; index++)
+    {
+        size_t repeatCount = 0;
+        size_t maxRepeatCount = std::min(std::min(static_cast<size_t>(7), searchEnd - index), length - position - 1);
+        // maxRepeatCount should not exceed length
+        assert(index + maxRepeatCount < length);
+        assert(position + maxRepeatCount < length);
+        for (size_t j = 0; j <= maxRepeatCount; j++)
+        {
+            if (src[index + j] == src[position + j])
+            {
+                repeatCount++;
+            }
+            else
+            {
+                break;
+            }
+        }
+        if (repeatCount > bestRepeatCount)
+        {
+            bestRepeatIndex = index;
+            bestRepeatCount = repeatCount;
+
+            // Maximum repeat count is 8
+            if (repeatCount == 8)
+                break;
+        }
+    }
+    *repeatIndex = bestRepeatIndex;
+    return bestRepeatCount;
+}
+
+size_t sawyercoding_decode_rle_blocks_scalar(
+    [[maybe_unused]] const uint8_t* src, [[maybe_unused]] size_t srcLength, [[maybe_unused]] uint8_t* dst,
+    [[maybe_unused]] size_t dstCapacity, size_t* srcRead)
+{
+    // Block writes only pay off with vector registers, leave every run to the caller's loop
+    *srcRead = 0;
+    return 0;
+}
+
+size_t sawyercoding_decode_rle_blocks(const uint8_t* src, size_t srcLength, uint8_t* dst, size_t dstCapacity, size_t* srcRead)
+{
+    return sawyercoding_get_functions().DecodeRLEBlocks(src, srcLength, dst, dstCapacity, srcRead);
+}
+
 /**
  *
  *  rct2: 0x006762E1
@@ -228,11 +352,12 @@ static size_t decode_chunk_rle_with_size(const uint8_t* src_buffer, uint8_t* dst
     size_t count;
     uint8_t *dst, rleCodeByte;
 
-    dst = dst_buffer;
-
     assert(length > 0);
     assert(dstSize > 0);
-    for (size_t i = 0; i < length; i++)
+
+    size_t i;
+    dst = dst_buffer + sawyercoding_decode_rle_blocks(src_buffer, length, dst_buffer, dstSize, &i);
+    for (; i < length; i++)
     {
         rleCodeByte = src_buffer[i];
         if (rleCodeByte & 128)
@@ -273,6 +398,7 @@ static size_t encode_chunk_rle(const uint8_t* src_buffer, uint8_t* dst_buffer, s
     const uint8_t* end_src = src + length;
     uint8_t count = 0;
     const uint8_t* src_norm_start = src;
+    const auto& functions = sawyercoding_get_functions();
 
     while (src < end_src - 1)
     {
@@ -286,11 +412,7 @@ static size_t encode_chunk_rle(const uint8_t* src_buffer, uint8_t* dst_buffer, s
         }
         if (*src == src[1])
         {
-            for (; (count < 125) && ((src + count) < end_src); count++)
-            {
-                if (*src != src[count])
-                    break;
-            }
+            count = static_cast<uint8_t>(functions.CountRepeats(src, std::min<size_t>(125, end_src - src)));
             *dst++ = 257 - count;
             *dst++ = *src;
             src += count;
@@ -299,8 +421,10 @@ static size_t encode_chunk_rle(const uint8_t* src_buffer, uint8_t* dst_buffer, s
         }
         else
         {
-            count++;
-            src++;
+            // Take every following byte that would also be added to the literal run one at a time
+            size_t literals = functions.CountLiterals(src, std::min<size_t>(126 - count, end_src - 1 - src));
+            count += static_cast<uint8_t>(literals);
+            src += literals;
         }
     }
     if (src == end_src - 1)
@@ -327,41 +451,11 @@ static size_t encode_chunk_repeat(const uint8_t* src_buffer, uint8_t* dst_buffer
     outLength += 2;
 
     // Iterate through remainder of the source buffer
+    const auto& functions = sawyercoding_get_functions();
     for (size_t i = 1; i < length;)
     {
-        size_t searchIndex = (i < 32) ? 0 : (i - 32);
-        size_t searchEnd = i - 1;
-
         size_t bestRepeatIndex = 0;
-        size_t bestRepeatCount = 0;
-        for (size_t repeatIndex = searchIndex; repeatIndex <= searchEnd; repeatIndex++)
-        {
-            size_t repeatCount = 0;
-            size_t maxRepeatCount = std::min(std::min(static_cast<size_t>(7), searchEnd - repeatIndex), length - i - 1);
-            // maxRepeatCount should not exceed length
-            assert(repeatIndex + maxRepeatCount < length);
-            assert(i + maxRepeatCount < length);
-            for (size_t j = 0; j <= maxRepeatCount; j++)
-            {
-                if (src_buffer[repeatIndex + j] == src_buffer[i + j])
-                {
-                    repeatCount++;
-                }
-                else
-                {
-                    break;
-                }
-            }
-            if (repeatCount > bestRepeatCount)
-            {
-                bestRepeatIndex = repeatIndex;
-                bestRepeatCount = repeatCount;
-
-                // Maximum repeat count is 8
-                if (repeatCount == 8)
-                    break;
-            }
-        }
+        size_t bestRepeatCount = functions.FindRepeat(src_buffer, length, i, &bestRepeatIndex);
 
         if (bestRepeatCount == 0)
         {
@@ -42,7 +42,9 @@ enum
     FILE_TYPE_SC4 = (2 << 2)
 };
 
-extern bool gUseRLE;
+extern thread_local bool gUseRLE;
+// Set to false to encode and decode chunks on this thread with the scalar functions only
+extern thread_local bool gUseVectorisedSawyerCoding;
 
 uint32_t sawyercoding_calculate_checksum(const uint8_t* buffer, size_t length);
 size_t sawyercoding_write_chunk_buffer(uint8_t* dst_file, const uint8_t* src_buffer, sawyercoding_chunk_header chunkHeader);
@@ -53,6 +55,29 @@ size_t sawyercoding_decode_td6(const uint8_t* src, uint8_t* dst, size_t length);
 size_t sawyercoding_encode_td6(const uint8_t* src, uint8_t* dst, size_t length);
 int32_t sawyercoding_validate_track_checksum(const uint8_t* src, size_t length);
 
+// Building blocks of the functions above, selected at runtime by the available instruction sets. The scalar versions
+// define the results, the vectorised ones have to match them exactly.
+uint32_t sawyercoding_calculate_checksum_scalar(const uint8_t* buffer, size_t length);
+uint32_t sawyercoding_calculate_checksum_sse4_1(const uint8_t* buffer, size_t length);
+size_t sawyercoding_count_literals_scalar(const uint8_t* src, size_t maxCount);
+size_t sawyercoding_count_literals_sse4_1(const uint8_t* src, size_t maxCount);
+size_t sawyercoding_count_repeats_scalar(const uint8_t* src, size_t maxCount);
+size_t sawyercoding_count_repeats_sse4_1(const uint8_t* src, size_t maxCount);
+size_t sawyercoding_find_repeat_scalar(const uint8_t* src, size_t length, size_t position, size_t* repeatIndex);
+size_t sawyercoding_find_repeat_sse4_1(const uint8_t* src, size_t length, size_t position, size_t* repeatIndex);
+size_t sawyercoding_decode_rle_blocks_scalar(
+    const uint8_t* src, size_t srcLength, uint8_t* dst, size_t dstCapacity, size_t* srcRead);
+size_t sawyercoding_decode_rle_blocks_sse4_1(
+    const uint8_t* src, size_t srcLength, uint8_t* dst, size_t dstCapacity, size_t* srcRead);
+
+/**
+ * Decodes RLE runs from src while they are far enough from the end of either buffer to be written in whole blocks.
+ * Any remaining runs have to be decoded by the caller, from the returned positions.
+ * @param srcRead Receives the number of source bytes that were decoded.
+ * @return The number of bytes written to dst.
+ */
+size_t sawyercoding_decode_rle_blocks(const uint8_t* src, size_t srcLength, uint8_t* dst, size_t dstCapacity, size_t* srcRead);
+
 int32_t sawyercoding_detect_file_type(const uint8_t* src, size_t length);
 int32_t sawyercoding_detect_rct1_version(int32_t gameVersion);
 
@@ -0,0 +1,189 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "../common.h"
+#include "../core/Guard.hpp"
+#include "SawyerCoding.h"
+#include "Util.h"
+
+#ifdef __SSE4_1__
+
+#    include <immintrin.h>
+
+uint32_t sawyercoding_calculate_checksum_sse4_1(const uint8_t* buffer, size_t length)
+{
+    // _mm_sad_epu8 against zero sums each half of the 16 bytes into a 64 bit lane, which can not overflow here
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sum = zero;
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16)
+    {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + i));
+        sum = _mm_add_epi64(sum, _mm_sad_epu8(data, zero));
+    }
+
+    alignas(16) uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), sum);
+    uint32_t checksum = static_cast<uint32_t>(lanes[0] + lanes[1]);
+    for (; i < length; i++)
+    {
+        checksum += buffer[i];
+    }
+    return checksum;
+}
+
+size_t sawyercoding_count_literals_sse4_1(const uint8_t* src, size_t maxCount)
+{
+    size_t count = 0;
+    for (; count + 16 <= maxCount; count += 16)
+    {
+        const __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + count));
+        const __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + count + 1));
+        int32_t equalMask = _mm_movemask_epi8(_mm_cmpeq_epi8(current, next));
+        if (equalMask != 0)
+        {
+            return count + bitscanforward(equalMask);
+        }
+    }
+    return count + sawyercoding_count_literals_scalar(src + count, maxCount - count);
+}
+
+size_t sawyercoding_count_repeats_sse4_1(const uint8_t* src, size_t maxCount)
+{
+    const __m128i value = _mm_set1_epi8(static_cast<char>(src[0]));
+    size_t count = 0;
+    for (; count + 16 <= maxCount; count += 16)
+    {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + count));
+        int32_t differentMask = ~_mm_movemask_epi8(_mm_cmpeq_epi8(data, value)) & 0xFFFF;
+        if (differentMask != 0)
+        {
+            return count + bitscanforward(differentMask);
+        }
+    }
+    for (; count < maxCount && src[count] == src[0]; count++)
+    {
+    }
+    return count;
+}
+
+size_t sawyercoding_find_repeat_sse4_1(const uint8_t* src, size_t length, size_t position, size_t* repeatIndex)
+{
+    // Near either end of the buffer the window is incomplete, which the scalar version handles
+    if (position < 32 || position + 8 > length)
+    {
+        return sawyercoding_find_repeat_scalar(src, length, position, repeatIndex);
+    }
+
+    // Bit n of the mask stands for the run starting at position - 32 + n. The mask keeps the runs that match the
+    // first j + 1 bytes, where a run may not reach position itself.
+    const uint8_t* window = src + position - 32;
+    uint32_t bestMask = 0;
+    uint32_t mask = 0xFFFFFFFF;
+    size_t bestRepeatCount = 0;
+    for (size_t j = 0; j < 8; j++)
+    {
+        const __m128i value = _mm_set1_epi8(static_cast<char>(src[position + j]));
+        const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(window + j));
+        const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(window + j + 16));
+        uint32_t equalMask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(low, value)))
+            | (static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(high, value))) << 16);
+        mask &= equalMask & (0xFFFFFFFF >> j);
+        if (mask == 0)
+            break;
+        bestMask = mask;
+        bestRepeatCount = j + 1;
+    }
+
+    if (bestRepeatCount == 0)
+    {
+        *repeatIndex = 0;
+        return 0;
+    }
+    *repeatIndex = position - 32 + bitscanforward(static_cast<int32_t>(bestMask));
+    return bestRepeatCount;
+}
+
+size_t sawyercoding_decode_rle_blocks_sse4_1(
+    const uint8_t* src, size_t srcLength, uint8_t* dst, size_t dstCapacity, size_t* srcRead)
+{
+    // Runs are written in whole 16 byte blocks. A run is at most 129 bytes, so a block can end up to 15 bytes after
+    // the run, which later runs overwrite. Stop while there is room for that, the rest is decoded by the caller.
+    size_t i = 0;
+    size_t length = 0;
+    while (i + 129 <= srcLength && length + 144 <= dstCapacity)
+    {
+        uint8_t rleCodeByte = src[i];
+        if (rleCodeByte & 128)
+        {
+            size_t count = 257 - rleCodeByte;
+            const __m128i value = _mm_set1_epi8(static_cast<char>(src[i + 1]));
+            for (size_t j = 0; j < count; j += 16)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + length + j), value);
+            }
+            length += count;
+            i += 2;
+        }
+        else
+        {
+            size_t count = rleCodeByte + 1;
+            for (size_t j = 0; j < count; j += 16)
+            {
+                const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 1 + j));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + length + j), data);
+            }
+            length += count;
+            i += count + 1;
+        }
+    }
+    *srcRead = i;
+    return length;
+}
+
+#else
+
+#    ifdef OPENRCT2_X86
+#        error You have to compile this file with SSE4.1 enabled, when targetting x86!
+#    endif
+
+uint32_t sawyercoding_calculate_checksum_sse4_1(const uint8_t* buffer, size_t length)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+    return 0;
+}
+
+size_t sawyercoding_count_literals_sse4_1(const uint8_t* src, size_t maxCount)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+    return 0;
+}
+
+size_t sawyercoding_count_repeats_sse4_1(const uint8_t* src, size_t maxCount)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+    return 0;
+}
+
+size_t sawyercoding_find_repeat_sse4_1(const uint8_t* src, size_t length, size_t position, size_t* repeatIndex)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+    *repeatIndex = 0;
+    return 0;
+}
+
+size_t sawyercoding_decode_rle_blocks_sse4_1(
+    const uint8_t* src, size_t srcLength, uint8_t* dst, size_t dstCapacity, size_t* srcRead)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+    *srcRead = 0;
+    return 0;
+}
+
+#endif // __SSE4_1__
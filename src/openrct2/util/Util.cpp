@@ -585,6 +585,26 @@ uint8_t* util_zlib_inflate(uint8_t* data, size_t data_in_size, size_t* data_out_
     return buffer;
 }
 
+/**
+ * @brief Inflates zlib-compressed data into a buffer of known size
+ * @param data Data to be decompressed
+ * @param data_in_size Size of data to be decompressed
+ * @param dst Buffer receiving the decompressed data
+ * @param dst_size Exact size of the decompressed data
+ * @return Returns true if the data decompressed to exactly dst_size bytes.
+ */
+bool util_zlib_inflate_to(const uint8_t* data, size_t data_in_size, uint8_t* dst, size_t dst_size)
+{
+    uLongf out_size = static_cast<uLongf>(dst_size);
+    int32_t ret = uncompress(dst, &out_size, data, static_cast<uLong>(data_in_size));
+    if (ret != Z_OK || out_size != dst_size)
+    {
+        log_error("Error uncompressing data.");
+        return false;
+    }
+    return true;
+}
+
 /**
  * @brief Deflates input using zlib
  * @param data Data to be compressed
@@ -254,63 +254,60 @@ static size_t GetSpatialIndexOffset(int32_t x, int32_t y)
 
 #ifndef DISABLE_NETWORK
 
-rct_sprite_checksum sprite_checksum()
+std::vector<rct_sprite> sprite_checksum_capture()
 {
-    using namespace Crypt;
-
-    // TODO Remove statics, should be one of these per sprite manager / OpenRCT2 context.
-    //      Alternatively, make a new class for this functionality.
-    static std::unique_ptr<HashAlgorithm<20>> _spriteHashAlg;
-
-    rct_sprite_checksum checksum;
-
-    try
+    std::vector<rct_sprite> sprites;
+    sprites.reserve(MAX_SPRITES - GetEntityListCount(EntityListId::Free));
+    for (size_t i = 0; i < MAX_SPRITES; i++)
     {
-        if (_spriteHashAlg == nullptr)
+        // TODO create a way to copy only the specific type
+        auto sprite = GetEntity(i);
+        if (sprite != nullptr && sprite->sprite_identifier != SPRITE_IDENTIFIER_NULL
+            && sprite->sprite_identifier != SPRITE_IDENTIFIER_MISC)
         {
-            _spriteHashAlg = CreateSHA1();
-        }
+            // Upconvert it to rct_sprite so that the full size is copied.
+            auto& copy = sprites.emplace_back(*reinterpret_cast<rct_sprite*>(sprite));
 
-        _spriteHashAlg->Clear();
-        for (size_t i = 0; i < MAX_SPRITES; i++)
-        {
-            // TODO create a way to copy only the specific type
-            auto sprite = GetEntity(i);
-            if (sprite != nullptr && sprite->sprite_identifier != SPRITE_IDENTIFIER_NULL
-                && sprite->sprite_identifier != SPRITE_IDENTIFIER_MISC)
-            {
-                // Upconvert it to rct_sprite so that the full size is copied.
-                auto copy = *reinterpret_cast<rct_sprite*>(sprite);
+            // Only required for rendering/invalidation, has no meaning to the game state.
+            copy.generic.sprite_left = copy.generic.sprite_right = copy.generic.sprite_top = copy.generic.sprite_bottom = 0;
+            copy.generic.sprite_width = copy.generic.sprite_height_negative = copy.generic.sprite_height_positive = 0;
 
-                // Only required for rendering/invalidation, has no meaning to the game state.
-                copy.generic.sprite_left = copy.generic.sprite_right = copy.generic.sprite_top = copy.generic.sprite_bottom = 0;
-                copy.generic.sprite_width = copy.generic.sprite_height_negative = copy.generic.sprite_height_positive = 0;
-
-                // Next in quadrant might be a misc sprite, set first non-misc sprite in quadrant.
-                while (auto* nextSprite = GetEntity(copy.generic.next_in_quadrant))
-                {
-                    if (nextSprite->sprite_identifier == SPRITE_IDENTIFIER_MISC)
-                        copy.generic.next_in_quadrant = nextSprite->next_in_quadrant;
-                    else
-                        break;
-                }
-
-                if (copy.generic.Is<Peep>())
-                {
-                    // Name is pointer and will not be the same across clients
-                    copy.peep.Name = {};
+            // Next in quadrant might be a misc sprite, set first non-misc sprite in quadrant.
+            while (auto* nextSprite = GetEntity(copy.generic.next_in_quadrant))
+            {
+                if (nextSprite->sprite_identifier == SPRITE_IDENTIFIER_MISC)
+                    copy.generic.next_in_quadrant = nextSprite->next_in_quadrant;
+                else
+                    break;
+            }
 
-                    // We set this to 0 because as soon the client selects a guest the window will remove the
-                    // invalidation flags causing the sprite checksum to be different than on server, the flag does not affect
-                    // game state.
-                    copy.peep.WindowInvalidateFlags = 0;
-                }
+            if (copy.generic.Is<Peep>())
+            {
+                // Name is pointer and will not be the same across clients
+                copy.peep.Name = {};
 
-                _spriteHashAlg->Update(&copy, sizeof(copy));
+                // We set this to 0 because as soon the client selects a guest the window will remove the
+                // invalidation flags causing the sprite checksum to be different than on server, the flag does not affect
+                // game state.
+                copy.peep.WindowInvalidateFlags = 0;
             }
         }
+    }
+    return sprites;
+}
+
+rct_sprite_checksum sprite_checksum(const std::vector<rct_sprite>& sprites)
+{
+    using namespace Crypt;
 
-        checksum.raw = _spriteHashAlg->Finish();
+    rct_sprite_checksum checksum;
+
+    try
+    {
+        // Not shared so the checksum of a captured state can be computed on any thread.
+        auto spriteHashAlg = CreateSHA1();
+        spriteHashAlg->Update(sprites.data(), sprites.size() * sizeof(rct_sprite));
+        checksum.raw = spriteHashAlg->Finish();
     }
     catch (std::exception& e)
     {
@@ -320,8 +317,23 @@ rct_sprite_checksum sprite_checksum()
 
     return checksum;
 }
+
+rct_sprite_checksum sprite_checksum()
+{
+    return sprite_checksum(sprite_checksum_capture());
+}
 #else
 
+std::vector<rct_sprite> sprite_checksum_capture()
+{
+    return {};
+}
+
+rct_sprite_checksum sprite_checksum([[maybe_unused]] const std::vector<rct_sprite>& sprites)
+{
+    return rct_sprite_checksum{};
+}
+
 rct_sprite_checksum sprite_checksum()
 {
     return rct_sprite_checksum{};
@@ -16,6 +16,8 @@
 #include "Fountain.h"
 #include "SpriteBase.h"
 
+#include <vector>
+
 #define SPRITE_INDEX_NULL 0xFFFF
 #define MAX_SPRITES 10000
 
@@ -266,6 +268,12 @@ void crash_splash_create(const CoordsXYZ& splashPos);
 
 rct_sprite_checksum sprite_checksum();
 
+/**
+ * Copies the entities that make up the sprite checksum, the copy can be hashed with sprite_checksum on another thread.
+ */
+std::vector<rct_sprite> sprite_checksum_capture();
+rct_sprite_checksum sprite_checksum(const std::vector<rct_sprite>& sprites);
+
 void sprite_set_flashing(SpriteBase* sprite, bool flashing);
 bool sprite_get_flashing(SpriteBase* sprite);
 int32_t check_for_sprite_list_cycles(bool fix);
@@ -0,0 +1,153 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <openrct2/core/File.h>
+#include <openrct2/core/FileIndex.hpp>
+#include <openrct2/core/FileSystem.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct TestIndexItem
+{
+    std::string Path;
+    std::string Content;
+};
+
+// Indexes the content of text files, files starting with "skip" do not produce an item
+class TestFileIndex final : public FileIndex<TestIndexItem>
+{
+public:
+    mutable std::atomic<size_t> CreateCount{ 0 };
+
+    TestFileIndex(const std::string& indexPath, const std::string& directory)
+        : FileIndex("test index", 0x54534554, 1, indexPath, "*.txt", { directory })
+    {
+    }
+
+protected:
+    std::tuple<bool, TestIndexItem> Create(int32_t, const std::string& path) const override
+    {
+        CreateCount++;
+        auto data = File::ReadAllBytes(path);
+        TestIndexItem item;
+        item.Path = fs::u8path(path).filename().u8string();
+        item.Content = std::string(data.begin(), data.end());
+        return std::make_tuple(item.Content.rfind("skip", 0) != 0, item);
+    }
+
+    void Serialise(OpenRCT2::IStream* stream, const TestIndexItem& item) const override
+    {
+        stream->WriteString(item.Path);
+        stream->WriteString(item.Content);
+    }
+
+    TestIndexItem Deserialise(OpenRCT2::IStream* stream) const override
+    {
+        TestIndexItem item;
+        item.Path = stream->ReadStdString();
+        item.Content = stream->ReadStdString();
+        return item;
+    }
+};
+
+class FileIndexTest : public testing::Test
+{
+protected:
+    fs::path _directory;
+    std::string _indexPath;
+
+    void SetUp() override
+    {
+        _directory = fs::temp_directory_path() / "openrct2_file_index_test";
+        fs::remove_all(_directory);
+        fs::create_directories(_directory / "files");
+        _indexPath = (_directory / "test.idx").u8string();
+    }
+
+    void TearDown() override
+    {
+        fs::remove_all(_directory);
+    }
+
+    std::string GetFilesDirectory() const
+    {
+        return (_directory / "files").u8string();
+    }
+
+    void WriteFile(const std::string& name, const std::string& content)
+    {
+        File::WriteAllBytes((_directory / "files" / name).u8string(), content.data(), content.size());
+    }
+
+    static std::vector<std::pair<std::string, std::string>> GetItems(const std::vector<TestIndexItem>& items)
+    {
+        std::vector<std::pair<std::string, std::string>> result;
+        for (const auto& item : items)
+        {
+            result.emplace_back(item.Path, item.Content);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+};
+
+TEST_F(FileIndexTest, incremental_rebuild)
+{
+    using Items = std::vector<std::pair<std::string, std::string>>;
+
+    WriteFile("a.txt", "alpha");
+    WriteFile("b.txt", "beta");
+    WriteFile("c.txt", "skip");
+    WriteFile("d.txt", "delta");
+
+    {
+        TestFileIndex index(_indexPath, GetFilesDirectory());
+        auto items = index.LoadOrBuild(0);
+        ASSERT_EQ(GetItems(items), (Items{ { "a.txt", "alpha" }, { "b.txt", "beta" }, { "d.txt", "delta" } }));
+        ASSERT_EQ(index.CreateCount.load(), 4U);
+    }
+
+    {
+        // Nothing changed, everything comes from the index
+        TestFileIndex index(_indexPath, GetFilesDirectory());
+        auto items = index.LoadOrBuild(0);
+        ASSERT_EQ(GetItems(items), (Items{ { "a.txt", "alpha" }, { "b.txt", "beta" }, { "d.txt", "delta" } }));
+        ASSERT_EQ(index.CreateCount.load(), 0U);
+    }
+
+    // Add a file, change one in size and one only in its modification time and delete another
+    WriteFile("e.txt", "epsilon");
+    WriteFile("a.txt", "alpha 2");
+    auto dPath = _directory / "files" / "d.txt";
+    auto dLastWriteTime = fs::last_write_time(dPath);
+    WriteFile("d.txt", "DELTA");
+    fs::last_write_time(dPath, dLastWriteTime + std::chrono::seconds(10));
+    fs::remove(_directory / "files" / "b.txt");
+
+    {
+        TestFileIndex index(_indexPath, GetFilesDirectory());
+        auto items = index.LoadOrBuild(0);
+        ASSERT_EQ(GetItems(items), (Items{ { "a.txt", "alpha 2" }, { "d.txt", "DELTA" }, { "e.txt", "epsilon" } }));
+
+        // Only the added and changed files are loaded again, the skipped file is not
+        ASSERT_EQ(index.CreateCount.load(), 3U);
+    }
+
+    {
+        TestFileIndex index(_indexPath, GetFilesDirectory());
+        auto items = index.LoadOrBuild(0);
+        ASSERT_EQ(GetItems(items), (Items{ { "a.txt", "alpha 2" }, { "d.txt", "DELTA" }, { "e.txt", "epsilon" } }));
+        ASSERT_EQ(index.CreateCount.load(), 0U);
+    }
+}
@@ -0,0 +1,145 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <gtest/gtest.h>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/GameState.h>
+#include <openrct2/GameStateSnapshots.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/ParkImporter.h>
+#include <openrct2/core/DataSerialiser.h>
+#include <openrct2/core/MemoryStream.h>
+#include <openrct2/object/ObjectManager.h>
+#include <openrct2/peep/Peep.h>
+#include <openrct2/platform/platform.h>
+#include <openrct2/scenario/Scenario.h>
+#include <openrct2/world/Sprite.h>
+
+using namespace OpenRCT2;
+
+class GameStateResyncTests : public testing::Test
+{
+protected:
+    static void SetUpTestCase()
+    {
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = true;
+        core_init();
+    }
+
+    void SetUp() override
+    {
+        _context = CreateContext();
+        ASSERT_NE(_context, nullptr);
+        ASSERT_TRUE(_context->Initialise());
+
+        std::string testParkPath = TestData::GetParkPath("BigMapTest.sv6");
+        auto importer = ParkImporter::CreateS6(_context->GetObjectRepository());
+        auto loadResult = importer->Load(testParkPath.c_str());
+        _context->GetObjectManager().LoadObjects(loadResult.RequiredObjects.data(), loadResult.RequiredObjects.size());
+        importer->Import();
+        game_fix_save_vars();
+
+        auto* gameState = _context->GetGameState();
+        for (uint32_t i = 0; i < 100; i++)
+        {
+            gameState->UpdateLogic();
+        }
+    }
+
+    void TearDown() override
+    {
+        _context = nullptr;
+    }
+
+    std::unique_ptr<IContext> _context;
+};
+
+TEST_F(GameStateResyncTests, DeltaRestoresDivergedEntities)
+{
+    IGameStateSnapshots* snapshots = _context->GetGameStateSnapshots();
+
+    // The state the server would have for this tick.
+    auto& serverSnapshot = snapshots->CreateSnapshot();
+    snapshots->Capture(serverSnapshot);
+    snapshots->LinkSnapshot(serverSnapshot, gCurrentTicks, scenario_rand_state().s0);
+    const auto serverRandState = scenario_rand_state();
+    const auto serverPeepCount = GetEntityListCount(EntityListId::Peep);
+    auto serverHashes = snapshots->GetSpriteRangeHashes(serverSnapshot);
+
+    // Let the local state diverge in a few entities and the random state.
+    auto guests = EntityList<Guest>(EntityListId::Peep);
+    auto it = guests.begin();
+    ASSERT_NE(it, guests.end());
+    Guest* guest = *it;
+    guest->Energy++;
+    guest->MoveTo({ guest->x + 32, guest->y, guest->z });
+    ++it;
+    if (it != guests.end())
+    {
+        sprite_remove(*it);
+    }
+    scenario_rand();
+
+    auto& clientSnapshot = snapshots->CreateSnapshot();
+    snapshots->Capture(clientSnapshot);
+    auto clientHashes = snapshots->GetSpriteRangeHashes(clientSnapshot);
+    ASSERT_NE(clientHashes, serverHashes);
+
+    // The client sends its hashes, the server answers with the ranges that differ.
+    MemoryStream deltaStream;
+    {
+        DataSerialiser ds(true, deltaStream);
+        snapshots->SerialiseDelta(serverSnapshot, clientHashes, ds);
+    }
+
+    size_t numRanges = 0;
+    for (size_t i = 0; i < serverHashes.size(); i++)
+    {
+        if (serverHashes[i] != clientHashes[i])
+            numRanges++;
+    }
+    ASSERT_GT(numRanges, 0U);
+    ASSERT_LT(numRanges, serverHashes.size());
+
+    deltaStream.SetPosition(0);
+    {
+        DataSerialiser ds(false, deltaStream);
+        ASSERT_EQ(snapshots->ApplyDelta(ds), numRanges);
+    }
+
+    auto& patchedSnapshot = snapshots->CreateSnapshot();
+    snapshots->Capture(patchedSnapshot);
+    ASSERT_EQ(snapshots->GetSpriteRangeHashes(patchedSnapshot), serverHashes);
+    ASSERT_EQ(scenario_rand_state().s0, serverRandState.s0);
+    ASSERT_EQ(scenario_rand_state().s1, serverRandState.s1);
+    ASSERT_EQ(GetEntityListCount(EntityListId::Peep), serverPeepCount);
+}
+
+TEST_F(GameStateResyncTests, EqualStateProducesNoRanges)
+{
+    IGameStateSnapshots* snapshots = _context->GetGameStateSnapshots();
+
+    auto& snapshot = snapshots->CreateSnapshot();
+    snapshots->Capture(snapshot);
+    auto hashes = snapshots->GetSpriteRangeHashes(snapshot);
+
+    MemoryStream deltaStream;
+    {
+        DataSerialiser ds(true, deltaStream);
+        snapshots->SerialiseDelta(snapshot, hashes, ds);
+    }
+
+    deltaStream.SetPosition(0);
+    DataSerialiser ds(false, deltaStream);
+    ASSERT_EQ(snapshots->ApplyDelta(ds), 0U);
+}
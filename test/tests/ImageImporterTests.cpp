@@ -12,6 +12,8 @@
 #include <gtest/gtest.h>
 #include <openrct2/core/Path.hpp>
 #include <openrct2/drawing/ImageImporter.h>
+#include <openrct2/util/Util.h>
+#include <random>
 #include <string_view>
 
 using namespace OpenRCT2::Drawing;
@@ -56,3 +58,27 @@ TEST_F(ImageImporterTests, Import_Logo)
     auto hash = GetHash(result.Buffer.data(), result.Buffer.size());
     ASSERT_EQ(0xCEF27C7D, hash);
 }
+
+TEST_F(ImageImporterTests, PaletteSearch_VectorisedMatchesScalar)
+{
+    if (!sse41_available())
+        return;
+
+    // Dithering can push the channels outside of 0 to 255
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<int32_t> channel(-300, 600);
+    for (int32_t i = 0; i < 100000; i++)
+    {
+        int16_t colour[4] = { static_cast<int16_t>(channel(rng)), static_cast<int16_t>(channel(rng)),
+                              static_cast<int16_t>(channel(rng)), 255 };
+        if (i < PALETTE_SIZE)
+        {
+            colour[0] = StandardPalette[i].Red;
+            colour[1] = StandardPalette[i].Green;
+            colour[2] = StandardPalette[i].Blue;
+        }
+        ASSERT_EQ(image_importer_get_palette_index_scalar(colour), image_importer_get_palette_index_sse4_1(colour));
+        ASSERT_EQ(
+            image_importer_get_closest_palette_index_scalar(colour), image_importer_get_closest_palette_index_sse4_1(colour));
+    }
+}
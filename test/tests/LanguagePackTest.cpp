@@ -77,6 +77,35 @@ TEST_F(LanguagePackTest, language_pack_multibyte)
     delete lang;
 }
 
+TEST_F(LanguagePackTest, language_pack_compiled)
+{
+    auto data = LanguagePackFactory::CompileFromText(0, LanguageEnGB, 1234);
+    ASSERT_EQ(LanguagePackFactory::FromCompiled(0, data, 1235), nullptr);
+    ASSERT_EQ(LanguagePackFactory::FromCompiled(1, data, 1234), nullptr);
+
+    ILanguagePack* lang = LanguagePackFactory::FromCompiled(0, data, 1234);
+    ASSERT_NE(lang, nullptr);
+    ASSERT_EQ(lang->GetId(), 0);
+    ASSERT_EQ(lang->GetCount(), 4U);
+    ASSERT_STREQ(lang->GetString(2), "Spiral Roller Coaster");
+    ASSERT_EQ(lang->GetScenarioOverrideStringId("Arid Heights", 0), 0x7000);
+    ASSERT_STREQ(lang->GetString(0x7000), "Arid Heights scenario string");
+    ASSERT_EQ(lang->GetObjectOverrideStringId("CONDORRD", 0), 0x6000);
+    ASSERT_STREQ(lang->GetString(0x6000), "my test ride");
+    ASSERT_EQ(lang->GetString(1000), nullptr);
+    ASSERT_EQ(lang->GetScenarioOverrideStringId("No such park", 0), STR_NONE);
+    ASSERT_EQ(lang->GetObjectOverrideStringId("        ", 0), STR_NONE);
+    lang->SetString(2, "xx");
+    ASSERT_STREQ(lang->GetString(2), "xx");
+    lang->RemoveString(2);
+    ASSERT_EQ(lang->GetString(2), nullptr);
+    delete lang;
+
+    // A truncated pack is rejected
+    data.pop_back();
+    ASSERT_EQ(LanguagePackFactory::FromCompiled(0, data, 1234), nullptr);
+}
+
 const utf8* LanguagePackTest::LanguageEnGB = "# STR_XXXX part is read and XXXX becomes the string id number.\n"
                                              "# Everything after the colon and before the new line will be saved as the "
                                              "string.\n"
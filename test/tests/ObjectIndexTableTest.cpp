@@ -0,0 +1,210 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <cstring>
+#include <deque>
+#include <gtest/gtest.h>
+#include <openrct2/core/File.h>
+#include <openrct2/core/FileSystem.hpp>
+#include <openrct2/object/ObjectIndexTable.h>
+#include <string>
+#include <vector>
+
+class ObjectIndexTableTest : public testing::Test
+{
+protected:
+    static constexpr uint64_t SCAN_CHECKSUM = 0x0123456789ABCDEF;
+
+    std::string _path;
+    std::deque<ObjectRepositoryItem> _items;
+
+    void SetUp() override
+    {
+        _path = (fs::temp_directory_path() / "openrct2_object_index_table_test.idxmap").u8string();
+
+        auto& ride = _items.emplace_back();
+        ride.ObjectEntry = CreateEntry(OBJECT_TYPE_RIDE, "RCT2    ");
+        ride.Path = "/objects/rct2.dat";
+        ride.Name = "Wooden Roller Coaster";
+        ride.Authors = { "Chris Sawyer" };
+        ride.Sources = { ObjectSourceGame::RCT2 };
+        ride.RideInfo.RideFlags = 3;
+        ride.RideInfo.RideCategory[0] = 2;
+        ride.RideInfo.RideCategory[1] = 4;
+        ride.RideInfo.RideType[0] = 52;
+        ride.RideInfo.RideType[1] = 255;
+        ride.RideInfo.RideType[2] = 255;
+
+        auto& group = _items.emplace_back();
+        group.ObjectEntry = CreateEntry(OBJECT_TYPE_SCENERY_GROUP, "SCGTREES");
+        group.Path = "/objects/scgtrees.dat";
+        group.Name = "Trees";
+        group.Authors = { "Chris Sawyer", "OpenRCT2 developers" };
+        group.Sources = { ObjectSourceGame::RCT2, ObjectSourceGame::WackyWorlds };
+        group.SceneryGroupInfo.Entries = { CreateEntry(OBJECT_TYPE_SMALL_SCENERY, "TCF     "),
+                                           CreateEntry(OBJECT_TYPE_SMALL_SCENERY, "TRF     ") };
+
+        auto& path = _items.emplace_back();
+        path.ObjectEntry = CreateEntry(OBJECT_TYPE_PATHS, "TARMAC  ");
+        path.Path = "/objects/tarmac.dat";
+        path.Name = "Tarmac Footpath";
+    }
+
+    void TearDown() override
+    {
+        File::Delete(_path);
+    }
+
+    static rct_object_entry CreateEntry(uint8_t type, const char* name)
+    {
+        rct_object_entry entry{};
+        entry.flags = type;
+        std::memcpy(entry.name, name, sizeof(entry.name));
+        entry.checksum = 0xAABBCCDD;
+        return entry;
+    }
+
+    static void AssertItemsEqual(const ObjectRepositoryItem& expected, const ObjectRepositoryItem& actual)
+    {
+        ASSERT_EQ(std::memcmp(&expected.ObjectEntry, &actual.ObjectEntry, sizeof(rct_object_entry)), 0);
+        ASSERT_EQ(expected.Path, actual.Path);
+        ASSERT_EQ(expected.Name, actual.Name);
+        ASSERT_EQ(expected.Authors, actual.Authors);
+        ASSERT_EQ(expected.Sources, actual.Sources);
+        ASSERT_EQ(expected.SceneryGroupInfo.Entries.size(), actual.SceneryGroupInfo.Entries.size());
+        for (size_t i = 0; i < expected.SceneryGroupInfo.Entries.size(); i++)
+        {
+            ASSERT_EQ(
+                std::memcmp(
+                    &expected.SceneryGroupInfo.Entries[i], &actual.SceneryGroupInfo.Entries[i], sizeof(rct_object_entry)),
+                0);
+        }
+        if (expected.ObjectEntry.GetType() == OBJECT_TYPE_RIDE)
+        {
+            ASSERT_EQ(std::memcmp(&expected.RideInfo, &actual.RideInfo, sizeof(expected.RideInfo)), 0);
+        }
+    }
+
+    // Reading every item of a table that opened must stay within the file, even if the file is damaged
+    static void ReadAllItems(const ObjectIndexTable& table)
+    {
+        for (size_t i = 0; i < table.GetNumItems(); i++)
+        {
+            ObjectRepositoryItem item{};
+            table.ReadItem(i, item);
+            table.Find(item.ObjectEntry);
+        }
+    }
+};
+
+TEST_F(ObjectIndexTableTest, write_open_read)
+{
+    ObjectIndexTable::Write(_path, SCAN_CHECKSUM, _items);
+    auto table = ObjectIndexTable::Open(_path, SCAN_CHECKSUM);
+    ASSERT_NE(table, nullptr);
+    ASSERT_EQ(table->GetNumItems(), _items.size());
+
+    for (size_t i = 0; i < _items.size(); i++)
+    {
+        auto index = table->Find(_items[i].ObjectEntry);
+        ASSERT_TRUE(index.has_value());
+        ASSERT_EQ(*index, i);
+
+        ObjectRepositoryItem item{};
+        table->ReadItem(*index, item);
+        AssertItemsEqual(_items[i], item);
+    }
+
+    ASSERT_FALSE(table->Find(CreateEntry(OBJECT_TYPE_RIDE, "MISSING ")).has_value());
+}
+
+TEST_F(ObjectIndexTableTest, empty)
+{
+    ObjectIndexTable::Write(_path, SCAN_CHECKSUM, {});
+    auto table = ObjectIndexTable::Open(_path, SCAN_CHECKSUM);
+    ASSERT_NE(table, nullptr);
+    ASSERT_EQ(table->GetNumItems(), 0U);
+    ASSERT_FALSE(table->Find(_items[0].ObjectEntry).has_value());
+}
+
+TEST_F(ObjectIndexTableTest, missing_or_stale)
+{
+    ASSERT_EQ(ObjectIndexTable::Open(_path, SCAN_CHECKSUM), nullptr);
+
+    ObjectIndexTable::Write(_path, SCAN_CHECKSUM, _items);
+    ASSERT_EQ(ObjectIndexTable::Open(_path, SCAN_CHECKSUM + 1), nullptr);
+}
+
+TEST_F(ObjectIndexTableTest, truncated)
+{
+    ObjectIndexTable::Write(_path, SCAN_CHECKSUM, _items);
+    auto data = File::ReadAllBytes(_path);
+    for (size_t length = 0; length < data.size(); length++)
+    {
+        File::WriteAllBytes(_path, data.data(), length);
+        ASSERT_EQ(ObjectIndexTable::Open(_path, SCAN_CHECKSUM), nullptr) << "length " << length;
+    }
+
+    // Trailing data is as wrong as missing data
+    data.push_back(0);
+    File::WriteAllBytes(_path, data.data(), data.size());
+    ASSERT_EQ(ObjectIndexTable::Open(_path, SCAN_CHECKSUM), nullptr);
+}
+
+TEST_F(ObjectIndexTableTest, corrupt)
+{
+    ObjectIndexTable::Write(_path, SCAN_CHECKSUM, _items);
+    auto data = File::ReadAllBytes(_path);
+
+    // Damaged magic number
+    auto corrupt = data;
+    corrupt[0] ^= 0xFF;
+    File::WriteAllBytes(_path, corrupt.data(), corrupt.size());
+    ASSERT_EQ(ObjectIndexTable::Open(_path, SCAN_CHECKSUM), nullptr);
+
+    // Tables with any byte damaged are either rejected or only hold offsets within the file
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        for (uint8_t value : { uint8_t{ 0x00 }, uint8_t{ 0x7F }, uint8_t{ 0xFF } })
+        {
+            corrupt = data;
+            corrupt[i] = value;
+            File::WriteAllBytes(_path, corrupt.data(), corrupt.size());
+            auto table = ObjectIndexTable::Open(_path, SCAN_CHECKSUM);
+            if (table != nullptr)
+            {
+                ReadAllItems(*table);
+            }
+        }
+    }
+}
+
+// Windows does not allow replacing a file while it is mapped, writing the table fails there instead
+#ifndef _WIN32
+TEST_F(ObjectIndexTableTest, replace_while_mapped)
+{
+    ObjectIndexTable::Write(_path, SCAN_CHECKSUM, _items);
+    auto table = ObjectIndexTable::Open(_path, SCAN_CHECKSUM);
+    ASSERT_NE(table, nullptr);
+
+    // Another instance writing a new table must not change the one that is already mapped
+    ObjectIndexTable::Write(_path, SCAN_CHECKSUM + 1, { _items[2] });
+    ASSERT_EQ(table->GetNumItems(), _items.size());
+    for (size_t i = 0; i < _items.size(); i++)
+    {
+        ObjectRepositoryItem item{};
+        table->ReadItem(i, item);
+        AssertItemsEqual(_items[i], item);
+    }
+
+    auto newTable = ObjectIndexTable::Open(_path, SCAN_CHECKSUM + 1);
+    ASSERT_NE(newTable, nullptr);
+    ASSERT_EQ(newTable->GetNumItems(), 1U);
+}
+#endif
@@ -0,0 +1,131 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <openrct2/drawing/Drawing.h>
+#include <openrct2/sprites.h>
+#include <random>
+#include <vector>
+
+class RLESpriteTests : public testing::Test
+{
+protected:
+    static constexpr uint8_t BACKGROUND = 0x55;
+
+    std::mt19937 _random{ 0x52C1E };
+
+    void SetUp() override
+    {
+        rle_init();
+        gfx_rle_lod_clear();
+    }
+
+    int32_t Random(int32_t min, int32_t max)
+    {
+        return std::uniform_int_distribution<int32_t>(min, max)(_random);
+    }
+
+    // Builds an RLE sprite with random runs, with some transparent pixels inside the runs as well
+    std::vector<uint8_t> CreateSprite(int32_t width, int32_t height)
+    {
+        std::vector<uint8_t> data(height * 2);
+        for (int32_t y = 0; y < height; y++)
+        {
+            auto lineOffset = static_cast<uint16_t>(data.size());
+            data[y * 2] = lineOffset & 0xFF;
+            data[y * 2 + 1] = lineOffset >> 8;
+
+            int32_t x = Random(0, 8);
+            size_t lastRun = data.size();
+            while (x < width)
+            {
+                auto length = std::min(Random(1, 40), width - x);
+                lastRun = data.size();
+                data.push_back(static_cast<uint8_t>(length));
+                data.push_back(static_cast<uint8_t>(x));
+                for (int32_t i = 0; i < length; i++)
+                {
+                    data.push_back(Random(0, 7) == 0 ? 0 : static_cast<uint8_t>(Random(1, 255)));
+                }
+                x += length + Random(1, 12);
+            }
+            if (lastRun == data.size())
+            {
+                // Empty line
+                data.push_back(0);
+                data.push_back(0);
+            }
+            data[lastRun] |= 0x80;
+        }
+        return data;
+    }
+
+    static std::vector<uint8_t> Draw(
+        const rct_g1_element& g1, ImageId image, int32_t zoomLevel, int32_t srcX, int32_t srcY, const PaletteMap& paletteMap)
+    {
+        auto zoom = 1 << zoomLevel;
+        auto bufferWidth = (g1.width >> zoomLevel) + 2;
+        auto bufferHeight = (g1.height >> zoomLevel) + 2;
+        std::vector<uint8_t> buffer(bufferWidth * bufferHeight, BACKGROUND);
+
+        rct_drawpixelinfo dpi{};
+        dpi.bits = buffer.data();
+        dpi.width = bufferWidth * zoom;
+        dpi.height = bufferHeight * zoom;
+        dpi.zoom_level = zoomLevel;
+
+        DrawSpriteArgs args(&dpi, image, paletteMap, g1, srcX, srcY, g1.width - srcX, g1.height - srcY, buffer.data());
+        gfx_rle_sprite_to_buffer(args);
+        return buffer;
+    }
+};
+
+TEST_F(RLESpriteTests, ReducedMatchesMinify)
+{
+    uint8_t remap[256];
+    for (int32_t i = 0; i < 256; i++)
+    {
+        remap[i] = static_cast<uint8_t>(255 - i);
+    }
+    PaletteMap remapPaletteMap(remap);
+
+    for (uint32_t spriteIndex = 0; spriteIndex < 40; spriteIndex++)
+    {
+        auto width = Random(1, 200);
+        auto height = Random(1, 100);
+        auto data = CreateSprite(width, height);
+        rct_g1_element g1{};
+        g1.offset = data.data();
+        g1.width = width;
+        g1.height = height;
+        g1.flags = G1_FLAG_RLE_COMPRESSION;
+
+        // SPR_TEMP is never cached, so it is always drawn from the full resolution data
+        auto cachedIndex = 1000 + spriteIndex;
+        for (int32_t zoomLevel = 1; zoomLevel <= 3; zoomLevel++)
+        {
+            auto zoom = 1 << zoomLevel;
+            for (int32_t srcY = 0; srcY < std::min(height, zoom * 2); srcY++)
+            {
+                for (int32_t srcX = 0; srcX < std::min(width, zoom * 2); srcX++)
+                {
+                    auto expected = Draw(g1, ImageId(SPR_TEMP), zoomLevel, srcX, srcY, PaletteMap::GetDefault());
+                    auto actual = Draw(g1, ImageId(cachedIndex), zoomLevel, srcX, srcY, PaletteMap::GetDefault());
+                    ASSERT_EQ(expected, actual) << "sprite " << spriteIndex << " zoom " << zoom << " src " << srcX << ","
+                                                << srcY;
+
+                    expected = Draw(g1, ImageId(SPR_TEMP, 1), zoomLevel, srcX, srcY, remapPaletteMap);
+                    actual = Draw(g1, ImageId(cachedIndex, 1), zoomLevel, srcX, srcY, remapPaletteMap);
+                    ASSERT_EQ(expected, actual) << "remapped sprite " << spriteIndex << " zoom " << zoom << " src " << srcX
+                                                << "," << srcY;
+                }
+            }
+        }
+    }
+}
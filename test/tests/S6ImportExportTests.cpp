@@ -15,11 +15,13 @@
 #include <openrct2/Game.h>
 #include <openrct2/GameState.h>
 #include <openrct2/OpenRCT2.h>
+#include <openrct2/ParkFile.h>
 #include <openrct2/ParkImporter.h>
 #include <openrct2/audio/AudioContext.h>
 #include <openrct2/config/Config.h>
 #include <openrct2/core/Crypt.h>
 #include <openrct2/core/File.h>
+#include <openrct2/core/FileSystem.hpp>
 #include <openrct2/core/MemoryStream.h>
 #include <openrct2/core/Path.hpp>
 #include <openrct2/core/String.hpp>
@@ -91,12 +93,13 @@ static bool ImportSave(MemoryStream& stream, std::unique_ptr<IContext>& context,
     return true;
 }
 
-static bool ExportSave(MemoryStream& stream, std::unique_ptr<IContext>& context)
+static bool ExportSave(MemoryStream& stream, std::unique_ptr<IContext>& context, bool useParkFile = false)
 {
     auto& objManager = context->GetObjectManager();
 
     auto exporter = std::make_unique<S6Exporter>();
     exporter->ExportObjectsList = objManager.GetPackableObjects();
+    exporter->UseParkFile = useParkFile;
     exporter->Export();
     exporter->SaveGame(&stream);
 
@@ -569,6 +572,157 @@ TEST(S6ImportExportAdvanceTicks, all)
     SUCCEED();
 }
 
+TEST(S6ImportExportParkFile, all)
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    core_init();
+
+    MemoryStream importBuffer;
+    MemoryStream exportBuffer;
+
+    std::unique_ptr<GameState_t> importedState;
+    std::unique_ptr<GameState_t> exportedState;
+
+    // Load initial park data.
+    {
+        std::unique_ptr<IContext> context = CreateContext();
+        EXPECT_NE(context, nullptr);
+
+        bool initialised = context->Initialise();
+        ASSERT_TRUE(initialised);
+
+        std::string testParkPath = TestData::GetParkPath("BigMapTest.sv6");
+        ASSERT_TRUE(LoadFileToBuffer(importBuffer, testParkPath));
+        ASSERT_TRUE(ImportSave(importBuffer, context, false));
+        importedState = GetGameState(context);
+        ASSERT_NE(importedState, nullptr);
+
+        ASSERT_TRUE(ExportSave(exportBuffer, context, true));
+    }
+
+    // Import the park file.
+    {
+        std::unique_ptr<IContext> context = CreateContext();
+        EXPECT_NE(context, nullptr);
+
+        bool initialised = context->Initialise();
+        ASSERT_TRUE(initialised);
+
+        exportBuffer.SetPosition(0);
+        ASSERT_TRUE(ParkFileReader::IsParkFile(&exportBuffer));
+        ASSERT_TRUE(ImportSave(exportBuffer, context, true));
+
+        exportedState = GetGameState(context);
+        ASSERT_NE(exportedState, nullptr);
+    }
+
+    CompareStates(importBuffer, exportBuffer, importedState, exportedState);
+
+    SUCCEED();
+}
+
+TEST(S6ImportExportParkFileDelta, all)
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    core_init();
+
+    auto directory = fs::temp_directory_path() / "openrct2_delta_test";
+    fs::create_directories(directory);
+    auto basePath = (directory / "base.park").u8string();
+    auto deltaPath = (directory / "autosave.park").u8string();
+    auto traversalPath = (directory / "autosave_traversal.park").u8string();
+
+    MemoryStream importBuffer;
+    MemoryStream deltaBuffer;
+
+    std::unique_ptr<GameState_t> importedState;
+    std::unique_ptr<GameState_t> exportedState;
+
+    // Save a base, change the park and save the changes as a delta against the base.
+    {
+        std::unique_ptr<IContext> context = CreateContext();
+        EXPECT_NE(context, nullptr);
+
+        bool initialised = context->Initialise();
+        ASSERT_TRUE(initialised);
+
+        std::string testParkPath = TestData::GetParkPath("BigMapTest.sv6");
+        ASSERT_TRUE(LoadFileToBuffer(importBuffer, testParkPath));
+        ASSERT_TRUE(ImportSave(importBuffer, context, false));
+
+        auto& objManager = context->GetObjectManager();
+        auto baseExporter = std::make_unique<S6Exporter>();
+        baseExporter->ExportObjectsList = objManager.GetPackableObjects();
+        baseExporter->UseParkFile = true;
+        baseExporter->Export();
+        baseExporter->SaveGame(basePath.c_str());
+
+        AdvanceGameTicks(1000, context);
+
+        auto deltaExporter = std::make_unique<S6Exporter>();
+        deltaExporter->ExportObjectsList = objManager.GetPackableObjects();
+        deltaExporter->UseParkFile = true;
+        deltaExporter->DeltaBase = baseExporter->GetParkFile();
+        deltaExporter->DeltaBasePath = "base.park";
+        deltaExporter->Export();
+        deltaExporter->SaveGame(deltaPath.c_str());
+        EXPECT_LT(deltaExporter->GetDeltaLength(), baseExporter->GetParkFile()->GetLength());
+
+        deltaExporter->DeltaBasePath = "../openrct2_delta_test/base.park";
+        deltaExporter->SaveGame(traversalPath.c_str());
+
+        importedState = GetGameState(context);
+        ASSERT_NE(importedState, nullptr);
+    }
+
+    // Load the delta, which reads the unchanged parts from the base.
+    {
+        std::unique_ptr<IContext> context = CreateContext();
+        EXPECT_NE(context, nullptr);
+
+        bool initialised = context->Initialise();
+        ASSERT_TRUE(initialised);
+
+        ASSERT_TRUE(File::Exists(deltaPath));
+        auto deltaData = File::ReadAllBytes(deltaPath);
+        deltaBuffer.Write(deltaData.data(), deltaData.size());
+        deltaBuffer.SetPosition(0);
+        ASSERT_TRUE(ParkFileReader(&deltaBuffer).IsDelta());
+
+        auto& objManager = context->GetObjectManager();
+        auto importer = ParkImporter::CreateS6(context->GetObjectRepository());
+        auto loadResult = importer->LoadSavedGame(deltaPath.c_str());
+        objManager.LoadObjects(loadResult.RequiredObjects.data(), loadResult.RequiredObjects.size());
+        importer->Import();
+        GameInit(true);
+
+        exportedState = GetGameState(context);
+        ASSERT_NE(exportedState, nullptr);
+    }
+
+    CompareStates(importBuffer, deltaBuffer, importedState, exportedState);
+
+    // A delta may only refer to a base in its own directory, even when the path leads back to a valid base.
+    {
+        std::unique_ptr<IContext> context = CreateContext();
+        EXPECT_NE(context, nullptr);
+
+        bool initialised = context->Initialise();
+        ASSERT_TRUE(initialised);
+
+        auto importer = ParkImporter::CreateS6(context->GetObjectRepository());
+        EXPECT_THROW(importer->LoadSavedGame(traversalPath.c_str()), std::exception);
+    }
+
+    fs::remove_all(directory);
+
+    SUCCEED();
+}
+
 TEST(SeaDecrypt, DecryptSea)
 {
     auto path = TestData::GetParkPath("volcania.sea");
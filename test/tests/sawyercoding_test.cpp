@@ -7,10 +7,16 @@
  * OpenRCT2 is licensed under the GNU General Public License version 3.
  *****************************************************************************/
 
+#include <chrono>
+#include <cstdio>
 #include <gtest/gtest.h>
 #include <openrct2/core/MemoryStream.h>
 #include <openrct2/rct12/SawyerChunkReader.h>
 #include <openrct2/util/SawyerCoding.h>
+#include <openrct2/util/Util.h>
+#include <random>
+#include <string>
+#include <vector>
 
 constexpr size_t BUFFER_SIZE = 0x600000;
 
@@ -45,6 +51,46 @@ protected:
         delete[] encodedDataBuffer;
     }
 
+    // Runs of repeated bytes, short repeating patterns and noise, roughly like the tile and sprite data of a park
+    static std::vector<uint8_t> create_park_like_data(size_t size)
+    {
+        std::mt19937 rng(1234);
+        std::vector<uint8_t> data;
+        data.reserve(size);
+        while (data.size() < size)
+        {
+            size_t length = std::min<size_t>(1 + rng() % 300, size - data.size());
+            switch (rng() % 3)
+            {
+                case 0:
+                    data.insert(data.end(), length, static_cast<uint8_t>(rng()));
+                    break;
+                case 1:
+                {
+                    uint8_t pattern[4] = { static_cast<uint8_t>(rng()), static_cast<uint8_t>(rng()), 0, 0 };
+                    for (size_t i = 0; i < length; i++)
+                        data.push_back(pattern[i % 4]);
+                    break;
+                }
+                default:
+                    for (size_t i = 0; i < length; i++)
+                        data.push_back(static_cast<uint8_t>(rng()));
+                    break;
+            }
+        }
+        return data;
+    }
+
+    static std::vector<uint8_t> encode(const std::vector<uint8_t>& data, uint8_t encoding)
+    {
+        sawyercoding_chunk_header header;
+        header.encoding = encoding;
+        header.length = static_cast<uint32_t>(data.size());
+        std::vector<uint8_t> encoded(data.size() * 2 + sizeof(header));
+        encoded.resize(sawyercoding_write_chunk_buffer(encoded.data(), data.data(), header));
+        return encoded;
+    }
+
     void test_decode(const uint8_t* data, size_t size)
     {
         auto expectedLength = size - sizeof(sawyercoding_chunk_header);
@@ -106,6 +152,175 @@ TEST_F(SawyerCodingTest, decode_chunk_rotate)
     test_decode(rotatedata, sizeof(rotatedata));
 }
 
+TEST_F(SawyerCodingTest, decode_chunk_into_exact_buffer)
+{
+    std::vector<uint8_t> buffer(sizeof(randomdata));
+    OpenRCT2::MemoryStream ms(rlecompresseddata, sizeof(rlecompresseddata));
+    SawyerChunkReader reader(&ms);
+    reader.ReadChunk(buffer.data(), buffer.size());
+    ASSERT_EQ(memcmp(buffer.data(), randomdata, sizeof(randomdata)), 0);
+    ASSERT_EQ(ms.GetPosition(), sizeof(rlecompresseddata));
+}
+
+TEST_F(SawyerCodingTest, decode_chunks_async)
+{
+    OpenRCT2::MemoryStream ms;
+    ms.Write(rledata, sizeof(rledata));
+    ms.Write(rlecompresseddata, sizeof(rlecompresseddata));
+    ms.Write(rotatedata, sizeof(rotatedata));
+    ms.SetPosition(0);
+
+    // Destinations larger than the chunk are padded with zero, smaller ones are truncated
+    std::vector<uint8_t> exact(sizeof(randomdata));
+    std::vector<uint8_t> padded(sizeof(randomdata) + 64, 0xCC);
+    std::vector<uint8_t> truncated(sizeof(randomdata) / 2);
+
+    SawyerChunkReader reader(&ms);
+    auto job = reader.ReadChunksAsync({ { exact.data(), exact.size() },
+                                        { padded.data(), padded.size() },
+                                        { truncated.data(), truncated.size() } });
+    ASSERT_EQ(ms.GetPosition(), ms.GetLength());
+    job.get();
+
+    ASSERT_EQ(memcmp(exact.data(), randomdata, sizeof(randomdata)), 0);
+    ASSERT_EQ(memcmp(padded.data(), randomdata, sizeof(randomdata)), 0);
+    for (size_t i = sizeof(randomdata); i < padded.size(); i++)
+    {
+        ASSERT_EQ(padded[i], 0);
+    }
+    ASSERT_EQ(memcmp(truncated.data(), randomdata, truncated.size()), 0);
+}
+
+TEST_F(SawyerCodingTest, decode_chunks_async_corrupt)
+{
+    // A literal run of six bytes with only one byte of data left in the chunk
+    const uint8_t data[] = { CHUNK_ENCODING_RLE, 2, 0, 0, 0, 0x05, 0xAA };
+
+    OpenRCT2::MemoryStream ms(data, sizeof(data));
+    std::vector<uint8_t> buffer(sizeof(randomdata));
+    SawyerChunkReader reader(&ms);
+    auto job = reader.ReadChunksAsync({ { buffer.data(), buffer.size() } });
+    ASSERT_THROW(job.get(), IOException);
+}
+
+TEST_F(SawyerCodingTest, write_read_large_chunks)
+{
+    auto data = create_park_like_data(0x100000);
+    for (uint8_t encoding : { CHUNK_ENCODING_RLE, CHUNK_ENCODING_RLECOMPRESSED })
+    {
+        auto encoded = encode(data, encoding);
+        OpenRCT2::MemoryStream ms(encoded.data(), encoded.size());
+        SawyerChunkReader reader(&ms);
+        std::vector<uint8_t> decoded(data.size());
+        reader.ReadChunk(decoded.data(), decoded.size());
+        ASSERT_EQ(decoded, data);
+    }
+}
+
+TEST_F(SawyerCodingTest, vectorised_functions_match_scalar)
+{
+    if (!sse41_available())
+        return;
+
+    auto data = create_park_like_data(0x40000);
+    ASSERT_EQ(
+        sawyercoding_calculate_checksum_sse4_1(data.data(), data.size()),
+        sawyercoding_calculate_checksum_scalar(data.data(), data.size()));
+    for (size_t i = 0; i < data.size() - 130; i++)
+    {
+        ASSERT_EQ(sawyercoding_count_literals_sse4_1(&data[i], 126), sawyercoding_count_literals_scalar(&data[i], 126));
+        ASSERT_EQ(sawyercoding_count_repeats_sse4_1(&data[i], 125), sawyercoding_count_repeats_scalar(&data[i], 125));
+    }
+    for (size_t i = 1; i < data.size(); i++)
+    {
+        size_t scalarIndex;
+        size_t vectorIndex;
+        size_t scalarCount = sawyercoding_find_repeat_scalar(data.data(), data.size(), i, &scalarIndex);
+        size_t vectorCount = sawyercoding_find_repeat_sse4_1(data.data(), data.size(), i, &vectorIndex);
+        ASSERT_EQ(vectorCount, scalarCount);
+        if (scalarCount != 0)
+        {
+            ASSERT_EQ(vectorIndex, scalarIndex);
+        }
+    }
+
+    // The block decoder stops before the end of the buffers, the runs it did decode have to be complete
+    auto encoded = encode(data, CHUNK_ENCODING_RLE);
+    const uint8_t* rle = encoded.data() + sizeof(sawyercoding_chunk_header);
+    size_t rleLength = encoded.size() - sizeof(sawyercoding_chunk_header);
+    std::vector<uint8_t> decoded(data.size());
+    size_t srcRead;
+    size_t decodedLength = sawyercoding_decode_rle_blocks_sse4_1(rle, rleLength, decoded.data(), decoded.size(), &srcRead);
+    ASSERT_GT(decodedLength, data.size() / 2);
+    ASSERT_LE(srcRead, rleLength);
+    ASSERT_EQ(memcmp(decoded.data(), data.data(), decodedLength), 0);
+}
+
+TEST_F(SawyerCodingTest, vectorised_encoding_matches_scalar)
+{
+    if (!sse41_available())
+        return;
+
+    std::vector<uint8_t> randomData(0x10000);
+    std::mt19937 rng(5678);
+    for (auto& b : randomData)
+        b = static_cast<uint8_t>(rng());
+
+    for (const auto& data : { create_park_like_data(0x40000), randomData, std::vector<uint8_t>(0x10000, 0xAB) })
+    {
+        for (uint8_t encoding : { CHUNK_ENCODING_RLE, CHUNK_ENCODING_RLECOMPRESSED })
+        {
+            auto vectorised = encode(data, encoding);
+            gUseVectorisedSawyerCoding = false;
+            auto scalar = encode(data, encoding);
+            gUseVectorisedSawyerCoding = true;
+            ASSERT_EQ(vectorised, scalar) << "encoding " << static_cast<int32_t>(encoding);
+        }
+    }
+}
+
+// Prints the throughput of the scalar and SSE4.1 functions, run with --gtest_also_run_disabled_tests
+TEST_F(SawyerCodingTest, DISABLED_throughput)
+{
+    auto data = create_park_like_data(0x300000);
+    auto measure = [&data](const char* name, auto&& func) {
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::printf("%-40s %8.1f MiB/s\n", name, data.size() / elapsed / (1024 * 1024));
+    };
+
+    for (bool vectorised : { false, true })
+    {
+        if (vectorised && !sse41_available())
+            break;
+
+        gUseVectorisedSawyerCoding = vectorised;
+        const char* suffix = vectorised ? "SSE4.1" : "scalar";
+        std::string name;
+
+        volatile uint32_t checksum = 0;
+        name = std::string("checksum (") + suffix + ")";
+        measure(name.c_str(), [&]() { checksum = sawyercoding_calculate_checksum(data.data(), data.size()); });
+
+        std::vector<uint8_t> encoded;
+        name = std::string("encode rle (") + suffix + ")";
+        measure(name.c_str(), [&]() { encoded = encode(data, CHUNK_ENCODING_RLE); });
+        name = std::string("encode rle + repeat (") + suffix + ")";
+        measure(name.c_str(), [&]() { encoded = encode(data, CHUNK_ENCODING_RLECOMPRESSED); });
+
+        std::vector<uint8_t> decoded(data.size());
+        name = std::string("decode rle + repeat (") + suffix + ")";
+        measure(name.c_str(), [&]() {
+            OpenRCT2::MemoryStream ms(encoded.data(), encoded.size());
+            SawyerChunkReader reader(&ms);
+            reader.ReadChunk(decoded.data(), decoded.size());
+        });
+        ASSERT_EQ(decoded, data);
+    }
+    gUseVectorisedSawyerCoding = true;
+}
+
 // 1024 bytes of random data
 // use `dd if=/dev/urandom bs=1024 count=1 | xxd -i` to get your own
 const uint8_t SawyerCodingTest::randomdata[] = {